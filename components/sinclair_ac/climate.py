@@ -1,10 +1,32 @@
 #based on: https://github.com/DomiStyle/esphome-panasonic-ac
+from pathlib import Path
+import re
+
 from esphome.const import (
     CONF_ID,
+    CONF_TRIGGER_ID,
+    CONF_SENSOR,
+    CONF_TIME_ID,
+    CONF_TIMEOUT,
+    CONF_UART_ID,
+    CONF_HOUR,
+    CONF_MINUTE,
+    CONF_MODE,
+    CONF_TARGET_TEMPERATURE,
+    CONF_FAN_MODE,
+    CONF_SWING_MODE,
+    CONF_UPDATE_INTERVAL,
+    UNIT_HOUR,
+    UNIT_MINUTE,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
 )
+from esphome import automation
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import uart, climate, sensor, select, switch
+from esphome.components import uart, climate, sensor, select, switch, time
 
 AUTO_LOAD = ["switch", "sensor", "select"]
 DEPENDENCIES = ["uart"]
@@ -16,6 +38,9 @@ SinclairAC = sinclair_ac_ns.class_(
 sinclair_ac_cnt_ns = sinclair_ac_ns.namespace("CNT")
 SinclairACCNT = sinclair_ac_cnt_ns.class_("SinclairACCNT", SinclairAC)
 
+FrameView = sinclair_ac_ns.struct("FrameView")
+FrameTrigger = sinclair_ac_ns.class_("FrameTrigger", automation.Trigger.template(FrameView))
+
 SinclairACSwitch = sinclair_ac_ns.class_(
     "SinclairACSwitch", switch.Switch, cg.Component
 )
@@ -37,56 +62,238 @@ CONF_XFAN_SWITCH                = "xfan_switch"
 CONF_SAVE_SWITCH                = "save_switch"
 
 CONF_CURRENT_TEMPERATURE_SENSOR = "current_temperature_sensor"
+CONF_CURRENT_TEMPERATURE_SENSORS = "current_temperature_sensors"
+CONF_CURRENT_TEMPERATURE_OUTLIER = "current_temperature_outlier"
+CONF_CURRENT_TEMPERATURE_DEADBAND = "current_temperature_deadband"
+CONF_WEIGHT                     = "weight"
+MAX_CURRENT_TEMPERATURE_SENSORS = 4  # FUSION_MAX_SOURCES in esppac_fusion.h
 CONF_AC_INDOOR_TEMP_SENSOR      = "ac_indoor_temp_sensor"
+CONF_AC_INDOOR_TEMP_MIN_SENSOR  = "ac_indoor_temp_min_sensor"
+CONF_AC_INDOOR_TEMP_MAX_SENSOR  = "ac_indoor_temp_max_sensor"
+CONF_AC_INDOOR_TEMP_WINDOW      = "ac_indoor_temp_window"
+CONF_AC_INDOOR_TEMP_DEADBAND    = "ac_indoor_temp_deadband"
+CONF_FAST_BOOT                  = "fast_boot"
+CONF_RESPONSE_TIMEOUT           = "response_timeout"
+CONF_MAX_RETRIES                = "max_retries"
+CONF_TX_GUARD                   = "tx_guard"
+
+CONF_PUBLISH_GOVERNOR           = "publish_governor"
+CONF_MAX_UPDATES_PER_SECOND     = "max_updates_per_second"
+CONF_MIN_INTERVAL               = "min_interval"
 
-HORIZONTAL_SWING_OPTIONS = [
-    "0 - OFF",
-    "1 - Swing - Full",
-    "2 - Constant - Left",
-    "3 - Constant - Mid-Left",
-    "4 - Constant - Middle",
-    "5 - Constant - Mid-Right",
-    "6 - Constant - Right",
+# Same order as the PublishEntity enum in esppac_governor.h
+PUBLISH_ENTITIES = [
+    "climate",
+    "ac_indoor_temp",
+    "vertical_swing",
+    "horizontal_swing",
+    "display",
+    "display_unit",
+    "temp_source",
+    "plasma",
+    "beeper",
+    "sleep",
+    "xfan",
+    "save",
 ]
 
+CONF_SETPOINT_COMPENSATION      = "setpoint_compensation"
+CONF_KP                         = "kp"
+CONF_KI                         = "ki"
+CONF_MAX_OFFSET                 = "max_offset"
+CONF_INTERVAL                   = "interval"
+CONF_MIN_HOLD                   = "min_hold"
+CONF_OFFSET_SENSOR              = "offset_sensor"
 
-VERTICAL_SWING_OPTIONS = [
-    "00 - OFF",
-    "01 - Swing - Full",
-    "02 - Swing - Down",
-    "03 - Swing - Mid-Down",
-    "04 - Swing - Middle",
-    "05 - Swing - Mid-Up",
-    "06 - Swing - Up",
-    "07 - Constant - Down",
-    "08 - Constant - Mid-Down",
-    "09 - Constant - Middle",
-    "10 - Constant - Mid-Up",
-    "11 - Constant - Up",
-]
+CONF_SCHEDULE                   = "schedule"
+CONF_ENABLED                    = "enabled"
+CONF_ENTRIES                    = "entries"
+CONF_DAYS                       = "days"
+CONF_AT                         = "at"
 
-DISPLAY_OPTIONS = [
-    "0 - OFF",
-    "1 - Auto",
-    "2 - Set temperature",
-    "3 - Actual temperature",
-    "4 - Outside temperature",
-]
+# Bit 0 is Sunday, see ScheduleEntry in esppac_schedule.h
+SCHEDULE_DAYS = ["sun", "mon", "tue", "wed", "thu", "fri", "sat"]
+# Climate entity names, see SCHEDULE_MODE_NAMES and SCHEDULE_SWING_NAMES in esppac_schedule.cpp
+SCHEDULE_MODES = ["off", "heat_cool", "cool", "heat", "fan_only", "dry", "auto"]
+SCHEDULE_SWINGS = ["off", "both", "vertical", "horizontal"]
 
-DISPLAY_UNIT_OPTIONS = [
-    "C",
-    "F",
-]
+CONF_TELEMETRY_SENSORS          = "telemetry_sensors"
+CONF_FRAME                      = "frame"
+CONF_BYTE                       = "byte"
+CONF_MASK                       = "mask"
+CONF_MULTIPLY                   = "multiply"
+CONF_OFFSET                     = "offset"
 
-TEMP_SOURCE_OPTIONS = [
-    "AC Own Sensor",
-    "External ATC Sensor",
-    "ATC Fail",
-]
+# Telemetry commands and their payload length, see FRAME_KINDS in esppac_protocol.h
+TELEMETRY_FRAMES = {0x33: 45, 0x44: 24}
+
+CONF_ON_FRAME_RECEIVED          = "on_frame_received"
+CONF_ON_FRAME_SENT              = "on_frame_sent"
+CONF_FRAME_TRACE                = "frame_trace"
+
+CONF_SNIFFER                    = "sniffer"
+CONF_MODULE_UART_ID             = "module_uart_id"
+SNIFFER_FRAME_TRACE             = 64  # default frame_trace when sniffing or bridging
+CONF_BRIDGE                     = "bridge"
+
+CONF_RUNTIME_STATS              = "runtime_stats"
+CONF_POWER_ON_HOURS             = "power_on_hours"
+CONF_SETPOINT_CHANGES_PER_DAY   = "setpoint_changes_per_day"
+CONF_TIME_TO_SETPOINT           = "time_to_setpoint"
+CONF_MODE_HOURS                 = "mode_hours"
+CONF_FAN_HOURS                  = "fan_hours"
+
+# Raw report mode values (protocol::REPORT_MODE_*)
+STATS_MODES = {"auto": 0, "cool": 1, "dry": 2, "fan_only": 3, "heat": 4}
+
+# The option strings are defined once, in esppac_options.h, and read from there so the
+# select entities always offer exactly what the C++ side maps to protocol values.
+def _load_option_tables():
+    header = Path(__file__).parent / "esppac_options.h"
+    text = header.read_text(encoding="utf-8")
+    tables = {}
+    for name, body in re.findall(r"(\w+_OPTIONS|CUSTOM_FAN_MODES)\[\]\s*=\s*\{(.*?)\};", text, re.DOTALL):
+        tables[name] = re.findall(r'"([^"]*)"', body)
+    return tables
+
+
+_OPTION_TABLES = _load_option_tables()
+
+HORIZONTAL_SWING_OPTIONS = _OPTION_TABLES["HORIZONTAL_SWING_OPTIONS"]
+VERTICAL_SWING_OPTIONS = _OPTION_TABLES["VERTICAL_SWING_OPTIONS"]
+DISPLAY_OPTIONS = _OPTION_TABLES["DISPLAY_OPTIONS"]
+DISPLAY_UNIT_OPTIONS = _OPTION_TABLES["DISPLAY_UNIT_OPTIONS"]
+TEMP_SOURCE_OPTIONS = _OPTION_TABLES["TEMP_SOURCE_OPTIONS"]
+# FAN_AUTO -> auto, same order as FAN_MODE_OPTIONS
+STATS_FANS = [name[len("FAN_"):].lower() for name in _OPTION_TABLES["CUSTOM_FAN_MODES"]]
 
 SWITCH_SCHEMA = switch.switch_schema(SinclairACSwitch).extend(cv.COMPONENT_SCHEMA)
 SELECT_SCHEMA = select.select_schema(SinclairACSelect)
 
+HOURS_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_HOUR,
+    accuracy_decimals=1,
+    device_class=DEVICE_CLASS_DURATION,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+PUBLISH_GOVERNOR_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_MAX_UPDATES_PER_SECOND, default=0): cv.int_range(min=0, max=1000),
+        cv.Optional(CONF_MIN_INTERVAL, default={}): cv.Schema(
+            {cv.Optional(entity): cv.positive_time_period_milliseconds for entity in PUBLISH_ENTITIES}
+        ),
+    }
+)
+
+SETPOINT_COMPENSATION_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_KP, default=0.5): cv.float_range(min=0.0, max=10.0),
+        cv.Optional(CONF_KI, default=1.0): cv.float_range(min=0.0, max=10.0),  # per hour
+        cv.Optional(CONF_MAX_OFFSET, default=2): cv.int_range(min=1, max=5),
+        cv.Optional(CONF_INTERVAL, default="60s"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(seconds=10)),
+        ),
+        cv.Optional(CONF_MIN_HOLD, default="10min"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(minutes=1)),
+        ),
+        cv.Optional(CONF_OFFSET_SENSOR): sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+)
+
+def _validate_telemetry_field(config):
+    frame = config[CONF_FRAME]
+    if frame not in TELEMETRY_FRAMES:
+        raise cv.Invalid(f"frame must be one of {', '.join(f'0x{f:02X}' for f in TELEMETRY_FRAMES)}")
+    if config[CONF_BYTE] >= TELEMETRY_FRAMES[frame]:
+        raise cv.Invalid(f"frame 0x{frame:02X} has {TELEMETRY_FRAMES[frame]} payload bytes")
+    return config
+
+
+TELEMETRY_SENSOR_SCHEMA = cv.All(
+    sensor.sensor_schema(
+        accuracy_decimals=1,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    ).extend(
+        {
+            cv.Required(CONF_FRAME): cv.hex_uint8_t,
+            cv.Required(CONF_BYTE): cv.uint8_t,
+            cv.Optional(CONF_MASK, default=0xFF): cv.All(cv.hex_uint8_t, cv.Range(min=1)),
+            cv.Optional(CONF_MULTIPLY, default=1.0): cv.float_,
+            cv.Optional(CONF_OFFSET, default=0.0): cv.float_,
+        }
+    ),
+    _validate_telemetry_field,
+)
+
+SNIFFER_SCHEMA = cv.Schema(
+    {
+        # Taps the module's TX line, the component's own UART taps the unit's TX line
+        cv.Required(CONF_MODULE_UART_ID): cv.use_id(uart.UARTComponent),
+    }
+)
+
+BRIDGE_SCHEMA = cv.Schema(
+    {
+        # Wired to the module (RX from its TX, TX to its RX), the component's own UART goes to the unit
+        cv.Required(CONF_MODULE_UART_ID): cv.use_id(uart.UARTComponent),
+    }
+)
+
+SCHEDULE_ENTRY_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_DAYS, default=SCHEDULE_DAYS): cv.ensure_list(cv.one_of(*SCHEDULE_DAYS, lower=True)),
+        cv.Required(CONF_AT): cv.time_of_day,
+        cv.Optional(CONF_MODE): cv.one_of(*SCHEDULE_MODES, lower=True),
+        cv.Optional(CONF_TARGET_TEMPERATURE): cv.float_range(min=16.0, max=30.0),
+        cv.Optional(CONF_FAN_MODE): cv.one_of(*_OPTION_TABLES["CUSTOM_FAN_MODES"], upper=True),
+        cv.Optional(CONF_SWING_MODE): cv.one_of(*SCHEDULE_SWINGS, lower=True),
+    }
+)
+
+SCHEDULE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
+        cv.Optional(CONF_ENABLED, default=True): cv.boolean,
+        # Only used until the schedule is edited through a service, the edited one is kept in flash
+        cv.Optional(CONF_ENTRIES, default=[]): cv.All(
+            cv.ensure_list(SCHEDULE_ENTRY_SCHEMA), cv.Length(max=32)  # SCHEDULE_MAX_ENTRIES
+        ),
+    }
+)
+
+RUNTIME_STATS_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_UPDATE_INTERVAL, default="60s"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(seconds=10)),
+        ),
+        cv.Optional(CONF_POWER_ON_HOURS): HOURS_SCHEMA,
+        cv.Optional(CONF_SETPOINT_CHANGES_PER_DAY): sensor.sensor_schema(
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_TIME_TO_SETPOINT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MINUTE,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_MODE_HOURS): cv.Schema({cv.Optional(mode): HOURS_SCHEMA for mode in STATS_MODES}),
+        cv.Optional(CONF_FAN_HOURS): cv.Schema({cv.Optional(fan): HOURS_SCHEMA for fan in STATS_FANS}),
+    }
+)
+
 SCHEMA = climate.climate_schema(SinclairACCNT).extend(
     {
         cv.Optional(CONF_HORIZONTAL_SWING_SELECT): SELECT_SCHEMA,
@@ -100,17 +307,111 @@ SCHEMA = climate.climate_schema(SinclairACCNT).extend(
         cv.Optional(CONF_XFAN_SWITCH): SWITCH_SCHEMA,
         cv.Optional(CONF_SAVE_SWITCH): SWITCH_SCHEMA,
         cv.Optional(CONF_AC_INDOOR_TEMP_SENSOR): sensor.sensor_schema(),
+        cv.Optional(CONF_AC_INDOOR_TEMP_MIN_SENSOR): sensor.sensor_schema(),
+        cv.Optional(CONF_AC_INDOOR_TEMP_MAX_SENSOR): sensor.sensor_schema(),
+        cv.Optional(CONF_AC_INDOOR_TEMP_WINDOW, default="0s"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(max=cv.TimePeriod(hours=24)),
+        ),
+        cv.Optional(CONF_AC_INDOOR_TEMP_DEADBAND, default=0.0): cv.float_range(min=0.0, max=10.0),
+        cv.Optional(CONF_FAST_BOOT, default=False): cv.boolean,
+        cv.Optional(CONF_RESPONSE_TIMEOUT, default="500ms"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(milliseconds=150), max=cv.TimePeriod(milliseconds=5000)),
+        ),
+        cv.Optional(CONF_MAX_RETRIES, default=2): cv.int_range(min=0, max=10),
+        cv.Optional(CONF_TX_GUARD, default="40ms"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(max=cv.TimePeriod(milliseconds=500)),
+        ),
+        cv.Optional(CONF_RUNTIME_STATS): RUNTIME_STATS_SCHEMA,
+        cv.Optional(CONF_PUBLISH_GOVERNOR): PUBLISH_GOVERNOR_SCHEMA,
+        cv.Optional(CONF_SETPOINT_COMPENSATION): SETPOINT_COMPENSATION_SCHEMA,
+        cv.Optional(CONF_SCHEDULE): SCHEDULE_SCHEMA,
+        cv.Optional(CONF_TELEMETRY_SENSORS): cv.ensure_list(TELEMETRY_SENSOR_SCHEMA),
+        cv.Optional(CONF_ON_FRAME_RECEIVED): automation.validate_automation(
+            {cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(FrameTrigger)}
+        ),
+        cv.Optional(CONF_ON_FRAME_SENT): automation.validate_automation(
+            {cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(FrameTrigger)}
+        ),
+        cv.Optional(CONF_FRAME_TRACE): cv.int_range(min=0, max=512),  # about 60 bytes per frame
+        cv.Optional(CONF_SNIFFER): SNIFFER_SCHEMA,
+        cv.Optional(CONF_BRIDGE): BRIDGE_SCHEMA,
         # (debug TX/RX text sensors removed)
         
     }
 ).extend(uart.UART_DEVICE_SCHEMA)
 
+def _validate_setpoint_compensation(config):
+    if CONF_SETPOINT_COMPENSATION in config and not (
+        CONF_CURRENT_TEMPERATURE_SENSOR in config or CONF_CURRENT_TEMPERATURE_SENSORS in config
+    ):
+        raise cv.Invalid(f"{CONF_SETPOINT_COMPENSATION} needs an external temperature sensor")
+    return config
+
+
+def _validate_sniffer(config):
+    if CONF_SNIFFER not in config:
+        return config
+    if config[CONF_SNIFFER][CONF_MODULE_UART_ID] == config[CONF_UART_ID]:
+        raise cv.Invalid(f"{CONF_MODULE_UART_ID} must be a second UART, the first one taps the unit")
+    # Everything that sends on its own
+    for key in (CONF_SETPOINT_COMPENSATION, CONF_SCHEDULE):
+        if key in config:
+            raise cv.Invalid(f"{key} sends commands, it can not be used with {CONF_SNIFFER}")
+    if config[CONF_FAST_BOOT]:
+        raise cv.Invalid(f"{CONF_FAST_BOOT} resends the stored state, it can not be used with {CONF_SNIFFER}")
+    return config
+
+
+def _validate_bridge(config):
+    if CONF_BRIDGE not in config:
+        return config
+    if config[CONF_BRIDGE][CONF_MODULE_UART_ID] == config[CONF_UART_ID]:
+        raise cv.Invalid(f"{CONF_MODULE_UART_ID} must be a second UART, the first one goes to the unit")
+    if config[CONF_FAST_BOOT]:
+        raise cv.Invalid(f"{CONF_FAST_BOOT} resends the stored state, it can not be used with {CONF_BRIDGE}")
+    return config
+
+
+def _validate_indoor_temp_window(config):
+    window = config[CONF_AC_INDOOR_TEMP_WINDOW].total_milliseconds
+    for key in (CONF_AC_INDOOR_TEMP_MIN_SENSOR, CONF_AC_INDOOR_TEMP_MAX_SENSOR):
+        if key in config and window == 0:
+            raise cv.Invalid(f"{key} needs {CONF_AC_INDOOR_TEMP_WINDOW} to be set")
+    return config
+
+
+CURRENT_TEMPERATURE_SOURCE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_SENSOR): cv.use_id(sensor.Sensor),
+        cv.Optional(CONF_TIMEOUT, default="15min"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(seconds=10)),
+        ),
+        cv.Optional(CONF_WEIGHT, default=1.0): cv.float_range(min=0.01, max=100.0),
+    }
+)
+
 CONFIG_SCHEMA = cv.All(
     SCHEMA.extend(
         {
             cv.Optional(CONF_CURRENT_TEMPERATURE_SENSOR): cv.use_id(sensor.Sensor),
+            cv.Optional(CONF_CURRENT_TEMPERATURE_SENSORS): cv.All(
+                cv.ensure_list(CURRENT_TEMPERATURE_SOURCE_SCHEMA),
+                cv.Length(min=1, max=MAX_CURRENT_TEMPERATURE_SENSORS),
+            ),
+            cv.Optional(CONF_CURRENT_TEMPERATURE_OUTLIER, default=3.0): cv.float_range(min=0.1, max=50.0),
+            cv.Optional(CONF_CURRENT_TEMPERATURE_DEADBAND, default=0.1): cv.float_range(min=0.0, max=10.0),
         }
     ),
+    cv.has_at_most_one_key(CONF_CURRENT_TEMPERATURE_SENSOR, CONF_CURRENT_TEMPERATURE_SENSORS),
+    _validate_indoor_temp_window,
+    _validate_setpoint_compensation,
+    cv.has_at_most_one_key(CONF_SNIFFER, CONF_BRIDGE),
+    _validate_sniffer,
+    _validate_bridge,
 )
 
 
@@ -119,6 +420,27 @@ async def to_code(config):
     await climate.register_climate(var, config)
     await cg.register_component(var, config)
     await uart.register_uart_device(var, config)
+    cg.add(var.set_fast_boot(config[CONF_FAST_BOOT]))
+    cg.add(var.set_response_timeout(config[CONF_RESPONSE_TIMEOUT].total_milliseconds))
+    cg.add(var.set_max_retries(config[CONF_MAX_RETRIES]))
+    cg.add(var.set_tx_guard(config[CONF_TX_GUARD].total_milliseconds))
+
+    if CONF_SNIFFER in config:
+        module_uart = await cg.get_variable(config[CONF_SNIFFER][CONF_MODULE_UART_ID])
+        cg.add(var.set_sniffer_uart(module_uart))
+    if CONF_BRIDGE in config:
+        module_uart = await cg.get_variable(config[CONF_BRIDGE][CONF_MODULE_UART_ID])
+        cg.add(var.set_bridge_uart(module_uart))
+    module_mode = CONF_SNIFFER in config or CONF_BRIDGE in config
+    trace = config.get(CONF_FRAME_TRACE, SNIFFER_FRAME_TRACE if module_mode else 0)
+    if trace > 0:
+        cg.add(var.set_frame_trace_size(trace))
+
+    if CONF_PUBLISH_GOVERNOR in config:
+        conf = config[CONF_PUBLISH_GOVERNOR]
+        cg.add(var.set_publish_rate_limit(conf[CONF_MAX_UPDATES_PER_SECOND]))
+        for entity, interval in conf[CONF_MIN_INTERVAL].items():
+            cg.add(var.set_publish_min_interval(PUBLISH_ENTITIES.index(entity), interval.total_milliseconds))
     
     if CONF_HORIZONTAL_SWING_SELECT in config:
         conf = config[CONF_HORIZONTAL_SWING_SELECT]
@@ -153,13 +475,83 @@ async def to_code(config):
     if CONF_CURRENT_TEMPERATURE_SENSOR in config:
         sens = await cg.get_variable(config[CONF_CURRENT_TEMPERATURE_SENSOR])
         cg.add(var.set_current_temperature_sensor(sens))
+    for conf in config.get(CONF_CURRENT_TEMPERATURE_SENSORS, []):
+        sens = await cg.get_variable(conf[CONF_SENSOR])
+        cg.add(var.add_current_temperature_sensor(sens, conf[CONF_TIMEOUT].total_milliseconds, conf[CONF_WEIGHT]))
+    cg.add(var.set_current_temperature_outlier(config[CONF_CURRENT_TEMPERATURE_OUTLIER]))
+    cg.add(var.set_current_temperature_deadband(config[CONF_CURRENT_TEMPERATURE_DEADBAND]))
+
+    for conf in config.get(CONF_TELEMETRY_SENSORS, []):
+        sens = await sensor.new_sensor(conf)
+        cg.add(
+            var.add_telemetry_sensor(
+                sens, conf[CONF_FRAME], conf[CONF_BYTE], conf[CONF_MASK], conf[CONF_MULTIPLY], conf[CONF_OFFSET]
+            )
+        )
+
+    if CONF_SCHEDULE in config:
+        conf = config[CONF_SCHEDULE]
+        clock = await cg.get_variable(conf[CONF_TIME_ID])
+        cg.add(var.set_time(clock))
+        for entry in conf[CONF_ENTRIES]:
+            days = sum(1 << SCHEDULE_DAYS.index(day) for day in set(entry[CONF_DAYS]))
+            cg.add(
+                var.schedule_add(
+                    days,
+                    entry[CONF_AT][CONF_HOUR],
+                    entry[CONF_AT][CONF_MINUTE],
+                    entry.get(CONF_MODE, ""),
+                    entry.get(CONF_TARGET_TEMPERATURE, cg.RawExpression("NAN")),
+                    entry.get(CONF_FAN_MODE, ""),
+                    entry.get(CONF_SWING_MODE, ""),
+                )
+            )
+        cg.add(var.schedule_enable(conf[CONF_ENABLED]))
+
+    if CONF_SETPOINT_COMPENSATION in config:
+        conf = config[CONF_SETPOINT_COMPENSATION]
+        cg.add(var.set_setpoint_compensation(True))
+        cg.add(var.set_compensation_gains(conf[CONF_KP], conf[CONF_KI]))
+        cg.add(var.set_compensation_max_offset(conf[CONF_MAX_OFFSET]))
+        cg.add(var.set_compensation_interval(conf[CONF_INTERVAL].total_milliseconds))
+        cg.add(var.set_compensation_min_hold(conf[CONF_MIN_HOLD].total_milliseconds))
+        if CONF_OFFSET_SENSOR in conf:
+            sens = await sensor.new_sensor(conf[CONF_OFFSET_SENSOR])
+            cg.add(var.set_compensation_offset_sensor(sens))
 
 
     if CONF_AC_INDOOR_TEMP_SENSOR in config:
         conf = config[CONF_AC_INDOOR_TEMP_SENSOR]
         sens = await sensor.new_sensor(conf)
         cg.add(var.set_ac_indoor_temp_sensor(sens))
+    if CONF_AC_INDOOR_TEMP_MIN_SENSOR in config:
+        sens = await sensor.new_sensor(config[CONF_AC_INDOOR_TEMP_MIN_SENSOR])
+        cg.add(var.set_ac_indoor_temp_min_sensor(sens))
+    if CONF_AC_INDOOR_TEMP_MAX_SENSOR in config:
+        sens = await sensor.new_sensor(config[CONF_AC_INDOOR_TEMP_MAX_SENSOR])
+        cg.add(var.set_ac_indoor_temp_max_sensor(sens))
+    cg.add(var.set_ac_indoor_temp_window(config[CONF_AC_INDOOR_TEMP_WINDOW].total_milliseconds))
+    cg.add(var.set_ac_indoor_temp_deadband(config[CONF_AC_INDOOR_TEMP_DEADBAND]))
     # debug sensors removed
+
+    if CONF_RUNTIME_STATS in config:
+        conf = config[CONF_RUNTIME_STATS]
+        cg.add(var.set_stats_update_interval(conf[CONF_UPDATE_INTERVAL].total_milliseconds))
+        if CONF_POWER_ON_HOURS in conf:
+            sens = await sensor.new_sensor(conf[CONF_POWER_ON_HOURS])
+            cg.add(var.set_power_on_hours_sensor(sens))
+        if CONF_SETPOINT_CHANGES_PER_DAY in conf:
+            sens = await sensor.new_sensor(conf[CONF_SETPOINT_CHANGES_PER_DAY])
+            cg.add(var.set_setpoint_changes_sensor(sens))
+        if CONF_TIME_TO_SETPOINT in conf:
+            sens = await sensor.new_sensor(conf[CONF_TIME_TO_SETPOINT])
+            cg.add(var.set_time_to_setpoint_sensor(sens))
+        for mode, sens_conf in conf.get(CONF_MODE_HOURS, {}).items():
+            sens = await sensor.new_sensor(sens_conf)
+            cg.add(var.set_mode_hours_sensor(STATS_MODES[mode], sens))
+        for fan, sens_conf in conf.get(CONF_FAN_HOURS, {}).items():
+            sens = await sensor.new_sensor(sens_conf)
+            cg.add(var.set_fan_hours_sensor(STATS_FANS.index(fan), sens))
         
     for s in [CONF_PLASMA_SWITCH, CONF_BEEPER_SWITCH, CONF_SLEEP_SWITCH, CONF_XFAN_SWITCH, CONF_SAVE_SWITCH]:
         if s in config:
@@ -168,3 +560,15 @@ async def to_code(config):
             await cg.register_component(a_switch, conf)
             await switch.register_switch(a_switch, conf)
             cg.add(getattr(var, f"set_{s}")(a_switch))
+
+    # The hooks are compiled out unless an automation uses them
+    if CONF_ON_FRAME_RECEIVED in config or CONF_ON_FRAME_SENT in config:
+        cg.add_define("USE_SINCLAIR_AC_FRAME_HOOKS")
+    for conf in config.get(CONF_ON_FRAME_RECEIVED, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID])
+        cg.add(var.add_on_frame_received_trigger(trigger))
+        await automation.build_automation(trigger, [(FrameView, "frame")], conf)
+    for conf in config.get(CONF_ON_FRAME_SENT, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID])
+        cg.add(var.add_on_frame_sent_trigger(trigger))
+        await automation.build_automation(trigger, [(FrameView, "frame")], conf)
@@ -3,136 +3,93 @@
 
 #include "esphome/core/log.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 namespace esphome {
 namespace sinclair_ac {
 
 static const char *const TAG = "sinclair_ac";
 
-// Helper arrays for mapping (must match climate.py order)
-static const std::string DISPLAY_OPTIONS[] = {
-    display_options::OFF,   // 0
-    display_options::AUTO,  // 1
-    display_options::SET,   // 2
-    display_options::ACT,   // 3
-    display_options::OUT    // 4
-};
-static const uint8_t DISPLAY_OPTIONS_COUNT = 5;
-
-static const char* const CUSTOM_FAN_MODES[] = {
-    "FAN_AUTO",
-    "FAN_QUIET",
-    "FAN_LOW",
-    "FAN_MEDL",
-    "FAN_MED",
-    "FAN_MEDH",
-    "FAN_HIGH",
-    "FAN_TURBO"
-};
-
-static const std::string DISPLAY_UNIT_OPTIONS[] = {
-    display_unit_options::DEGC,  // 0
-    display_unit_options::DEGF   // 1
-};
-static const uint8_t DISPLAY_UNIT_OPTIONS_COUNT = 2;
-
-static const std::string VERTICAL_SWING_OPTIONS[] = {
-    vertical_swing_options::OFF,    // 0
-    vertical_swing_options::FULL,   // 1
-    vertical_swing_options::DOWN,   // 2
-    vertical_swing_options::MIDD,   // 3
-    vertical_swing_options::MID,    // 4
-    vertical_swing_options::MIDU,   // 5
-    vertical_swing_options::UP,     // 6
-    vertical_swing_options::CDOWN,  // 7
-    vertical_swing_options::CMIDD,  // 8
-    vertical_swing_options::CMID,   // 9
-    vertical_swing_options::CMIDU,  // 10
-    vertical_swing_options::CUP     // 11
-};
-static const uint8_t VERTICAL_SWING_OPTIONS_COUNT = 12;
-
-static const std::string HORIZONTAL_SWING_OPTIONS[] = {
-    horizontal_swing_options::OFF,     // 0
-    horizontal_swing_options::FULL,    // 1
-    horizontal_swing_options::CLEFT,   // 2
-    horizontal_swing_options::CMIDL,   // 3
-    horizontal_swing_options::CMID,    // 4
-    horizontal_swing_options::CMIDR,   // 5
-    horizontal_swing_options::CRIGHT   // 6
-};
-static const uint8_t HORIZONTAL_SWING_OPTIONS_COUNT = 7;
-
-static const std::string TEMP_SOURCE_OPTIONS[] = {
-    temp_source_options::AC_OWN,         // 0
-    temp_source_options::EXTERNAL_ATC,   // 1
-    temp_source_options::ATC_FAIL        // 2
-};
-static const uint8_t TEMP_SOURCE_OPTIONS_COUNT = 3;
-
 // Mapping helper functions implementation
-uint8_t SinclairAC::display_index_from_string_(const std::string &s) {
+uint8_t SinclairAC::display_index_from_string_(const char *s) {
+    SINCLAIR_PROFILE_SCOPE(PROF_INDEX_MAPPER);
     for (uint8_t i = 0; i < DISPLAY_OPTIONS_COUNT; i++) {
-        if (DISPLAY_OPTIONS[i] == s) return i;
+        if (strcmp(s, DISPLAY_OPTIONS[i]) == 0) return i;
     }
     return 1; // Default to AUTO
 }
 
-std::string SinclairAC::display_string_from_index_(uint8_t i) {
+const char *SinclairAC::display_string_from_index_(uint8_t i) {
+    SINCLAIR_PROFILE_SCOPE(PROF_INDEX_MAPPER);
     if (i >= DISPLAY_OPTIONS_COUNT) return DISPLAY_OPTIONS[1]; // Default to AUTO
     return DISPLAY_OPTIONS[i];
 }
 
-uint8_t SinclairAC::display_unit_index_from_string_(const std::string &s) {
+uint8_t SinclairAC::display_unit_index_from_string_(const char *s) {
+    SINCLAIR_PROFILE_SCOPE(PROF_INDEX_MAPPER);
     for (uint8_t i = 0; i < DISPLAY_UNIT_OPTIONS_COUNT; i++) {
-        if (DISPLAY_UNIT_OPTIONS[i] == s) return i;
+        if (strcmp(s, DISPLAY_UNIT_OPTIONS[i]) == 0) return i;
     }
     return 0; // Default to C
 }
 
-std::string SinclairAC::display_unit_string_from_index_(uint8_t i) {
+const char *SinclairAC::display_unit_string_from_index_(uint8_t i) {
+    SINCLAIR_PROFILE_SCOPE(PROF_INDEX_MAPPER);
     if (i >= DISPLAY_UNIT_OPTIONS_COUNT) return DISPLAY_UNIT_OPTIONS[0]; // Default to C
     return DISPLAY_UNIT_OPTIONS[i];
 }
 
-uint8_t SinclairAC::vertical_swing_index_from_string_(const std::string &s) {
+uint8_t SinclairAC::vertical_swing_index_from_string_(const char *s) {
+    SINCLAIR_PROFILE_SCOPE(PROF_INDEX_MAPPER);
     for (uint8_t i = 0; i < VERTICAL_SWING_OPTIONS_COUNT; i++) {
-        if (VERTICAL_SWING_OPTIONS[i] == s) return i;
+        if (strcmp(s, VERTICAL_SWING_OPTIONS[i]) == 0) return i;
     }
     return 9; // Default to CMID
 }
 
-std::string SinclairAC::vertical_swing_string_from_index_(uint8_t i) {
+const char *SinclairAC::vertical_swing_string_from_index_(uint8_t i) {
+    SINCLAIR_PROFILE_SCOPE(PROF_INDEX_MAPPER);
     if (i >= VERTICAL_SWING_OPTIONS_COUNT) return VERTICAL_SWING_OPTIONS[9]; // Default to CMID
     return VERTICAL_SWING_OPTIONS[i];
 }
 
-uint8_t SinclairAC::horizontal_swing_index_from_string_(const std::string &s) {
+uint8_t SinclairAC::horizontal_swing_index_from_string_(const char *s) {
+    SINCLAIR_PROFILE_SCOPE(PROF_INDEX_MAPPER);
     for (uint8_t i = 0; i < HORIZONTAL_SWING_OPTIONS_COUNT; i++) {
-        if (HORIZONTAL_SWING_OPTIONS[i] == s) return i;
+        if (strcmp(s, HORIZONTAL_SWING_OPTIONS[i]) == 0) return i;
     }
     return 4; // Default to CMID
 }
 
-std::string SinclairAC::horizontal_swing_string_from_index_(uint8_t i) {
+const char *SinclairAC::horizontal_swing_string_from_index_(uint8_t i) {
+    SINCLAIR_PROFILE_SCOPE(PROF_INDEX_MAPPER);
     if (i >= HORIZONTAL_SWING_OPTIONS_COUNT) return HORIZONTAL_SWING_OPTIONS[4]; // Default to CMID
     return HORIZONTAL_SWING_OPTIONS[i];
 }
 
-uint8_t SinclairAC::temp_source_index_from_string_(const std::string &s) {
+uint8_t SinclairAC::temp_source_index_from_string_(const char *s) {
+    SINCLAIR_PROFILE_SCOPE(PROF_INDEX_MAPPER);
     for (uint8_t i = 0; i < TEMP_SOURCE_OPTIONS_COUNT; i++) {
-        if (TEMP_SOURCE_OPTIONS[i] == s) return i;
+        if (strcmp(s, TEMP_SOURCE_OPTIONS[i]) == 0) return i;
     }
     return 0; // Default to AC_OWN
 }
 
-std::string SinclairAC::temp_source_string_from_index_(uint8_t i) {
+const char *SinclairAC::temp_source_string_from_index_(uint8_t i) {
+    SINCLAIR_PROFILE_SCOPE(PROF_INDEX_MAPPER);
     if (i >= TEMP_SOURCE_OPTIONS_COUNT) return TEMP_SOURCE_OPTIONS[0]; // Default to AC_OWN
     return TEMP_SOURCE_OPTIONS[i];
 }
 
 climate::ClimateTraits SinclairAC::traits()
 {
-    auto traits = climate::ClimateTraits();
+    // Built once, the option tables are constant
+    if (this->traits_built_)
+        return this->traits_;
+
+    auto &traits = this->traits_;
 
     traits.set_supports_action(false);
 
@@ -151,6 +108,7 @@ climate::ClimateTraits SinclairAC::traits()
     traits.set_supported_swing_modes({climate::CLIMATE_SWING_OFF, climate::CLIMATE_SWING_BOTH,
                                       climate::CLIMATE_SWING_VERTICAL, climate::CLIMATE_SWING_HORIZONTAL});
 
+    this->traits_built_ = true;
     return traits;
 }
 
@@ -161,6 +119,11 @@ void SinclairAC::setup()
     this->last_packet_sent_ = millis();
     this->last_external_update_ = 0;
 
+    // The receive buffer never grows beyond DATA_MAX, reserve it once so framing does not allocate
+    this->serialProcess_.data.reserve(DATA_MAX);
+    if (this->frame_trace_size_ > 0)
+        this->frame_trace_.set_capacity(this->frame_trace_size_);
+
     // Initialize temperature source to AC own sensor by default
     this->temp_source_state_ = temp_source_options::AC_OWN;
 
@@ -177,19 +140,55 @@ void SinclairAC::setup()
     this->pref_sleep_ = global_preferences->make_preference<bool>(PREF_KEY_SLEEP);
     this->pref_xfan_ = global_preferences->make_preference<bool>(PREF_KEY_XFAN);
     this->pref_save_ = global_preferences->make_preference<bool>(PREF_KEY_SAVE);
-
-    // Load persisted preferences
-    load_preferences_();
+    if (this->fast_boot_)
+        this->pref_fast_boot_ = global_preferences->make_preference<FastBootState>(PREF_KEY_FAST_BOOT);
+
+    // A software reset keeps the warm state in RTC memory, restore from it without reading flash
+    if (restore_warm_state_())
+        apply_saved_preferences_();
+    else
+        load_preferences_();
+
+    // A saved schedule replaces the one from the YAML
+    this->pref_schedule_ = global_preferences->make_preference<ScheduleTable>(PREF_KEY_SCHEDULE);
+    ScheduleTable table;
+    if (this->pref_schedule_.load(&table) && this->schedule_.restore(table))
+        ESP_LOGD(TAG, "Schedule loaded, %u entries", this->schedule_.size());
+    this->schedule_loaded_ = true;
 }
 
 void SinclairAC::loop()
 {
     read_data();  // Read data from UART (if there is any)
     check_external_timeout();  // Check if external sensor has timed out
+    update_schedule_();
+
+    /* publishes the governor held back go out as soon as they are allowed, with the current state */
+    if (this->governor_.has_pending())
+    {
+        PublishEntity entity;
+        while ((entity = this->governor_.next_due(millis())) != PUB_ENTITY_COUNT)
+            publish_entity_(entity);
+    }
+
+    if (this->fast_boot_dirty_)
+        save_fast_boot_state_();  // One write for everything that changed during this loop
+    if (this->warm_dirty_)
+        save_warm_state_();
+
+#ifdef SINCLAIR_AC_PROFILE
+    if (millis() - this->last_profile_dump_ >= PROFILE_DUMP_INTERVAL_MS)
+    {
+        this->last_profile_dump_ = millis();
+        profile::dump();
+    }
+#endif
 }
 
 void SinclairAC::read_data()
 {
+    SINCLAIR_PROFILE_SCOPE(PROF_READ_DATA);
+
     while (available())  // Read while data is available
     {
         /* If we had a packet or a packet had not been decoded yet - do not recieve more data */
@@ -199,67 +198,88 @@ void SinclairAC::read_data()
         }
         uint8_t c;
         this->read_byte(&c);  // Store in receive buffer
+        this->last_rx_byte_ = millis();
+        if (this->rx_mirror_ != nullptr)
+            this->rx_mirror_->write_byte(c);  // Cut-through, the frame is still decoded below
+        SINCLAIR_PROFILE_BYTES(PROF_READ_DATA, 1);
 
         // <<< ДОБАВИТЬ: сырое логирование каждого байта >>>
         ESP_LOGVV("sinclair_uart_raw", "RX byte: 0x%02X (state=%d, size=%u)",
                   c, this->serialProcess_.state,
                   (unsigned)this->serialProcess_.data.size());
         // <<< КОНЕЦ ВСТАВКИ >>>
-        
-        if (this->serialProcess_.state == STATE_RESTART)
-        {
-            this->serialProcess_.data.clear();
-            this->serialProcess_.state = STATE_WAIT_SYNC;
-        }
-        
-        this->serialProcess_.data.push_back(c);
-        if (this->serialProcess_.data.size() >= DATA_MAX)
-        {
-            this->serialProcess_.data.clear();
-            continue;
-        }
-        switch (this->serialProcess_.state)
-        {
-            case STATE_WAIT_SYNC:
-                /* Frame begins with 0x7E 0x7E LEN CMD
-                   LEN - frame length in bytes
-                   CMD - command
-                 */
-                if (c != 0x7E && 
-                    this->serialProcess_.data.size() > 2 && 
-                    this->serialProcess_.data[this->serialProcess_.data.size()-2] == 0x7E && 
-                    this->serialProcess_.data[this->serialProcess_.data.size()-3] == 0x7E)
-                {
-                    this->serialProcess_.data.clear();
-
-                    this->serialProcess_.data.push_back(0x7E);
-                    this->serialProcess_.data.push_back(0x7E);
-                    this->serialProcess_.data.push_back(c);
-
-                    this->serialProcess_.frame_size = c;
-                    this->serialProcess_.state = STATE_RECIEVE;
-                }
-                break;
-            case STATE_RECIEVE:
-                this->serialProcess_.frame_size--;
-                if (this->serialProcess_.frame_size == 0)
-                {
-                    /* WE HAVE A FRAME FROM AC */
-                    this->serialProcess_.state = STATE_COMPLETE;
-                }
-                break;
-            case STATE_RESTART:
-            case STATE_COMPLETE:
-                break;
-            default:
-                this->serialProcess_.state = STATE_WAIT_SYNC;
-                this->serialProcess_.data.clear();
-                break;
-        }
 
+        frame_byte_(this->serialProcess_, c);
+    }
+
+    /* A frame that stopped mid-way (lost bytes or a damaged LEN) would keep the line busy for
+       good, as TX waits for it to finish. Drop it once the line has been quiet for READ_TIMEOUT. */
+    if (this->serialProcess_.state == STATE_RECIEVE && millis() - this->last_rx_byte_ >= READ_TIMEOUT)
+    {
+        ESP_LOGD(TAG, "Dropping truncated frame (%u of %u bytes)", (unsigned) this->serialProcess_.data.size(),
+                 (unsigned) this->serialProcess_.data.size() + this->serialProcess_.frame_size);
+        this->serialProcess_.data.clear();
+        this->serialProcess_.state = STATE_WAIT_SYNC;
+        this->link_.truncated++;
+        note_link_damage_();
     }
 }
 
+bool SinclairAC::frame_byte_(SerialProcess_t &process, uint8_t c)
+{
+    if (process.state == STATE_RESTART)
+    {
+        process.data.clear();
+        process.state = STATE_WAIT_SYNC;
+    }
+
+    process.data.push_back(c);
+    if (process.data.size() >= DATA_MAX)
+    {
+        process.data.clear();
+        return false;
+    }
+    switch (process.state)
+    {
+        case STATE_WAIT_SYNC:
+            /* Frame begins with 0x7E 0x7E LEN CMD
+               LEN - frame length in bytes
+               CMD - command
+             */
+            if (c != 0x7E &&
+                process.data.size() > 2 &&
+                process.data[process.data.size()-2] == 0x7E &&
+                process.data[process.data.size()-3] == 0x7E)
+            {
+                process.data.clear();
+
+                process.data.push_back(0x7E);
+                process.data.push_back(0x7E);
+                process.data.push_back(c);
+
+                process.frame_size = c;
+                process.state = STATE_RECIEVE;
+            }
+            break;
+        case STATE_RECIEVE:
+            process.frame_size--;
+            if (process.frame_size == 0)
+            {
+                /* WE HAVE A FRAME FROM AC */
+                process.state = STATE_COMPLETE;
+            }
+            break;
+        case STATE_RESTART:
+        case STATE_COMPLETE:
+            break;
+        default:
+            process.state = STATE_WAIT_SYNC;
+            process.data.clear();
+            break;
+    }
+    return process.state == STATE_COMPLETE;
+}
+
 void SinclairAC::update_current_temperature(float temperature)
 {
     if (temperature > TEMPERATURE_THRESHOLD) {
@@ -280,149 +300,194 @@ void SinclairAC::update_target_temperature(float temperature)
     this->target_temperature = temperature;
 }
 
-void SinclairAC::update_swing_horizontal(const std::string &swing)
+void SinclairAC::update_swing_horizontal(const char *swing)
 {
     this->horizontal_swing_state_ = swing;
 
     if (this->horizontal_swing_select_ != nullptr &&
-        this->horizontal_swing_select_->state != this->horizontal_swing_state_)
+        this->publish_allowed_(PUB_HORIZONTAL_SWING, this->horizontal_swing_select_->state != this->horizontal_swing_state_))
     {
         this->horizontal_swing_select_->publish_state(this->horizontal_swing_state_);
     }
     
     // Save preference as uint8_t index
     uint8_t index = horizontal_swing_index_from_string_(swing);
-    this->pref_horizontal_swing_.save(&index);
-    ESP_LOGD(TAG, "Saved horizontal swing preference: %s (index %d)", swing.c_str(), index);
+    if (this->save_preference_(this->pref_horizontal_swing_, this->saved_horizontal_swing_idx_, index))
+    {
+        ESP_LOGD(TAG, "Saved horizontal swing preference: %s (index %d)", swing, index);
+    }
 }
 
-void SinclairAC::update_swing_vertical(const std::string &swing)
+void SinclairAC::update_swing_vertical(const char *swing)
 {
     this->vertical_swing_state_ = swing;
 
-    if (this->vertical_swing_select_ != nullptr && 
-        this->vertical_swing_select_->state != this->vertical_swing_state_)
+    if (this->vertical_swing_select_ != nullptr &&
+        this->publish_allowed_(PUB_VERTICAL_SWING, this->vertical_swing_select_->state != this->vertical_swing_state_))
     {
         this->vertical_swing_select_->publish_state(this->vertical_swing_state_);
     }
     
     // Save preference as uint8_t index
     uint8_t index = vertical_swing_index_from_string_(swing);
-    this->pref_vertical_swing_.save(&index);
-    ESP_LOGD(TAG, "Saved vertical swing preference: %s (index %d)", swing.c_str(), index);
+    if (this->save_preference_(this->pref_vertical_swing_, this->saved_vertical_swing_idx_, index))
+    {
+        ESP_LOGD(TAG, "Saved vertical swing preference: %s (index %d)", swing, index);
+    }
 }
 
-void SinclairAC::update_display(const std::string &display)
+void SinclairAC::update_display(const char *display)
 {
     this->display_state_ = display;
 
-    if (this->display_select_ != nullptr && 
-        this->display_select_->state != this->display_state_)
+    if (this->display_select_ != nullptr &&
+        this->publish_allowed_(PUB_DISPLAY, this->display_select_->state != this->display_state_))
     {
         this->display_select_->publish_state(this->display_state_);
     }
     
     // Save preference as uint8_t index
     uint8_t index = display_index_from_string_(display);
-    this->pref_display_.save(&index);
-    ESP_LOGD(TAG, "Saved display preference: %s (index %d)", display.c_str(), index);
+    if (this->save_preference_(this->pref_display_, this->saved_display_idx_, index))
+    {
+        ESP_LOGD(TAG, "Saved display preference: %s (index %d)", display, index);
+    }
 }
 
-void SinclairAC::update_display_unit(const std::string &display_unit)
+void SinclairAC::update_display_unit(const char *display_unit)
 {
     this->display_unit_state_ = display_unit;
 
-    if (this->display_unit_select_ != nullptr && 
-        this->display_unit_select_->state != this->display_unit_state_)
+    if (this->display_unit_select_ != nullptr &&
+        this->publish_allowed_(PUB_DISPLAY_UNIT, this->display_unit_select_->state != this->display_unit_state_))
     {
         this->display_unit_select_->publish_state(this->display_unit_state_);
     }
     
     // Save preference as uint8_t index
     uint8_t index = display_unit_index_from_string_(display_unit);
-    this->pref_display_unit_.save(&index);
-    ESP_LOGD(TAG, "Saved display unit preference: %s (index %d)", display_unit.c_str(), index);
+    if (this->save_preference_(this->pref_display_unit_, this->saved_display_unit_idx_, index))
+    {
+        ESP_LOGD(TAG, "Saved display unit preference: %s (index %d)", display_unit, index);
+    }
 }
 
-void SinclairAC::update_temp_source(const std::string &temp_source)
+void SinclairAC::update_temp_source(const char *temp_source)
 {
     this->temp_source_state_ = temp_source;
 
-    if (this->temp_source_select_ != nullptr && 
-        this->temp_source_select_->state != this->temp_source_state_)
+    if (this->temp_source_select_ != nullptr &&
+        this->publish_allowed_(PUB_TEMP_SOURCE, this->temp_source_select_->state != this->temp_source_state_))
     {
         this->temp_source_select_->publish_state(this->temp_source_state_);
     }
     
     // Save preference as uint8_t index
     uint8_t index = temp_source_index_from_string_(temp_source);
-    this->pref_temp_source_.save(&index);
-    ESP_LOGD(TAG, "Saved temp source preference: %s (index %d)", temp_source.c_str(), index);
+    if (this->save_preference_(this->pref_temp_source_, this->saved_temp_source_idx_, index))
+    {
+        ESP_LOGD(TAG, "Saved temp source preference: %s (index %d)", temp_source, index);
+    }
 }
 
 void SinclairAC::update_plasma(bool plasma)
 {
     this->plasma_state_ = plasma;
 
-    if (this->plasma_switch_ != nullptr)
+    if (this->plasma_switch_ != nullptr &&
+        this->publish_allowed_(PUB_PLASMA, this->plasma_switch_->state != this->plasma_state_))
     {
         this->plasma_switch_->publish_state(this->plasma_state_);
     }
     
     // Save preference
-    this->pref_plasma_.save(&this->plasma_state_);
+    this->save_preference_(this->pref_plasma_, this->saved_plasma_, this->plasma_state_);
 }
 
 void SinclairAC::update_beeper(bool beeper)
 {
     this->beeper_state_ = beeper;
 
-    if (this->beeper_switch_ != nullptr)
+    if (this->beeper_switch_ != nullptr &&
+        this->publish_allowed_(PUB_BEEPER, this->beeper_switch_->state != this->beeper_state_))
     {
         this->beeper_switch_->publish_state(this->beeper_state_);
     }
     
     // Save preference
-    this->pref_beeper_.save(&this->beeper_state_);
+    this->save_preference_(this->pref_beeper_, this->saved_beeper_, this->beeper_state_);
 }
 
 void SinclairAC::update_sleep(bool sleep)
 {
     this->sleep_state_ = sleep;
 
-    if (this->sleep_switch_ != nullptr)
+    if (this->sleep_switch_ != nullptr &&
+        this->publish_allowed_(PUB_SLEEP, this->sleep_switch_->state != this->sleep_state_))
     {
         this->sleep_switch_->publish_state(this->sleep_state_);
     }
     
     // Save preference
-    this->pref_sleep_.save(&this->sleep_state_);
+    this->save_preference_(this->pref_sleep_, this->saved_sleep_, this->sleep_state_);
 }
 
 void SinclairAC::update_xfan(bool xfan)
 {
     this->xfan_state_ = xfan;
 
-    if (this->xfan_switch_ != nullptr)
+    if (this->xfan_switch_ != nullptr &&
+        this->publish_allowed_(PUB_XFAN, this->xfan_switch_->state != this->xfan_state_))
     {
         this->xfan_switch_->publish_state(this->xfan_state_);
     }
     
     // Save preference
-    this->pref_xfan_.save(&this->xfan_state_);
+    this->save_preference_(this->pref_xfan_, this->saved_xfan_, this->xfan_state_);
 }
 
 void SinclairAC::update_save(bool save)
 {
     this->save_state_ = save;
 
-    if (this->save_switch_ != nullptr)
+    if (this->save_switch_ != nullptr &&
+        this->publish_allowed_(PUB_SAVE, this->save_switch_->state != this->save_state_))
     {
         this->save_switch_->publish_state(this->save_state_);
     }
     
     // Save preference
-    this->pref_save_.save(&this->save_state_);
+    this->save_preference_(this->pref_save_, this->saved_save_, this->save_state_);
+}
+
+bool SinclairAC::save_preference_(ESPPreferenceObject &pref, uint8_t &saved, uint8_t value)
+{
+    if (saved == value)
+        return false;
+
+    SINCLAIR_PROFILE_SCOPE(PROF_PREF_SAVE);
+    saved = value;
+    this->warm_dirty_ = true;
+    if (this->fast_boot_)
+        this->fast_boot_dirty_ = true;  /* Written as part of the blob on the next loop */
+    else
+        pref.save(&value);
+    return true;
+}
+
+bool SinclairAC::save_preference_(ESPPreferenceObject &pref, uint8_t &saved, bool value)
+{
+    if (saved == (uint8_t) value)
+        return false;
+
+    SINCLAIR_PROFILE_SCOPE(PROF_PREF_SAVE);
+    saved = value;
+    this->warm_dirty_ = true;
+    if (this->fast_boot_)
+        this->fast_boot_dirty_ = true;  /* Written as part of the blob on the next loop */
+    else
+        pref.save(&value);
+    return true;
 }
 
 climate::ClimateAction SinclairAC::determine_action()
@@ -450,29 +515,53 @@ climate::ClimateAction SinclairAC::determine_action()
 
 void SinclairAC::set_current_temperature_sensor(sensor::Sensor *current_temperature_sensor)
 {
-    this->current_temperature_sensor_ = current_temperature_sensor;
-    this->current_temperature_sensor_->add_on_state_callback([this](float state)
+    add_current_temperature_sensor(current_temperature_sensor, ATC_SENSOR_TIMEOUT_MS, 1.0f);
+}
+
+void SinclairAC::add_current_temperature_sensor(sensor::Sensor *sens, uint32_t timeout_ms, float weight)
+{
+    uint8_t index = this->external_fusion_.add_source(timeout_ms, weight);
+    if (index == FUSION_MAX_SOURCES)
+    {
+        ESP_LOGW(TAG, "Only %u external temperature sensors are supported, ignoring the rest", FUSION_MAX_SOURCES);
+        return;
+    }
+
+    sens->add_on_state_callback([this, index](float state)
         {
-            // Always record the external update
-            this->last_external_update_ = millis();
-            this->last_external_temperature_ = state;
-            
-            // If currently in Fail mode and external data arrives, recover to External mode
-            if (this->atc_failed_) {
-                this->atc_failed_ = false;
-                this->temp_source_state_ = temp_source_options::EXTERNAL_ATC;
-                this->update_temp_source(this->temp_source_state_);
-                ESP_LOGD(TAG, "External sensor recovered, switching from ATC Fail to External ATC Sensor");
-            }
-            
-            // Update climate current temperature if using External ATC and not failed
-            if (this->temp_source_state_ == temp_source_options::EXTERNAL_ATC && !this->atc_failed_) {
-                this->current_temperature = state;
-                this->publish_state();
-            }
+            uint32_t now = millis();
+            this->external_fusion_.update(index, state, now);
+            this->update_external_temperature_(now);
         });
 }
 
+void SinclairAC::update_external_temperature_(uint32_t now)
+{
+    float fused = this->external_fusion_.fuse(now);
+    if (std::isnan(fused))
+        return;
+
+    // Always record the external update
+    this->last_external_update_ = now;
+    this->last_external_temperature_ = fused;
+
+    // If currently in Fail mode and external data arrives, recover to External mode
+    if (this->atc_failed_) {
+        this->atc_failed_ = false;
+        this->update_temp_source(temp_source_options::EXTERNAL_ATC);
+        ESP_LOGD(TAG, "External sensor recovered, switching from ATC Fail to External ATC Sensor");
+    }
+
+    // Update climate current temperature if using External ATC and the fused value moved enough
+    if (this->temp_source_state_ == temp_source_options::EXTERNAL_ATC &&
+        (std::isnan(this->current_temperature) ||
+         std::fabs(fused - this->current_temperature) >= this->external_deadband_))
+    {
+        this->current_temperature = fused;
+        this->publish_climate_();
+    }
+}
+
 void SinclairAC::set_vertical_swing_select(select::Select *vertical_swing_select)
 {
     this->vertical_swing_select_ = vertical_swing_select;
@@ -528,6 +617,142 @@ void SinclairAC::set_ac_indoor_temp_sensor(sensor::Sensor *ac_indoor_temp_sensor
     this->ac_indoor_temp_sensor_ = ac_indoor_temp_sensor;
 }
 
+void SinclairAC::publish_ac_indoor_temperature_(float temperature)
+{
+    if (this->ac_indoor_temp_sensor_ == nullptr && this->ac_indoor_temp_min_sensor_ == nullptr &&
+        this->ac_indoor_temp_max_sensor_ == nullptr)
+        return;
+
+    WindowAggregate &agg = this->ac_indoor_temp_agg_;
+    bool windowed = this->ac_indoor_temp_window_ms_ > 0;
+
+    if (windowed)
+    {
+        if (agg.count == 0 && agg.start == 0)
+            agg.reset(millis());
+        agg.add(temperature);
+        if (millis() - agg.start < this->ac_indoor_temp_window_ms_)
+            return;
+        this->ac_indoor_temp_value_ = agg.mean();
+        this->ac_indoor_temp_min_ = agg.min;
+        this->ac_indoor_temp_max_ = agg.max;
+        agg.reset(millis());
+    }
+    else
+    {
+        this->ac_indoor_temp_value_ = temperature;
+    }
+
+    /* without a deadband any change counts, a window with min or max sensors goes out whenever one of them moved */
+    float deadband = this->ac_indoor_temp_deadband_;
+    bool moved = std::isnan(this->ac_indoor_temp_published_) ||
+                 (deadband > 0 ? std::fabs(this->ac_indoor_temp_value_ - this->ac_indoor_temp_published_) >= deadband
+                               : this->ac_indoor_temp_value_ != this->ac_indoor_temp_published_);
+    if (windowed && !moved && this->ac_indoor_temp_min_sensor_ != nullptr)
+        moved = std::fabs(this->ac_indoor_temp_min_ - this->ac_indoor_temp_min_sensor_->raw_state) >= deadband &&
+                this->ac_indoor_temp_min_ != this->ac_indoor_temp_min_sensor_->raw_state;
+    if (windowed && !moved && this->ac_indoor_temp_max_sensor_ != nullptr)
+        moved = std::fabs(this->ac_indoor_temp_max_ - this->ac_indoor_temp_max_sensor_->raw_state) >= deadband &&
+                this->ac_indoor_temp_max_ != this->ac_indoor_temp_max_sensor_->raw_state;
+
+    if (this->publish_allowed_(PUB_AC_INDOOR_TEMP, moved))
+        this->publish_entity_(PUB_AC_INDOOR_TEMP);
+}
+
+bool SinclairAC::publish_allowed_(PublishEntity entity, bool changed)
+{
+    if (!changed && this->governor_.published_once(entity))
+    {
+        this->governor_.unchanged(entity);
+        return false;
+    }
+    return this->governor_.request(entity, millis());
+}
+
+void SinclairAC::publish_climate_()
+{
+    if (this->publish_allowed_(PUB_CLIMATE, true))
+        this->publish_state();
+}
+
+void SinclairAC::publish_entity_(PublishEntity entity)
+{
+    switch (entity)
+    {
+        case PUB_CLIMATE:
+            this->publish_state();
+            break;
+        case PUB_AC_INDOOR_TEMP:
+            this->ac_indoor_temp_published_ = this->ac_indoor_temp_value_;
+            if (this->ac_indoor_temp_sensor_ != nullptr)
+                this->ac_indoor_temp_sensor_->publish_state(this->ac_indoor_temp_value_);
+            if (this->ac_indoor_temp_window_ms_ > 0 && this->ac_indoor_temp_min_sensor_ != nullptr)
+                this->ac_indoor_temp_min_sensor_->publish_state(this->ac_indoor_temp_min_);
+            if (this->ac_indoor_temp_window_ms_ > 0 && this->ac_indoor_temp_max_sensor_ != nullptr)
+                this->ac_indoor_temp_max_sensor_->publish_state(this->ac_indoor_temp_max_);
+            break;
+        case PUB_VERTICAL_SWING:
+            if (this->vertical_swing_select_ != nullptr)
+                this->vertical_swing_select_->publish_state(this->vertical_swing_state_);
+            break;
+        case PUB_HORIZONTAL_SWING:
+            if (this->horizontal_swing_select_ != nullptr)
+                this->horizontal_swing_select_->publish_state(this->horizontal_swing_state_);
+            break;
+        case PUB_DISPLAY:
+            if (this->display_select_ != nullptr)
+                this->display_select_->publish_state(this->display_state_);
+            break;
+        case PUB_DISPLAY_UNIT:
+            if (this->display_unit_select_ != nullptr)
+                this->display_unit_select_->publish_state(this->display_unit_state_);
+            break;
+        case PUB_TEMP_SOURCE:
+            if (this->temp_source_select_ != nullptr)
+                this->temp_source_select_->publish_state(this->temp_source_state_);
+            break;
+        case PUB_PLASMA:
+            if (this->plasma_switch_ != nullptr)
+                this->plasma_switch_->publish_state(this->plasma_state_);
+            break;
+        case PUB_BEEPER:
+            if (this->beeper_switch_ != nullptr)
+                this->beeper_switch_->publish_state(this->beeper_state_);
+            break;
+        case PUB_SLEEP:
+            if (this->sleep_switch_ != nullptr)
+                this->sleep_switch_->publish_state(this->sleep_state_);
+            break;
+        case PUB_XFAN:
+            if (this->xfan_switch_ != nullptr)
+                this->xfan_switch_->publish_state(this->xfan_state_);
+            break;
+        case PUB_SAVE:
+            if (this->save_switch_ != nullptr)
+                this->save_switch_->publish_state(this->save_state_);
+            break;
+        default:
+            break;
+    }
+}
+
+void SinclairAC::log_publish_stats()
+{
+    static const char *const ENTITY_NAMES[PUB_ENTITY_COUNT] = {
+        "climate", "ac_indoor_temp", "vertical_swing", "horizontal_swing", "display", "display_unit",
+        "temp_source", "plasma", "beeper", "sleep", "xfan", "save",
+    };
+
+    for (uint8_t i = 0; i < PUB_ENTITY_COUNT; i++)
+    {
+        const PublishStats &stats = this->governor_.stats(static_cast<PublishEntity>(i));
+        ESP_LOGI(TAG, "Publish %-16s sent=%u unchanged=%u deferred=%u throttled=%u", ENTITY_NAMES[i],
+                 (unsigned) stats.published, (unsigned) stats.unchanged, (unsigned) stats.deferred,
+                 (unsigned) stats.throttled);
+    }
+    ESP_LOGI(TAG, "Publish total suppressed=%u", (unsigned) this->governor_.suppressed());
+}
+
 void SinclairAC::set_plasma_switch(switch_::Switch *plasma_switch)
 {
     this->plasma_switch_ = plasma_switch;
@@ -585,23 +810,146 @@ void SinclairAC::set_save_switch(switch_::Switch *save_switch)
 
 void SinclairAC::check_external_timeout()
 {
-    // Only check if we're using external ATC sensor and not already failed
+    // Check if external sensor data exists
+    if (this->last_external_update_ == 0) {
+        return;  // No external data received yet
+    }
+
+    // Each sensor has its own timeout, one of them dropping out only changes the fused value
+    uint32_t now = millis();
+    if (this->external_fusion_.expire(now) == 0)
+        return;
+
+    uint8_t fresh = this->external_fusion_.fresh_count();
+    if (fresh > 0) {
+        ESP_LOGW(TAG, "External sensor timeout, %u of %u sensors left", fresh, this->external_fusion_.size());
+        update_external_temperature_(now);
+        return;
+    }
+
+    // Only fail over if we're using external ATC sensor and not already failed
     if (this->temp_source_state_ != temp_source_options::EXTERNAL_ATC || this->atc_failed_) {
         return;
     }
 
-    // Check if external sensor data exists
-    if (this->last_external_update_ == 0) {
-        return;  // No external data received yet
+    ESP_LOGW(TAG, "All external sensors timed out, switching to ATC Fail mode");
+    this->atc_failed_ = true;
+    this->update_temp_source(temp_source_options::ATC_FAIL);
+}
+
+/*
+ * Weekly schedule
+ */
+
+void SinclairAC::update_schedule_()
+{
+#ifdef USE_TIME
+    if (this->time_ == nullptr || !this->schedule_.enabled() || millis() - this->schedule_checked_ < 1000)
+        return;
+    this->schedule_checked_ = millis();
+
+    ESPTime now = this->time_->now();
+    if (!now.is_valid())
+        return;
+
+    const ScheduleEntry *entry;
+    while ((entry = this->schedule_.next_due(now.day_of_week - 1, now.hour * 60 + now.minute)) != nullptr)
+        apply_schedule_entry_(*entry);
+#endif
+}
+
+void SinclairAC::apply_schedule_entry_(const ScheduleEntry &entry)
+{
+    ESP_LOGI(TAG, "Schedule %02u:%02u mode=%s target=%.1f fan=%s swing=%s", entry.minute / 60, entry.minute % 60,
+             schedule_mode_to_string(entry.mode), entry.target_x2 == SCHEDULE_KEEP ? NAN : entry.target_x2 / 2.0f,
+             entry.fan < FAN_MODE_OPTIONS_COUNT ? CUSTOM_FAN_MODES[entry.fan] : "-",
+             schedule_swing_to_string(entry.swing));
+
+    /* same path as a command from Home Assistant */
+    auto call = this->make_call();
+    if (entry.mode != SCHEDULE_KEEP)
+        call.set_mode(static_cast<climate::ClimateMode>(entry.mode));
+    if (entry.target_x2 != SCHEDULE_KEEP)
+        call.set_target_temperature(entry.target_x2 / 2.0f);
+    if (entry.fan < FAN_MODE_OPTIONS_COUNT)
+        call.set_fan_mode(CUSTOM_FAN_MODES[entry.fan]);
+    if (entry.swing != SCHEDULE_KEEP)
+        call.set_swing_mode(static_cast<climate::ClimateSwingMode>(entry.swing));
+    call.perform();
+}
+
+bool SinclairAC::schedule_add(uint8_t days, uint8_t hour, uint8_t minute, const std::string &mode, float target,
+                              const std::string &fan, const std::string &swing)
+{
+    ScheduleEntry entry{};
+    entry.minute = hour * 60 + minute;
+    entry.days = days;
+    entry.mode = schedule_mode_from_string(mode.c_str());
+    if (std::isnan(target))
+        entry.target_x2 = SCHEDULE_KEEP;
+    else
+        entry.target_x2 = static_cast<uint8_t>(roundf(std::min(std::max(target, (float) MIN_TEMPERATURE),
+                                                                (float) MAX_TEMPERATURE) * 2));
+    entry.fan = schedule_fan_from_string(fan.c_str());
+    entry.swing = schedule_swing_from_string(swing.c_str());
+
+    if (hour > 23 || minute > 59 || (!mode.empty() && entry.mode == SCHEDULE_KEEP) ||
+        (!fan.empty() && entry.fan == SCHEDULE_KEEP) || (!swing.empty() && entry.swing == SCHEDULE_KEEP))
+    {
+        ESP_LOGW(TAG, "Schedule entry %02u:%02u rejected, check the time and the mode, fan and swing names", hour, minute);
+        return false;
     }
+    if (!this->schedule_.add(entry))
+    {
+        ESP_LOGW(TAG, "Schedule entry %02u:%02u rejected, no days or the table is full (%u entries)", hour, minute,
+                 SCHEDULE_MAX_ENTRIES);
+        return false;
+    }
+    save_schedule_();
+    return true;
+}
+
+bool SinclairAC::schedule_remove(uint8_t index)
+{
+    if (!this->schedule_.remove(index))
+        return false;
+    save_schedule_();
+    return true;
+}
+
+void SinclairAC::schedule_clear()
+{
+    this->schedule_.clear();
+    save_schedule_();
+}
+
+void SinclairAC::schedule_enable(bool enabled)
+{
+    this->schedule_.set_enabled(enabled);
+    save_schedule_();
+}
+
+void SinclairAC::save_schedule_()
+{
+    /* entries from the YAML arrive before setup(), they are only a default */
+    if (!this->schedule_loaded_)
+        return;
+    SINCLAIR_PROFILE_SCOPE(PROF_PREF_SAVE);
+    this->pref_schedule_.save(&this->schedule_.table());
+}
 
-    // Check if sensor has timed out (ATC_SENSOR_TIMEOUT_MS)
-    uint32_t time_since_update = millis() - this->last_external_update_;
-    if (time_since_update > ATC_SENSOR_TIMEOUT_MS) {
-        ESP_LOGW(TAG, "External sensor timeout (no data for 15 minutes), switching to ATC Fail mode");
-        this->atc_failed_ = true;
-        this->temp_source_state_ = temp_source_options::ATC_FAIL;
-        this->update_temp_source(this->temp_source_state_);
+void SinclairAC::log_schedule()
+{
+    ESP_LOGI(TAG, "Schedule %s, %u of %u entries", this->schedule_.enabled() ? "enabled" : "disabled",
+             this->schedule_.size(), SCHEDULE_MAX_ENTRIES);
+    for (uint8_t i = 0; i < this->schedule_.size(); i++)
+    {
+        const ScheduleEntry &entry = this->schedule_.entry(i);
+        ESP_LOGI(TAG, "  %2u: %02u:%02u days=0x%02X mode=%s target=%.1f fan=%s swing=%s", i, entry.minute / 60,
+                 entry.minute % 60, entry.days, schedule_mode_to_string(entry.mode),
+                 entry.target_x2 == SCHEDULE_KEEP ? NAN : entry.target_x2 / 2.0f,
+                 entry.fan < FAN_MODE_OPTIONS_COUNT ? CUSTOM_FAN_MODES[entry.fan] : "-",
+                 schedule_swing_to_string(entry.swing));
     }
 }
 
@@ -611,77 +959,141 @@ void SinclairAC::check_external_timeout()
 
 void SinclairAC::load_preferences_()
 {
-    uint8_t loaded_display_idx = 0;
-    uint8_t loaded_display_unit_idx = 0;
-    uint8_t loaded_vswing_idx = 0;
-    uint8_t loaded_hswing_idx = 0;
-    uint8_t loaded_temp_source_idx = 0;
-    bool loaded_plasma = false;
-    bool loaded_beeper = false;
-    bool loaded_sleep = false;
-    bool loaded_xfan = false;
-    bool loaded_save = false;
-    
-    // Load display preference
-    if (this->pref_display_.load(&loaded_display_idx)) {
+    if (this->fast_boot_)
+    {
+        uint32_t start_us = micros();
+        FastBootState state;
+        if (this->pref_fast_boot_.load(&state))
+        {
+            this->fast_boot_state_ = state;
+            this->fast_boot_loaded_ = true;
+
+            this->saved_display_idx_ = state.display_idx;
+            this->saved_display_unit_idx_ = state.display_unit_idx;
+            this->saved_vertical_swing_idx_ = state.vertical_swing_idx;
+            this->saved_horizontal_swing_idx_ = state.horizontal_swing_idx;
+            this->saved_temp_source_idx_ = state.temp_source_idx;
+            this->saved_plasma_ = state.plasma;
+            this->saved_beeper_ = state.beeper;
+            this->saved_sleep_ = state.sleep;
+            this->saved_xfan_ = state.xfan;
+            this->saved_save_ = state.save;
+            ESP_LOGI(TAG, "Fast boot state loaded in %u us", (unsigned) (micros() - start_us));
+        }
+        else
+        {
+            /* First boot with fast_boot enabled: migrate the per-setting preferences into the blob */
+            ESP_LOGI(TAG, "No fast boot state found, migrating per-setting preferences");
+            load_legacy_preferences_();
+            this->fast_boot_dirty_ = true;
+        }
+    }
+    else
+    {
+        load_legacy_preferences_();
+    }
+
+    apply_saved_preferences_();
+}
+
+void SinclairAC::load_legacy_preferences_()
+{
+    uint8_t loaded_idx = 0;
+    bool loaded_bool = false;
+
+    if (this->pref_display_.load(&loaded_idx))
+        this->saved_display_idx_ = loaded_idx;
+    if (this->pref_display_unit_.load(&loaded_idx))
+        this->saved_display_unit_idx_ = loaded_idx;
+    if (this->pref_vertical_swing_.load(&loaded_idx))
+        this->saved_vertical_swing_idx_ = loaded_idx;
+    if (this->pref_horizontal_swing_.load(&loaded_idx))
+        this->saved_horizontal_swing_idx_ = loaded_idx;
+    if (this->pref_temp_source_.load(&loaded_idx))
+        this->saved_temp_source_idx_ = loaded_idx;
+
+    if (this->pref_plasma_.load(&loaded_bool))
+        this->saved_plasma_ = loaded_bool;
+    if (this->pref_beeper_.load(&loaded_bool))
+        this->saved_beeper_ = loaded_bool;
+    if (this->pref_sleep_.load(&loaded_bool))
+        this->saved_sleep_ = loaded_bool;
+    if (this->pref_xfan_.load(&loaded_bool))
+        this->saved_xfan_ = loaded_bool;
+    if (this->pref_save_.load(&loaded_bool))
+        this->saved_save_ = loaded_bool;
+}
+
+/*
+ * Restores entity states from the preference caches filled by either load path
+ */
+void SinclairAC::apply_saved_preferences_()
+{
+    // Restore display preference
+    uint8_t loaded_display_idx = this->saved_display_idx_;
+    if (loaded_display_idx != PREF_NOT_SAVED) {
         if (loaded_display_idx < DISPLAY_OPTIONS_COUNT) {
-            std::string display_str = display_string_from_index_(loaded_display_idx);
+            const char *display_str = display_string_from_index_(loaded_display_idx);
             if (this->display_select_ != nullptr && display_str != this->display_state_) {
                 this->display_state_ = display_str;
                 this->display_select_->publish_state(display_str);
-                ESP_LOGD(TAG, "Restored display: %s (index %d)", display_str.c_str(), loaded_display_idx);
+                ESP_LOGD(TAG, "Restored display: %s (index %d)", display_str, loaded_display_idx);
             }
         } else {
             ESP_LOGW(TAG, "Invalid display index loaded: %d", loaded_display_idx);
         }
     }
     
-    // Load display unit preference
-    if (this->pref_display_unit_.load(&loaded_display_unit_idx)) {
+    // Restore display unit preference
+    uint8_t loaded_display_unit_idx = this->saved_display_unit_idx_;
+    if (loaded_display_unit_idx != PREF_NOT_SAVED) {
         if (loaded_display_unit_idx < DISPLAY_UNIT_OPTIONS_COUNT) {
-            std::string display_unit_str = display_unit_string_from_index_(loaded_display_unit_idx);
+            const char *display_unit_str = display_unit_string_from_index_(loaded_display_unit_idx);
             if (this->display_unit_select_ != nullptr && display_unit_str != this->display_unit_state_) {
                 this->display_unit_state_ = display_unit_str;
                 this->display_unit_select_->publish_state(display_unit_str);
-                ESP_LOGD(TAG, "Restored display unit: %s (index %d)", display_unit_str.c_str(), loaded_display_unit_idx);
+                ESP_LOGD(TAG, "Restored display unit: %s (index %d)", display_unit_str, loaded_display_unit_idx);
             }
         } else {
             ESP_LOGW(TAG, "Invalid display unit index loaded: %d", loaded_display_unit_idx);
         }
     }
     
-    // Load vertical swing preference
-    if (this->pref_vertical_swing_.load(&loaded_vswing_idx)) {
+    // Restore vertical swing preference
+    uint8_t loaded_vswing_idx = this->saved_vertical_swing_idx_;
+    if (loaded_vswing_idx != PREF_NOT_SAVED) {
         if (loaded_vswing_idx < VERTICAL_SWING_OPTIONS_COUNT) {
-            std::string vswing_str = vertical_swing_string_from_index_(loaded_vswing_idx);
+            const char *vswing_str = vertical_swing_string_from_index_(loaded_vswing_idx);
             if (this->vertical_swing_select_ != nullptr && vswing_str != this->vertical_swing_state_) {
                 this->vertical_swing_state_ = vswing_str;
                 this->vertical_swing_select_->publish_state(vswing_str);
-                ESP_LOGD(TAG, "Restored vertical swing: %s (index %d)", vswing_str.c_str(), loaded_vswing_idx);
+                ESP_LOGD(TAG, "Restored vertical swing: %s (index %d)", vswing_str, loaded_vswing_idx);
             }
         } else {
             ESP_LOGW(TAG, "Invalid vertical swing index loaded: %d", loaded_vswing_idx);
         }
     }
     
-    // Load horizontal swing preference
-    if (this->pref_horizontal_swing_.load(&loaded_hswing_idx)) {
+    // Restore horizontal swing preference
+    uint8_t loaded_hswing_idx = this->saved_horizontal_swing_idx_;
+    if (loaded_hswing_idx != PREF_NOT_SAVED) {
         if (loaded_hswing_idx < HORIZONTAL_SWING_OPTIONS_COUNT) {
-            std::string hswing_str = horizontal_swing_string_from_index_(loaded_hswing_idx);
+            const char *hswing_str = horizontal_swing_string_from_index_(loaded_hswing_idx);
             if (this->horizontal_swing_select_ != nullptr && hswing_str != this->horizontal_swing_state_) {
                 this->horizontal_swing_state_ = hswing_str;
                 this->horizontal_swing_select_->publish_state(hswing_str);
-                ESP_LOGD(TAG, "Restored horizontal swing: %s (index %d)", hswing_str.c_str(), loaded_hswing_idx);
+                ESP_LOGD(TAG, "Restored horizontal swing: %s (index %d)", hswing_str, loaded_hswing_idx);
             }
         } else {
             ESP_LOGW(TAG, "Invalid horizontal swing index loaded: %d", loaded_hswing_idx);
         }
     }
     
-    // Load temperature source preference
-    if (this->pref_temp_source_.load(&loaded_temp_source_idx)) {
+    // Restore temperature source preference
+    uint8_t loaded_temp_source_idx = this->saved_temp_source_idx_;
+    if (loaded_temp_source_idx != PREF_NOT_SAVED) {
         if (loaded_temp_source_idx < TEMP_SOURCE_OPTIONS_COUNT) {
-            std::string temp_source_str = temp_source_string_from_index_(loaded_temp_source_idx);
+            const char *temp_source_str = temp_source_string_from_index_(loaded_temp_source_idx);
             
             // If index is 2 (ATC Fail), set the fail flag
             if (loaded_temp_source_idx == 2) {
@@ -692,15 +1104,16 @@ void SinclairAC::load_preferences_()
             if (this->temp_source_select_ != nullptr && temp_source_str != this->temp_source_state_) {
                 this->temp_source_state_ = temp_source_str;
                 this->temp_source_select_->publish_state(temp_source_str);
-                ESP_LOGD(TAG, "Restored temp source: %s (index %d)", temp_source_str.c_str(), loaded_temp_source_idx);
+                ESP_LOGD(TAG, "Restored temp source: %s (index %d)", temp_source_str, loaded_temp_source_idx);
             }
         } else {
             ESP_LOGW(TAG, "Invalid temp source index loaded: %d", loaded_temp_source_idx);
         }
     }
     
-    // Load boolean preferences
-    if (this->pref_plasma_.load(&loaded_plasma)) {
+    // Restore boolean preferences
+    if (this->saved_plasma_ != PREF_NOT_SAVED) {
+        bool loaded_plasma = this->saved_plasma_;
         if (this->plasma_switch_ != nullptr && loaded_plasma != this->plasma_state_) {
             this->plasma_state_ = loaded_plasma;
             this->plasma_switch_->publish_state(loaded_plasma);
@@ -708,7 +1121,8 @@ void SinclairAC::load_preferences_()
         }
     }
     
-    if (this->pref_beeper_.load(&loaded_beeper)) {
+    if (this->saved_beeper_ != PREF_NOT_SAVED) {
+        bool loaded_beeper = this->saved_beeper_;
         if (this->beeper_switch_ != nullptr && loaded_beeper != this->beeper_state_) {
             this->beeper_state_ = loaded_beeper;
             this->beeper_switch_->publish_state(loaded_beeper);
@@ -716,7 +1130,8 @@ void SinclairAC::load_preferences_()
         }
     }
     
-    if (this->pref_sleep_.load(&loaded_sleep)) {
+    if (this->saved_sleep_ != PREF_NOT_SAVED) {
+        bool loaded_sleep = this->saved_sleep_;
         if (this->sleep_switch_ != nullptr && loaded_sleep != this->sleep_state_) {
             this->sleep_state_ = loaded_sleep;
             this->sleep_switch_->publish_state(loaded_sleep);
@@ -724,7 +1139,8 @@ void SinclairAC::load_preferences_()
         }
     }
     
-    if (this->pref_xfan_.load(&loaded_xfan)) {
+    if (this->saved_xfan_ != PREF_NOT_SAVED) {
+        bool loaded_xfan = this->saved_xfan_;
         if (this->xfan_switch_ != nullptr && loaded_xfan != this->xfan_state_) {
             this->xfan_state_ = loaded_xfan;
             this->xfan_switch_->publish_state(loaded_xfan);
@@ -732,7 +1148,8 @@ void SinclairAC::load_preferences_()
         }
     }
     
-    if (this->pref_save_.load(&loaded_save)) {
+    if (this->saved_save_ != PREF_NOT_SAVED) {
+        bool loaded_save = this->saved_save_;
         if (this->save_switch_ != nullptr && loaded_save != this->save_state_) {
             this->save_state_ = loaded_save;
             this->save_switch_->publish_state(loaded_save);
@@ -746,18 +1163,163 @@ void SinclairAC::load_preferences_()
              this->temp_source_state_.c_str());
 }
 
+void SinclairAC::save_fast_boot_state_()
+{
+    SINCLAIR_PROFILE_SCOPE(PROF_PREF_SAVE);
+
+    /* The last SET payload part of the blob is kept up to date by the protocol class */
+    this->fast_boot_state_.display_idx = this->saved_display_idx_;
+    this->fast_boot_state_.display_unit_idx = this->saved_display_unit_idx_;
+    this->fast_boot_state_.vertical_swing_idx = this->saved_vertical_swing_idx_;
+    this->fast_boot_state_.horizontal_swing_idx = this->saved_horizontal_swing_idx_;
+    this->fast_boot_state_.temp_source_idx = this->saved_temp_source_idx_;
+    this->fast_boot_state_.plasma = this->saved_plasma_;
+    this->fast_boot_state_.beeper = this->saved_beeper_;
+    this->fast_boot_state_.sleep = this->saved_sleep_;
+    this->fast_boot_state_.xfan = this->saved_xfan_;
+    this->fast_boot_state_.save = this->saved_save_;
+
+    this->pref_fast_boot_.save(&this->fast_boot_state_);
+    this->fast_boot_dirty_ = false;
+    ESP_LOGD(TAG, "Saved fast boot state");
+}
+
+/*
+ * Warm restart state
+ */
+
+bool SinclairAC::restore_warm_state_()
+{
+    if (!warm::load(&this->warm_state_))
+        return false;
+
+    this->saved_display_idx_ = this->warm_state_.display_idx;
+    this->saved_display_unit_idx_ = this->warm_state_.display_unit_idx;
+    this->saved_vertical_swing_idx_ = this->warm_state_.vertical_swing_idx;
+    this->saved_horizontal_swing_idx_ = this->warm_state_.horizontal_swing_idx;
+    this->saved_temp_source_idx_ = this->warm_state_.temp_source_idx;
+    this->saved_plasma_ = this->warm_state_.plasma;
+    this->saved_beeper_ = this->warm_state_.beeper;
+    this->saved_sleep_ = this->warm_state_.sleep;
+    this->saved_xfan_ = this->warm_state_.xfan;
+    this->saved_save_ = this->warm_state_.save;
+
+    this->warm_restored_ = true;
+    ESP_LOGI(TAG, "Warm restart, restoring state from RTC memory");
+    return true;
+}
+
+void SinclairAC::save_warm_state_()
+{
+    /* The report and last SET payload parts are kept up to date by the protocol class */
+    this->warm_state_.display_idx = this->saved_display_idx_;
+    this->warm_state_.display_unit_idx = this->saved_display_unit_idx_;
+    this->warm_state_.vertical_swing_idx = this->saved_vertical_swing_idx_;
+    this->warm_state_.horizontal_swing_idx = this->saved_horizontal_swing_idx_;
+    this->warm_state_.temp_source_idx = this->saved_temp_source_idx_;
+    this->warm_state_.plasma = this->saved_plasma_;
+    this->warm_state_.beeper = this->saved_beeper_;
+    this->warm_state_.sleep = this->saved_sleep_;
+    this->warm_state_.xfan = this->saved_xfan_;
+    this->warm_state_.save = this->saved_save_;
+
+    warm::save(&this->warm_state_);
+    this->warm_dirty_ = false;
+}
+
+/*
+ * Link statistics
+ */
+
+void SinclairAC::note_link_damage_()
+{
+    if (this->link_damaged_since_ == 0)
+        this->link_damaged_since_ = millis() | 1;  /* 0 means clean */
+}
+
+void SinclairAC::reset_link_stats()
+{
+    this->link_ = LinkStats();
+    this->link_.since = millis();
+    this->link_damaged_since_ = 0;
+}
+
+void SinclairAC::log_link_stats()
+{
+    const LinkStats &stats = this->link_;
+    uint32_t elapsed = millis() - stats.since;
+    uint32_t damaged = stats.truncated + stats.bad_length + stats.bad_command + stats.bad_checksum;
+    ESP_LOGI(TAG, "Link frames ok=%u (%.2f/s) damaged=%u (truncated=%u length=%u command=%u checksum=%u)",
+             (unsigned) stats.frames_ok, elapsed ? stats.frames_ok * 1000.0f / elapsed : 0.0f, (unsigned) damaged,
+             (unsigned) stats.truncated, (unsigned) stats.bad_length, (unsigned) stats.bad_command,
+             (unsigned) stats.bad_checksum);
+    ESP_LOGI(TAG, "Link resyncs=%u max=%u avg=%u ms, ready=%u lost=%u false_ready=%u",
+             (unsigned) stats.resyncs, (unsigned) stats.resync_max_ms,
+             (unsigned) (stats.resyncs ? stats.resync_total_ms / stats.resyncs : 0),
+             (unsigned) stats.ready_transitions, (unsigned) stats.link_losses, (unsigned) stats.false_ready);
+}
+
 /*
  * Debugging
  */
 
-void SinclairAC::log_packet(std::vector<uint8_t> data, bool outgoing)
+void SinclairAC::log_packet(const uint8_t *data, size_t len, bool outgoing)
 {
+#if ESPHOME_LOG_LEVEL < ESPHOME_LOG_LEVEL_VERBOSE
+    /* RX frames are only logged at VERBOSE, do not bother formatting them */
+    if (!outgoing)
+        return;
+#endif
+
+    char hex[DATA_MAX * 3];
+    format_frame_(data, len, hex);
+
     if (outgoing) {
-        std::string hex = format_hex_pretty(data);
-        ESP_LOGI(TAG, "TX: %s", hex.c_str());
+        ESP_LOGI(TAG, "TX: %s", hex);
     } else {
-        std::string hex = format_hex_pretty(data);
-        ESP_LOGV(TAG, "RX: %s", hex.c_str());
+        ESP_LOGV(TAG, "RX: %s", hex);
+    }
+}
+
+void SinclairAC::format_frame_(const uint8_t *data, size_t len, char *out)
+{
+    /* Formatted on the stack, format_hex_pretty() would allocate a string for every frame */
+    static const char HEX_CHARS[] = "0123456789ABCDEF";
+    size_t pos = 0;
+    if (len > DATA_MAX)
+        len = DATA_MAX;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (i > 0)
+            out[pos++] = '.';
+        out[pos++] = HEX_CHARS[data[i] >> 4];
+        out[pos++] = HEX_CHARS[data[i] & 0x0F];
+    }
+    out[pos] = '\0';
+}
+
+/* Oldest first, in the TX:/RX: form scripts/sinclair_corpus.cpp reads */
+void SinclairAC::log_frame_trace()
+{
+    const FrameTrace &trace = this->frame_trace_;
+    if (trace.capacity() == 0)
+    {
+        ESP_LOGI(TAG, "Frame trace is disabled, set frame_trace to keep one");
+        return;
+    }
+
+    ESP_LOGI(TAG, "Frame trace: %u frames, %u recorded, %u overwritten", trace.size(), (unsigned) trace.recorded(),
+             (unsigned) trace.overwritten());
+    char hex[DATA_MAX * 3];
+    for (uint16_t i = 0; i < trace.size(); i++)
+    {
+        const TraceEntry &entry = trace.at(i);
+        format_frame_(entry.data, entry.stored(), hex);
+        if (entry.stored() < entry.len)
+            ESP_LOGI(TAG, "[%u] %s: %s (%u bytes)", (unsigned) entry.timestamp, entry.outgoing ? "TX" : "RX", hex,
+                     entry.len);
+        else
+            ESP_LOGI(TAG, "[%u] %s: %s", (unsigned) entry.timestamp, entry.outgoing ? "TX" : "RX", hex);
     }
 }
 
@@ -6,8 +6,21 @@
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/switch/switch.h"
 #include "esphome/components/uart/uart.h"
+#include "esphome/core/automation.h"
 #include "esphome/core/component.h"
 #include "esphome/core/preferences.h"
+#ifdef USE_TIME
+#include "esphome/components/time/real_time_clock.h"
+#endif
+
+#include "esppac_fusion.h"
+#include "esppac_governor.h"
+#include "esppac_options.h"
+#include "esppac_profile.h"
+#include "esppac_schedule.h"
+#include "esppac_stats.h"
+#include "esppac_trace.h"
+#include "esppac_warm.h"
 
 namespace esphome {
 
@@ -23,67 +36,7 @@ static const float TEMPERATURE_STEP = 0.5;   // Steps the temperature can be set
 static const float TEMPERATURE_TOLERANCE = 1;  // The tolerance to allow when checking the climate state
 static const uint8_t TEMPERATURE_THRESHOLD = 100;  // Maximum temperature the AC can report (formally 119.5 for sinclair protocol, but 100 is impossible, soo...)
 
-static const uint32_t ATC_SENSOR_TIMEOUT_MS = 900000;  // 15 minutes in milliseconds
-
-namespace fan_modes{
-    const std::string FAN_AUTO  = "0 - Auto";
-    const std::string FAN_QUIET = "1 - Quiet";
-    const std::string FAN_LOW   = "2 - Low";
-    const std::string FAN_MEDL  = "3 - Medium-Low";
-    const std::string FAN_MED   = "4 - Medium";
-    const std::string FAN_MEDH  = "5 - Medium-High";
-    const std::string FAN_HIGH  = "6 - High";
-    const std::string FAN_TURBO = "7 - Turbo";
-}
-
-/* this must be same as HORIZONTAL_SWING_OPTIONS in climate.py */
-namespace horizontal_swing_options{
-    const std::string OFF    = "0 - OFF";
-    const std::string FULL   = "1 - Swing - Full";
-    const std::string CLEFT  = "2 - Constant - Left";
-    const std::string CMIDL  = "3 - Constant - Mid-Left";
-    const std::string CMID   = "4 - Constant - Middle";
-    const std::string CMIDR  = "5 - Constant - Mid-Right";
-    const std::string CRIGHT = "6 - Constant - Right";
-}
-
-/* this must be same as VERTICAL_SWING_OPTIONS in climate.py */
-namespace vertical_swing_options{
-    const std::string OFF   = "00 - OFF";
-    const std::string FULL  = "01 - Swing - Full";
-    const std::string DOWN  = "02 - Swing - Down";
-    const std::string MIDD  = "03 - Swing - Mid-Down";
-    const std::string MID   = "04 - Swing - Middle";
-    const std::string MIDU  = "05 - Swing - Mid-Up";
-    const std::string UP    = "06 - Swing - Up";
-    const std::string CDOWN = "07 - Constant - Down";
-    const std::string CMIDD = "08 - Constant - Mid-Down";
-    const std::string CMID  = "09 - Constant - Middle";
-    const std::string CMIDU = "10 - Constant - Mid-Up";
-    const std::string CUP   = "11 - Constant - Up";
-}
-
-/* this must be same as DISPLAY_OPTIONS in climate.py */
-namespace display_options{
-    const std::string OFF  = "0 - OFF";
-    const std::string AUTO = "1 - Auto";
-    const std::string SET  = "2 - Set temperature";
-    const std::string ACT  = "3 - Actual temperature";
-    const std::string OUT  = "4 - Outside temperature";
-}
-
-/* this must be same as DISPLAY_UNIT_OPTIONS in climate.py */
-namespace display_unit_options{
-    const std::string DEGC = "C";
-    const std::string DEGF = "F";
-}
-
-/* this must be same as TEMP_SOURCE_OPTIONS in climate.py */
-namespace temp_source_options{
-    const std::string AC_OWN = "AC Own Sensor";
-    const std::string EXTERNAL_ATC = "External ATC Sensor";
-    const std::string ATC_FAIL = "ATC Fail";
-}
+static const uint32_t ATC_SENSOR_TIMEOUT_MS = 900000;  // 15 minutes in milliseconds, default timeout per external sensor
 
 typedef enum {
         STATE_WAIT_SYNC,
@@ -101,6 +54,57 @@ typedef struct {
         SerialProcessState_t state;
 } SerialProcess_t;
 
+/* Receive side of the link: how often frames arrive damaged and how fast the link gets back.
+   A resync runs from the first damaged frame after a good one to the next good frame. */
+struct LinkStats {
+    uint32_t since = 0;             /* millis() the counters started */
+    uint32_t frames_ok = 0;         /* passed verify_packet(), ignored telemetry not included */
+    uint32_t truncated = 0;         /* stopped mid-frame for READ_TIMEOUT, lost bytes or a damaged LEN */
+    uint32_t bad_length = 0;
+    uint32_t bad_command = 0;
+    uint32_t bad_checksum = 0;
+    uint32_t resyncs = 0;
+    uint32_t resync_max_ms = 0;
+    uint32_t resync_total_ms = 0;
+    uint32_t ready_transitions = 0;
+    uint32_t link_losses = 0;       /* Ready dropped back to Initializing after TIME_TIMEOUT_INACTIVE_MS */
+    uint32_t false_ready = 0;       /* Ready that lost the link again before a second report arrived */
+};
+
+/* Fast boot keeps every persisted setting plus the last SET payload in a single preference,
+   so setup() restores all of it with one read. Unset fields hold PREF_NOT_SAVED. */
+struct FastBootState {
+    uint8_t display_idx;
+    uint8_t display_unit_idx;
+    uint8_t vertical_swing_idx;
+    uint8_t horizontal_swing_idx;
+    uint8_t temp_source_idx;
+    uint8_t plasma;
+    uint8_t beeper;
+    uint8_t sleep;
+    uint8_t xfan;
+    uint8_t save;
+    uint8_t has_last_packet;
+    uint8_t last_packet[45];  // Must match protocol::SET_PACKET_LEN (45 bytes)
+};
+
+/* Raw frame handed to on_frame_received / on_frame_sent, SYNC bytes to checksum. It points
+   into the RX buffer or the TX frame and is only valid while the trigger runs, copy the
+   bytes before a delay or wait action. */
+struct FrameView {
+    const uint8_t *data;
+    size_t len;
+    uint32_t timestamp;  // millis() of the last byte received, or of the write for TX
+    bool outgoing;
+
+    size_t size() const { return this->len; }
+    uint8_t operator[](size_t i) const { return this->data[i]; }
+    const uint8_t *begin() const { return this->data; }
+    const uint8_t *end() const { return this->data + this->len; }
+};
+
+class FrameTrigger : public Trigger<FrameView> {};
+
 class SinclairAC : public Component, public uart::UARTDevice, public climate::Climate
 {
     public:
@@ -118,8 +122,53 @@ class SinclairAC : public Component, public uart::UARTDevice, public climate::Cl
         void set_save_switch(switch_::Switch *plasma_switch);
         
         void set_current_temperature_sensor(sensor::Sensor *current_temperature_sensor);
+        /* One of up to FUSION_MAX_SOURCES external sensors fused into the current temperature */
+        void add_current_temperature_sensor(sensor::Sensor *sens, uint32_t timeout_ms, float weight);
+        void set_current_temperature_outlier(float threshold) { this->external_fusion_.set_outlier_threshold(threshold); }
+        void set_current_temperature_deadband(float deadband) { this->external_deadband_ = deadband; }
+        const TemperatureFusion &get_temperature_fusion() const { return this->external_fusion_; }
         void set_ac_indoor_temp_sensor(sensor::Sensor *ac_indoor_temp_sensor);
+        void set_ac_indoor_temp_min_sensor(sensor::Sensor *sens) { this->ac_indoor_temp_min_sensor_ = sens; }
+        void set_ac_indoor_temp_max_sensor(sensor::Sensor *sens) { this->ac_indoor_temp_max_sensor_ = sens; }
+        void set_ac_indoor_temp_window(uint32_t window_ms) { this->ac_indoor_temp_window_ms_ = window_ms; }
+        void set_ac_indoor_temp_deadband(float deadband) { this->ac_indoor_temp_deadband_ = deadband; }
             // debug text sensors removed
+        void set_fast_boot(bool fast_boot) { this->fast_boot_ = fast_boot; }
+        void set_publish_min_interval(uint8_t entity, uint32_t interval_ms)
+        {
+            this->governor_.set_min_interval(static_cast<PublishEntity>(entity), interval_ms);
+        }
+        void set_publish_rate_limit(uint16_t per_second) { this->governor_.set_rate_limit(per_second); }
+        const PublishGovernor &get_publish_governor() const { return this->governor_; }
+        void log_publish_stats();
+
+#ifdef USE_TIME
+        void set_time(time::RealTimeClock *time) { this->time_ = time; }
+#endif
+        /* Weekly schedule, meant to be called from API services. days is a bit mask with bit 0
+           for Sunday. mode, fan and swing use the climate entity's names, "" and NAN keep the
+           current value. Every edit is saved at once. */
+        bool schedule_add(uint8_t days, uint8_t hour, uint8_t minute, const std::string &mode, float target,
+                          const std::string &fan, const std::string &swing);
+        bool schedule_remove(uint8_t index);
+        void schedule_clear();
+        void schedule_enable(bool enabled);
+        void log_schedule();
+        const Schedule &get_schedule() const { return this->schedule_; }
+
+        const LinkStats &get_link_stats() const { return this->link_; }
+        void log_link_stats();
+        void reset_link_stats();
+
+        /* Keeps the last frames of both directions in RAM, 0 disables it. Allocated in setup(). */
+        void set_frame_trace_size(uint16_t size) { this->frame_trace_size_ = size; }
+        const FrameTrace &get_frame_trace() const { return this->frame_trace_; }
+        void log_frame_trace();
+
+#ifdef USE_SINCLAIR_AC_FRAME_HOOKS
+        void add_on_frame_received_trigger(FrameTrigger *trigger) { this->frame_received_triggers_.push_back(trigger); }
+        void add_on_frame_sent_trigger(FrameTrigger *trigger) { this->frame_sent_triggers_.push_back(trigger); }
+#endif
         void setup() override;
         void loop() override;
 
@@ -138,11 +187,61 @@ class SinclairAC : public Component, public uart::UARTDevice, public climate::Cl
         switch_::Switch *save_switch_            = nullptr; /* Switch for save */
 
         // (ignore_ready feature removed)
+
+        bool fast_boot_ = false;            /* Restore from one preference blob, publish at once and queue commands until Ready */
+        bool fast_boot_loaded_ = false;     /* The blob was found in flash */
+        bool fast_boot_dirty_ = false;      /* The blob changed and is written on the next loop */
+        FastBootState fast_boot_state_{};
+
+        WarmState warm_state_{};            /* Mirror of the RTC block, rewritten when something in it changed */
+        bool warm_restored_ = false;        /* setup() restored from the RTC block instead of flash */
+        bool warm_dirty_ = false;
         
         
 
-        sensor::Sensor *current_temperature_sensor_ = nullptr; /* If user wants to replace reported temperature by an external sensor readout */
         sensor::Sensor *ac_indoor_temp_sensor_   = nullptr; /* AC indoor temperature sensor for HA display */
+        sensor::Sensor *ac_indoor_temp_min_sensor_ = nullptr; /* Window minimum, only with a window */
+        sensor::Sensor *ac_indoor_temp_max_sensor_ = nullptr; /* Window maximum, only with a window */
+
+        uint32_t ac_indoor_temp_window_ms_ = 0;     /* 0 publishes every report */
+        float ac_indoor_temp_deadband_ = 0;         /* Skip publishes that moved less than this */
+        WindowAggregate ac_indoor_temp_agg_;
+        float ac_indoor_temp_published_ = NAN;      /* Last value sent, the deadband reference */
+        float ac_indoor_temp_value_ = NAN;          /* Values waiting to be published */
+        float ac_indoor_temp_min_ = NAN;
+        float ac_indoor_temp_max_ = NAN;
+
+        PublishGovernor governor_;                  /* Rate limits every publish done from report decoding */
+
+#ifdef USE_TIME
+        time::RealTimeClock *time_ = nullptr;
+#endif
+        Schedule schedule_;
+        ESPPreferenceObject pref_schedule_;
+        bool schedule_loaded_ = false;              /* setup() ran, edits are saved from now on */
+        uint32_t schedule_checked_ = 0;
+
+#ifdef USE_SINCLAIR_AC_FRAME_HOOKS
+        std::vector<FrameTrigger *> frame_received_triggers_;
+        std::vector<FrameTrigger *> frame_sent_triggers_;
+#endif
+        uint16_t frame_trace_size_ = 0;
+        FrameTrace frame_trace_;
+
+        /* Records a raw frame in the trace and hands it to the frame triggers. climate.py only defines
+           USE_SINCLAIR_AC_FRAME_HOOKS when an on_frame_* automation exists. */
+        void notify_frame_(const uint8_t *data, size_t len, bool outgoing, uint32_t timestamp)
+        {
+            this->frame_trace_.record(data, len, outgoing, timestamp);
+#ifdef USE_SINCLAIR_AC_FRAME_HOOKS
+            const auto &triggers = outgoing ? this->frame_sent_triggers_ : this->frame_received_triggers_;
+            if (triggers.empty())
+                return;
+            const FrameView frame{data, len, timestamp, outgoing};
+            for (auto *trigger : triggers)
+                trigger->trigger(frame);
+#endif
+        }
 
         std::string vertical_swing_state_;
         std::string horizontal_swing_state_;
@@ -157,35 +256,56 @@ class SinclairAC : public Component, public uart::UARTDevice, public climate::Cl
         bool xfan_state_;
         bool save_state_;
 
+        TemperatureFusion external_fusion_;     /* External sensors that replace the reported temperature */
+        float external_deadband_ = FUSION_DEFAULT_DEADBAND;
         uint32_t last_external_update_ = 0;     /* Timestamp of last external sensor update */
-        bool atc_failed_ = false;               /* Flag indicating if external sensor has failed/timed out */
-        float last_external_temperature_ = NAN; /* Last received external temperature */
+        bool atc_failed_ = false;               /* Flag indicating if all external sensors have failed/timed out */
+        float last_external_temperature_ = NAN; /* Last fused external temperature */
 
         SerialProcess_t serialProcess_;
 
-        float Temrec0 [16];
-        float Temrec1 [16];
-
         uint32_t init_time_;   // Stores the current time
         // uint32_t last_read_;   // Stores the time at which the last read was done
         uint32_t last_packet_sent_;  // Stores the time at which the last packet was sent
         uint32_t last_03packet_sent_;  // Stores the time at which the last packet was sent
         uint32_t last_packet_received_;  // Stores the time at which the last packet was received
-        bool wait_response_;
+        uint32_t last_rx_byte_ = 0;      // Stores the time at which the last byte was received, TX waits for the line to go quiet
+        uart::UARTComponent *rx_mirror_ = nullptr;  // Bridge mode: every byte read is copied here as it arrives
+        LinkStats link_;
+        uint32_t link_damaged_since_ = 0;  // First damaged frame of the current run, 0 while the link is clean
+        /* Starts the resync clock at the first damaged frame */
+        void note_link_damage_();
+        bool wait_response_ = false;
+
+#ifdef SINCLAIR_AC_PROFILE
+        uint32_t last_profile_dump_ = 0;  // Stores the time at which profiling counters were last logged
+#endif
 
         climate::ClimateTraits traits() override;
+        climate::ClimateTraits traits_;  /* Built once on first use, the API and publish_state() ask for it a lot */
+        bool traits_built_ = false;
 
         void read_data();
+        /* Feeds one byte to a framing state machine, true once it holds a complete frame. The
+           caller sets STATE_RESTART after handling it. */
+        static bool frame_byte_(SerialProcess_t &process, uint8_t c);
 
         void update_current_temperature(float temperature);
+        /* Feeds the AC indoor temperature sensors, aggregated over the window when one is set */
+        void publish_ac_indoor_temperature_(float temperature);
+        /* Change-only and rate limited, true when the entity should be published now */
+        bool publish_allowed_(PublishEntity entity, bool changed);
+        /* Publishes the current state of an entity, also used for publishes the governor held back */
+        void publish_entity_(PublishEntity entity);
+        void publish_climate_();
         void update_target_temperature(float temperature);
 
-        void update_swing_horizontal(const std::string &swing);
-        void update_swing_vertical(const std::string &swing);
+        void update_swing_horizontal(const char *swing);
+        void update_swing_vertical(const char *swing);
 
-        void update_display(const std::string &display);
-        void update_display_unit(const std::string &display_unit);
-        void update_temp_source(const std::string &temp_source);
+        void update_display(const char *display);
+        void update_display_unit(const char *display_unit);
+        void update_temp_source(const char *temp_source);
 
         void update_plasma(bool plasma);
         void update_beeper(bool beeper);
@@ -194,20 +314,36 @@ class SinclairAC : public Component, public uart::UARTDevice, public climate::Cl
         void update_save(bool save);
 
         void check_external_timeout();
+        /* Hands due schedule entries to control(), the clock is read once a second */
+        void update_schedule_();
+        void apply_schedule_entry_(const ScheduleEntry &entry);
+        void save_schedule_();
+        /* Fuses the external sensors and publishes the result when it moved by the deadband */
+        void update_external_temperature_(uint32_t now);
 
         void load_preferences_();
+        void load_legacy_preferences_();
+        void apply_saved_preferences_();
+        void save_fast_boot_state_();
+        bool restore_warm_state_();
+        void save_warm_state_();
+
+        /* Preference writes are skipped when the value matches the last saved/loaded one,
+           on ESP32 every save() queues a heap-allocated NVS write */
+        bool save_preference_(ESPPreferenceObject &pref, uint8_t &saved, uint8_t value);
+        bool save_preference_(ESPPreferenceObject &pref, uint8_t &saved, bool value);
 
         // Helper functions for mapping between string options and uint8_t indices
-        uint8_t display_index_from_string_(const std::string &s);
-        std::string display_string_from_index_(uint8_t i);
-        uint8_t display_unit_index_from_string_(const std::string &s);
-        std::string display_unit_string_from_index_(uint8_t i);
-        uint8_t vertical_swing_index_from_string_(const std::string &s);
-        std::string vertical_swing_string_from_index_(uint8_t i);
-        uint8_t horizontal_swing_index_from_string_(const std::string &s);
-        std::string horizontal_swing_string_from_index_(uint8_t i);
-        uint8_t temp_source_index_from_string_(const std::string &s);
-        std::string temp_source_string_from_index_(uint8_t i);
+        uint8_t display_index_from_string_(const char *s);
+        const char *display_string_from_index_(uint8_t i);
+        uint8_t display_unit_index_from_string_(const char *s);
+        const char *display_unit_string_from_index_(uint8_t i);
+        uint8_t vertical_swing_index_from_string_(const char *s);
+        const char *vertical_swing_string_from_index_(uint8_t i);
+        uint8_t horizontal_swing_index_from_string_(const char *s);
+        const char *horizontal_swing_string_from_index_(uint8_t i);
+        uint8_t temp_source_index_from_string_(const char *s);
+        const char *temp_source_string_from_index_(uint8_t i);
 
         // Preference keys (stable numeric keys)
         static constexpr uint32_t PREF_KEY_DISPLAY = 0x53414301;
@@ -221,6 +357,10 @@ class SinclairAC : public Component, public uart::UARTDevice, public climate::Cl
         static constexpr uint32_t PREF_KEY_XFAN = 0x53414309;
         static constexpr uint32_t PREF_KEY_SAVE = 0x5341430A;
         static constexpr uint32_t PREF_KEY_LAST_PACKET = 0x5341430B;
+        static constexpr uint32_t PREF_KEY_FAST_BOOT = 0x5341430C;
+        // 0x5341430D is the ESP8266 warm state, see esppac_warm.cpp
+        static constexpr uint32_t PREF_KEY_RUNTIME_STATS = 0x5341430E;
+        static constexpr uint32_t PREF_KEY_SCHEDULE = 0x5341430F;
 
         ESPPreferenceObject pref_display_;
         ESPPreferenceObject pref_display_unit_;
@@ -233,6 +373,19 @@ class SinclairAC : public Component, public uart::UARTDevice, public climate::Cl
         ESPPreferenceObject pref_xfan_;
         ESPPreferenceObject pref_save_;
         ESPPreferenceObject pref_last_packet_;
+        ESPPreferenceObject pref_fast_boot_;
+
+        static constexpr uint8_t PREF_NOT_SAVED = 0xFF;  /* Marks a preference cache that holds no value yet */
+        uint8_t saved_display_idx_ = PREF_NOT_SAVED;
+        uint8_t saved_display_unit_idx_ = PREF_NOT_SAVED;
+        uint8_t saved_vertical_swing_idx_ = PREF_NOT_SAVED;
+        uint8_t saved_horizontal_swing_idx_ = PREF_NOT_SAVED;
+        uint8_t saved_temp_source_idx_ = PREF_NOT_SAVED;
+        uint8_t saved_plasma_ = PREF_NOT_SAVED;
+        uint8_t saved_beeper_ = PREF_NOT_SAVED;
+        uint8_t saved_sleep_ = PREF_NOT_SAVED;
+        uint8_t saved_xfan_ = PREF_NOT_SAVED;
+        uint8_t saved_save_ = PREF_NOT_SAVED;
 
         virtual void on_horizontal_swing_change(const std::string &swing) = 0;
         virtual void on_vertical_swing_change(const std::string &swing) = 0;
@@ -249,7 +402,9 @@ class SinclairAC : public Component, public uart::UARTDevice, public climate::Cl
 
         climate::ClimateAction determine_action();
 
-        void log_packet(std::vector<uint8_t> data, bool outgoing = false);
+        void log_packet(const uint8_t *data, size_t len, bool outgoing = false);
+        /* Dotted hex into out, which holds at least DATA_MAX * 3 bytes, longer frames are cut */
+        static void format_frame_(const uint8_t *data, size_t len, char *out);
 };
 
 }  // namespace sinclair_ac
@@ -1,5 +1,7 @@
 // based on: https://github.com/DomiStyle/esphome-panasonic-ac
 #include "esppac_cnt.h"
+#include "esppac_codec.h"
+#include <algorithm>
 #include <cstring>
 
 namespace esphome {
@@ -14,125 +16,630 @@ void SinclairACCNT::setup()
     SinclairAC::setup();
     ESP_LOGD(TAG, "Using serial protocol for Sinclair AC");
 
-    // Отправь тестовый пакет при запуске
-    std::vector<uint8_t> test_packet = {0x7E, 0x7E, 0x0D, 0x04, 0x04, 0x00, 0x00, 0x00, 
-                                0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x00, 0x4D};
-    
-    ESP_LOGD(TAG, "Sending initial test packet");
-    write_array(test_packet);
+    // The bring-up frames go out from loop(), see send_handshake_()
+    this->session_ = ACSession::SendMac;
+    this->handshake_attempts_ = 0;
+
+    if (module_runs_link_())
+    {
+        this->module_process_.data.reserve(DATA_MAX);
+        this->module_process_.state = STATE_WAIT_SYNC;
+        if (this->sniffer_)
+            ESP_LOGI(TAG, "Sniffer mode, nothing is sent to the AC");
+        else
+            ESP_LOGI(TAG, "Bridge mode, forwarding between the WiFi module and the AC");
+    }
     
     // Initialize last packet preference
     this->pref_last_packet_ = global_preferences->make_preference<LastPacketPayload>(PREF_KEY_LAST_PACKET);
     
-    // Try to load last packet from NVS
-    if (this->pref_last_packet_.load(&this->last_packet_payload_)) {
+    // Try to load last packet, a warm restart or fast boot already read it with the rest of the state
+    if (this->warm_restored_ && this->warm_state_.has_last_packet) {
+        std::memcpy(this->last_packet_payload_.data, this->warm_state_.last_packet, protocol::SET_PACKET_LEN);
+        this->has_last_packet_ = true;
+        ESP_LOGD(TAG, "Loaded last update payload from RTC memory (45 bytes)");
+        if (this->fast_boot_) {
+            std::memcpy(this->fast_boot_state_.last_packet, this->last_packet_payload_.data, protocol::SET_PACKET_LEN);
+            this->fast_boot_state_.has_last_packet = true;
+        }
+    } else if (this->warm_restored_) {
+        this->has_last_packet_ = false;
+    } else if (this->fast_boot_loaded_ && this->fast_boot_state_.has_last_packet) {
+        std::memcpy(this->last_packet_payload_.data, this->fast_boot_state_.last_packet, protocol::SET_PACKET_LEN);
+        this->has_last_packet_ = true;
+        ESP_LOGD(TAG, "Loaded last update payload from fast boot state (45 bytes)");
+    } else if (!this->fast_boot_loaded_ && this->pref_last_packet_.load(&this->last_packet_payload_)) {
         this->has_last_packet_ = true;
         ESP_LOGD(TAG, "Loaded last update payload from NVS (45 bytes)");
+        if (this->fast_boot_) {
+            std::memcpy(this->fast_boot_state_.last_packet, this->last_packet_payload_.data, protocol::SET_PACKET_LEN);
+            this->fast_boot_state_.has_last_packet = true;
+        }
     } else {
         this->has_last_packet_ = false;
         ESP_LOGD(TAG, "No saved update payload found in NVS");
     }
     
-    Temrec0[0] = 15.5555555555556;
-    Temrec0[1] = 16.6666666666667;
-    Temrec0[2] = 17.7777777778;
-    Temrec0[3] = 18.8888888889;
-    Temrec0[4] = 20;
-    Temrec0[5] = 20.5555555556;
-    Temrec0[6] = 21.6666666667;
-    Temrec0[7] = 22.7777777778;
-    Temrec0[8] = 23.8888888889;
-    Temrec0[9] = 25;
-    Temrec0[10] =25.5555555556;
-    Temrec0[11] = 26.6666666667;
-    Temrec0[12] = 27.7777777778;
-    Temrec0[13] = 28.8888888889;
-    Temrec0[14] = 30;
-    Temrec0[15] = 30.5555555556;
-
-    Temrec1[0] = 16.1111111111111;
-    Temrec1[1] = 17.2222222222222;
-    Temrec1[2] = 18.3333333333333;
-    Temrec1[3] = 19.4444444444444;
-    Temrec1[4] = 0; //Can'thappen
-    Temrec1[5] = 21.1111111111;
-    Temrec1[6] = 22.2222222222222;
-    Temrec1[7] = 23.3333333333;
-    Temrec1[8] = 24.4444444444;
-    Temrec1[9] = 0; //Can't happen
-    Temrec1[10] = 26.1111111111111; 
-    Temrec1[11] = 27.2222222222222;
-    Temrec1[12] = 28.3333333333;
-    Temrec1[13] = 29.4444444444;
-    Temrec1[14] = 0; //Can't happen
-    Temrec1[15] = 31.1111111111111;
+    this->pref_runtime_stats_ = global_preferences->make_preference<RuntimeTotals>(PREF_KEY_RUNTIME_STATS);
+    RuntimeTotals totals{};
+    if (this->pref_runtime_stats_.load(&totals) && this->runtime_stats_.restore(totals))
+        ESP_LOGD(TAG, "Runtime statistics loaded, %u h powered on", (unsigned) (totals.power_on_s / 3600));
+    this->stats_saved_ = millis();
+
+    if (this->warm_restored_ && this->warm_state_.has_report)
+    {
+        restore_from_warm_report_();
+    }
+    else if (this->fast_boot_ && this->has_last_packet_ && !module_runs_link_())
+    {
+        restore_from_stored_packet_();
+    }
+}
+
+/*
+ * Warm restart: the AC kept running while we rebooted, decode the last report it sent
+ * and carry on as Ready without resending anything
+ */
+void SinclairACCNT::restore_from_warm_report_()
+{
+    /* the report holds the biased setpoint, carry on with the offset the AC runs with */
+    if (this->compensation_)
+    {
+        this->sent_offset_ = this->warm_state_.setpoint_offset;
+        this->confirmed_offset_ = this->warm_state_.setpoint_offset;
+        this->compensator_.restore(this->warm_state_.setpoint_offset, millis());
+    }
+
+    this->serialProcess_.data.assign(this->warm_state_.report, this->warm_state_.report + protocol::SET_PACKET_LEN);
+    for (uint8_t i = 0; i < 20; i++)
+        lastpacket[i] = this->warm_state_.report[i];
+    lastroomtemp = this->warm_state_.report[protocol::REPORT_TEMP_ACT_BYTE];
+
+    this->processUnitReport();
+
+    this->serialProcess_.data.clear();
+    this->serialProcess_.state = STATE_WAIT_SYNC;
+
+    this->state_ = ACState::Ready;
+    this->session_ = ACSession::Polling;  /* the AC already knows us */
+    this->last_packet_received_ = millis();
+    this->packet_resent_on_ready_ = true;  /* the AC did not lose power, nothing to restore */
+
+    this->publish_state();
+    ESP_LOGI(TAG, "Warm restart: state restored from RTC memory %u ms after boot", (unsigned) millis());
+}
+
+/*
+ * Decode the stored SET payload (same layout as a unit report) and publish it. Fast boot does
+ * this in setup() so HA shows the pre-outage state before the AC has said anything.
+ */
+void SinclairACCNT::restore_from_stored_packet_()
+{
+    load_stored_packet_();
+
+    this->publish_state();
+    ESP_LOGI(TAG, "Stored state published %u ms after boot", (unsigned) millis());
+}
+
+/* The climate fields from the stored SET payload, the selects and switches come from preferences */
+void SinclairACCNT::load_stored_packet_()
+{
+    this->serialProcess_.data.assign(this->last_packet_payload_.data,
+                                     this->last_packet_payload_.data + protocol::SET_PACKET_LEN);
+
+    this->mode = determine_mode();
+    this->custom_fan_mode_ = determine_fan_mode();
+    determine_display();  /* only for the internal display mode, the select was restored from preferences */
+
+    float target = determine_target_temperature();
+    if (target != 0)
+        this->update_target_temperature(target);
+
+    bool verticalFull = strcmp(determine_vertical_swing(), vertical_swing_options::FULL) == 0;
+    bool horizontalFull = strcmp(determine_horizontal_swing(), horizontal_swing_options::FULL) == 0;
+    if (verticalFull && horizontalFull)
+        this->swing_mode = climate::CLIMATE_SWING_BOTH;
+    else if (verticalFull)
+        this->swing_mode = climate::CLIMATE_SWING_VERTICAL;
+    else if (horizontalFull)
+        this->swing_mode = climate::CLIMATE_SWING_HORIZONTAL;
+    else
+        this->swing_mode = climate::CLIMATE_SWING_OFF;
+
+    this->serialProcess_.data.clear();
+    this->serialProcess_.state = STATE_WAIT_SYNC;
 }
 
 void SinclairACCNT::loop()
 {
+    SINCLAIR_PROFILE_STEADY_STATE();
+
+    if (module_runs_link_())
+    {
+        uint32_t waiting = this->available();
+        if (waiting > this->sniffer_stats_.unit_backlog_max)
+            this->sniffer_stats_.unit_backlog_max = waiting;
+
+        /* a byte that arrived right after the last read waited this long to be forwarded */
+        uint32_t now = millis();
+        if (this->bridge_ && waiting > 0 && now - this->bridge_last_read_ > this->bridge_stats_.unit_wait_max_ms)
+            this->bridge_stats_.unit_wait_max_ms = now - this->bridge_last_read_;
+        this->bridge_last_read_ = now;
+    }
+
     /* this reads data from UART */
     SinclairAC::loop();
 
+    if (module_runs_link_())
+    {
+        /* nothing waits for a slot on the line, take every frame both UARTs buffered since the last loop */
+        while (this->serialProcess_.state == STATE_COMPLETE)
+        {
+            handle_rx_frame_();
+            read_data();
+        }
+        read_module_data_();
+    }
     /* we have a frame from AC */
-    if (this->serialProcess_.state == STATE_COMPLETE)
+    else if (this->serialProcess_.state == STATE_COMPLETE && !handle_rx_frame_())
     {
-        /* do not forget to order for restart of the recieve state machine */
-        this->serialProcess_.state = STATE_RESTART;
-        /* mark that we have recieved a response */
-        this->wait_response_ = false;
-        /* log for ESPHome debug */
-        log_packet(this->serialProcess_.data);
+        return;
+    }
 
-        if (!verify_packet())  /* Verify length, header, counter and checksum */
+    /* we will send a packet to the AC as a reponse to indicate changes */
+    // Bring-up frames come first, then whatever lane wins the slot
+    if (module_runs_link_())
+    {
+        /* the module runs the link */
+    }
+    else if (this->session_ != ACSession::Polling)
+    {
+        send_handshake_();
+    }
+    else if (this->wait_response_)
+    {
+        check_response_deadline_();
+    }
+    else
+    {
+        service_tx_();
+    }
+
+    /* if there are no packets for 5 seconds - mark module as not ready */
+    if (millis() - this->last_packet_received_ >= protocol::TIME_TIMEOUT_INACTIVE_MS)
+    {
+        if (this->state_ != ACState::Initializing)
         {
-            ESP_LOGD(TAG, "PACKET DROPPED");
-            return;
+            this->link_.link_losses++;
+            if (this->reports_since_ready_ <= 1)
+                this->link_.false_ready++;
+            this->state_ = ACState::Initializing;
+            Component::status_set_error();
+            /* the AC may have restarted, introduce ourselves again */
+            this->session_ = ACSession::SendMac;
+        }
+        else if (this->session_ == ACSession::Polling &&
+                 millis() - this->handshake_frame_sent_ >= protocol::TIME_HANDSHAKE_RETRY_MS)
+        {
+            ESP_LOGD(TAG, "No report after link bring-up, starting over");
+            this->session_ = ACSession::SendMac;
         }
+    }
+
+    update_runtime_stats_();
+    update_compensation_();
+}
+
+bool SinclairACCNT::handle_rx_frame_()
+{
+    /* do not forget to order for restart of the recieve state machine */
+    this->serialProcess_.state = STATE_RESTART;
+    /* log for ESPHome debug */
+    log_packet(this->serialProcess_.data.data(), this->serialProcess_.data.size());
+    /* User hooks see every frame, including the ones verify_packet() drops */
+    notify_frame_(this->serialProcess_.data.data(), this->serialProcess_.data.size(), false, this->last_rx_byte_);
+
+    FrameKind kind = verify_packet();  /* Verify length, command and checksum */
+    if (kind == FRAME_DROP)
+    {
+        ESP_LOGD(TAG, "PACKET DROPPED");
+        return false;
+    }
 
-        this->last_packet_received_ = millis();  /* Set the time at which we received our last packet */
+    /* mark that we have recieved a response, a damaged one leaves the retransmit deadline running */
+    if (kind == FRAME_UNIT_REPORT)
+        this->wait_response_ = false;
+    (this->*FRAME_HANDLERS[kind])();
+    return true;
+}
 
-        /* A valid recieved packet of accepted type marks module as being ready */
-        if (this->state_ != ACState::Ready)
+/*
+ * Sniffer: the module side is framed like the unit side, every complete frame is handled
+ * at once so a busy line never backs up in the UART buffer
+ */
+void SinclairACCNT::read_module_data_()
+{
+    uint32_t waiting = this->module_uart_->available();
+    if (waiting > this->sniffer_stats_.module_backlog_max)
+        this->sniffer_stats_.module_backlog_max = waiting;
+
+    uint8_t buf[32];
+    while (waiting > 0)
+    {
+        size_t len = std::min<size_t>(waiting, sizeof(buf));
+        if (!this->module_uart_->read_array(buf, len))
+            break;
+        this->module_last_byte_ = millis();
+        for (size_t i = 0; i < len; i++)
         {
-            this->state_ = ACState::Ready;  
-            Component::status_clear_error();
-            this->last_packet_sent_ = millis();
-            
-            // Auto-resend last packet on AC becoming Ready (only once per boot)
-            if (this->has_last_packet_ && !this->packet_resent_on_ready_) {
-                ESP_LOGI(TAG, "AC became Ready - will resend last stored packet");
-                this->packet_resent_on_ready_ = true;
-                this->pending_stored_packet_resend_ = true;
+            bool started = this->module_process_.state == STATE_RECIEVE;
+            bool complete = frame_byte_(this->module_process_, buf[i]);
+            if (!started && this->module_process_.state == STATE_RECIEVE)
+                this->module_frame_start_ = this->module_last_byte_;
+            if (complete)
+            {
+                handle_module_frame_();
+                this->module_process_.state = STATE_RESTART;
             }
         }
+        waiting = this->module_uart_->available();
+    }
+
+    if (this->module_process_.state == STATE_RECIEVE && millis() - this->module_last_byte_ >= READ_TIMEOUT)
+    {
+        ESP_LOGD(TAG, "Dropping truncated module frame (%u bytes)", (unsigned) this->module_process_.data.size());
+        /* the unit gets to see it as cut short as it would without us */
+        if (this->bridge_)
+            bridge_forward_(this->module_process_.data.data(), this->module_process_.data.size());
+        this->module_process_.data.clear();
+        this->module_process_.state = STATE_WAIT_SYNC;
+        this->sniffer_stats_.truncated++;
+    }
+}
+
+void SinclairACCNT::handle_module_frame_()
+{
+    static const char *const MODE_NAMES[] = {"auto", "cool", "dry", "fan", "heat"};
+
+    const uint8_t *frame = this->module_process_.data.data();
+    size_t len = this->module_process_.data.size();
+    SnifferStats &stats = this->sniffer_stats_;
 
-        if (this->update_ == ACUpdate::NoUpdate)
+    /* a bridge logs and hands on what it forwards to the unit */
+    if (!this->bridge_)
+    {
+        log_packet(frame, len, true);
+        notify_frame_(frame, len, true, this->module_last_byte_);
+    }
+    stats.frames++;
+
+    if (len < protocol::FRAME_OVERHEAD || protocol::frame_checksum(frame, len) != frame[len - 1])
+    {
+        ESP_LOGD(TAG, "Invalid module frame (length or checksum)");
+        stats.bad++;
+        if (this->bridge_)
+            bridge_forward_(frame, len);
+        return;
+    }
+
+    const uint8_t *payload = frame + protocol::FRAME_HEADER_LEN;
+    switch (frame[3])
+    {
+        case protocol::CMD_OUT_PARAMS_SET:
         {
-            handle_packet(); /* this will update state of components in HA as well as internal settings */
+            if (len - protocol::FRAME_OVERHEAD != protocol::SET_PACKET_LEN)
+            {
+                ESP_LOGD(TAG, "Invalid module frame (SET of %u bytes)", (unsigned) len);
+                stats.bad++;
+                break;
+            }
+            stats.sets++;
+            /* the unit takes the payload when the no-change bit is clear or the 0xAF marker is set */
+            bool nochange = payload[protocol::SET_NOCHANGE_BYTE] & protocol::SET_NOCHANGE_MASK;
+            bool update = !nochange || payload[protocol::SET_AF_BYTE] == protocol::SET_AF_VAL;
+            if (update)
+            {
+                stats.updates++;
+                uint8_t mode = codec::decode_mode(payload);
+                uint8_t fan = codec::decode_fan_mode(payload);
+                uint8_t vertical = codec::decode_vertical_swing(payload);
+                uint8_t horizontal = codec::decode_horizontal_swing(payload);
+                ESP_LOGD(TAG, "Module SET: power=%s mode=%s target=%.1f fan=%s vertical=%s horizontal=%s",
+                         codec::decode_power(payload) ? "on" : "off",
+                         mode <= protocol::REPORT_MODE_HEAT ? MODE_NAMES[mode] : "?",
+                         codec::decode_target_temperature(payload),
+                         fan < FAN_MODE_OPTIONS_COUNT ? FAN_MODE_OPTIONS[fan] : "?",
+                         vertical < VERTICAL_SWING_OPTIONS_COUNT ? VERTICAL_SWING_OPTIONS[vertical] : "?",
+                         horizontal < HORIZONTAL_SWING_OPTIONS_COUNT ? HORIZONTAL_SWING_OPTIONS[horizontal] : "?");
+            }
+            if (this->bridge_)
+            {
+                bridge_set_(frame, len, update);
+                return;
+            }
+            break;
         }
+        case protocol::CMD_OUT_MAC_REPORT:
+        case protocol::CMD_OUT_UNKNOWN_1:
+            stats.handshakes++;
+            ESP_LOGD(TAG, "Module link bring-up frame [%02X]", frame[3]);
+            break;
+        default:
+            stats.other++;
+            break;
     }
 
-    /* we will send a packet to the AC as a reponse to indicate changes */
-    // Check if we need to send the stored packet first
-    if (this->pending_stored_packet_resend_)
+    if (this->bridge_)
+        bridge_forward_(frame, len);
+}
+
+void SinclairACCNT::bridge_forward_(const uint8_t *frame, size_t len)
+{
+    write_frame_(frame, len);
+
+    BridgeStats &stats = this->bridge_stats_;
+    uint32_t latency = millis() - this->module_frame_start_;
+    stats.module_frames++;
+    stats.module_latency_last_ms = latency;
+    stats.module_latency_total_ms += latency;
+    if (latency > stats.module_latency_max_ms)
+        stats.module_latency_max_ms = latency;
+}
+
+/*
+ * Bridge: a pending update of ours replaces the module's next SET, the same way send_packet()
+ * would have sent it, 0xAF and no-change bit included. A SET that carries the module's own update
+ * goes through untouched and ours follows with the next one, so the later command wins.
+ */
+void SinclairACCNT::bridge_set_(const uint8_t *frame, size_t len, bool module_update)
+{
+    if (this->update_ == ACUpdate::NoUpdate)
     {
-        this->pending_stored_packet_resend_ = false;
-        send_stored_packet_();
+        bridge_forward_(frame, len);
+        return;
     }
-    else
+    if (module_update)
     {
-        send_packet();
+        ESP_LOGD(TAG, "Module SET carries an update, ours follows with the next one");
+        this->bridge_stats_.deferred++;
+        bridge_forward_(frame, len);
+        return;
     }
 
-    /* if there are no packets for 5 seconds - mark module as not ready */
-    if (millis() - this->last_packet_received_ >= protocol::TIME_TIMEOUT_INACTIVE_MS)
+    bool user_start = this->update_ == ACUpdate::UpdateStart;
+    uint8_t packet[protocol::SET_PACKET_LEN];
+    build_set_payload_(packet);
+    uint8_t out[protocol::FRAME_MAX_LEN];
+    uint8_t out_len = build_frame_(protocol::CMD_OUT_PARAMS_SET, packet, protocol::SET_PACKET_LEN, out);
+    bridge_forward_(out, out_len);
+    advance_update_();
+
+    this->bridge_stats_.injected++;
+    /* the 0xAF frame is the one that applies the command, the follow-up is bookkeeping */
+    if (user_start)
+        complete_tx_(TxLane::User);
+}
+
+void SinclairACCNT::log_sniffer_stats()
+{
+    if (!module_runs_link_())
     {
-        if (this->state_ != ACState::Initializing)
-        {
-            this->state_ = ACState::Initializing;
-            Component::status_set_error();
+        ESP_LOGI(TAG, "Not in sniffer or bridge mode");
+        return;
+    }
+
+    const SnifferStats &stats = this->sniffer_stats_;
+    ESP_LOGI(TAG, "Sniffer module frames=%u bad=%u truncated=%u sets=%u updates=%u bring-up=%u other=%u",
+             (unsigned) stats.frames, (unsigned) stats.bad, (unsigned) stats.truncated, (unsigned) stats.sets,
+             (unsigned) stats.updates, (unsigned) stats.handshakes, (unsigned) stats.other);
+    ESP_LOGI(TAG, "Sniffer backlog max unit=%u module=%u bytes", (unsigned) stats.unit_backlog_max,
+             (unsigned) stats.module_backlog_max);
+}
+
+void SinclairACCNT::log_bridge_stats()
+{
+    if (!this->bridge_)
+    {
+        ESP_LOGI(TAG, "Not in bridge mode");
+        return;
+    }
+
+    const BridgeStats &stats = this->bridge_stats_;
+    ESP_LOGI(TAG, "Bridge module frames=%u injected=%u deferred=%u latency last=%u max=%u avg=%u ms",
+             (unsigned) stats.module_frames, (unsigned) stats.injected, (unsigned) stats.deferred,
+             (unsigned) stats.module_latency_last_ms, (unsigned) stats.module_latency_max_ms,
+             (unsigned) (stats.module_frames ? stats.module_latency_total_ms / stats.module_frames : 0));
+    ESP_LOGI(TAG, "Bridge unit bytes waited max=%u ms", (unsigned) stats.unit_wait_max_ms);
+    log_sniffer_stats();
+}
+
+/*
+ * Frame handlers, one per FrameKind
+ */
+const SinclairACCNT::FrameHandler SinclairACCNT::FRAME_HANDLERS[FRAME_KIND_COUNT] = {
+    nullptr,  /* FRAME_DROP never gets past verify_packet() */
+    &SinclairACCNT::handle_unit_report_frame_,
+    &SinclairACCNT::handle_telemetry_frame_,
+};
+
+void SinclairACCNT::handle_unit_report_frame_()
+{
+    this->last_packet_received_ = millis();  /* Set the time at which we received our last packet */
+
+    /* A valid recieved packet of accepted type marks module as being ready */
+    this->reports_since_ready_++;
+    if (this->state_ != ACState::Ready)
+    {
+        this->link_.ready_transitions++;
+        this->reports_since_ready_ = 1;
+        this->state_ = ACState::Ready;  
+        Component::status_clear_error();
+        this->last_packet_sent_ = millis();
+
+        if (this->handshake_attempts_ > 0) {
+            ESP_LOGI(TAG, "First report %u ms after link bring-up started (%u attempts)",
+                     (unsigned) (millis() - this->handshake_started_), this->handshake_attempts_);
+            this->handshake_attempts_ = 0;
+        }
+        this->session_ = ACSession::Polling;
+        
+        if (this->fast_boot_ && this->update_ != ACUpdate::NoUpdate) {
+            /* Commands queued while the link was down already carry the restored state,
+               they take priority over the stored packet and go out in the first free slot */
+            ESP_LOGI(TAG, "AC became Ready %u ms after boot - sending queued command", (unsigned) millis());
+            this->packet_resent_on_ready_ = true;
+        }
+        // Auto-resend last packet on AC becoming Ready (only once per boot), the sniffer only listens
+        else if (this->has_last_packet_ && !this->packet_resent_on_ready_ && !module_runs_link_()) {
+            ESP_LOGI(TAG, "AC became Ready %u ms after boot - will resend last stored packet", (unsigned) millis());
+            this->packet_resent_on_ready_ = true;
+            request_tx_(TxLane::Recovery);
+            /* this report holds the AC's power-on defaults and is not published, the reply to the
+               resend is. Fast boot already shows the stored state, without it the fields take it
+               on unpublished, so a command that supersedes the resend still builds on it. */
+            if (!this->fast_boot_)
+                load_stored_packet_();
         }
     }
+
+    confirm_commands_();
+
+    bool restoring = this->tx_lanes_[static_cast<uint8_t>(TxLane::Recovery)].depth > 0 && this->has_last_packet_;
+    if (this->update_ == ACUpdate::NoUpdate && !restoring)
+    {
+        handle_packet(); /* this will update state of components in HA as well as internal settings */
+    }
+}
+
+/*
+ * Telemetry: fields are read in place from the receive buffer, only the sensors of this
+ * command are looked at and a sensor is published only when its raw field changed
+ */
+void SinclairACCNT::handle_telemetry_frame_()
+{
+    const uint8_t *frame = this->serialProcess_.data.data();
+    uint8_t command = frame[3];
+    size_t payload_len = this->serialProcess_.data.size() - protocol::FRAME_HEADER_LEN - 1;  /* without checksum */
+
+    for (TelemetryField &field : this->telemetry_)
+    {
+        if (field.command != command || field.byte >= payload_len)
+            continue;
+
+        uint8_t raw = (frame[protocol::FRAME_HEADER_LEN + field.byte] & field.mask) >> field.shift;
+        if (raw == field.last)
+            continue;
+        field.last = raw;
+        field.sensor->publish_state(raw * field.multiply + field.offset);
+    }
+}
+
+void SinclairACCNT::add_telemetry_sensor(sensor::Sensor *sens, uint8_t command, uint8_t byte, uint8_t mask,
+                                         float multiply, float offset)
+{
+    if (FRAME_KINDS.kind[command] != FRAME_TELEMETRY || mask == 0)
+    {
+        ESP_LOGW(TAG, "Telemetry sensor on command %02X ignored, it is not a telemetry frame", command);
+        return;
+    }
+
+    uint8_t shift = 0;
+    while (!(mask & (1u << shift)))
+        shift++;
+    this->telemetry_.push_back(TelemetryField{sens, command, byte, mask, shift, multiply, offset, -1});
+
+    if (!telemetry_wanted_(command))
+    {
+        if (this->telemetry_commands_[0] == 0)
+            this->telemetry_commands_[0] = command;
+        else
+            this->telemetry_commands_[1] = command;
+    }
+}
+
+/*
+ * Runtime statistics: totals are written behind every STATS_SAVE_INTERVAL_MS and on shutdown,
+ * sensors are published every stats_update_interval_
+ */
+void SinclairACCNT::update_runtime_stats_()
+{
+    uint32_t now = millis();
+
+    if (this->runtime_stats_.dirty() && now - this->stats_saved_ >= STATS_SAVE_INTERVAL_MS)
+        save_runtime_stats_();
+
+    if (now - this->stats_published_ < this->stats_update_interval_)
+        return;
+    this->stats_published_ = now;
+
+    const RuntimeStats &stats = this->runtime_stats_;
+    if (this->power_on_hours_sensor_ != nullptr)
+        this->power_on_hours_sensor_->publish_state(stats.power_on_hours());
+    if (this->setpoint_changes_sensor_ != nullptr)
+        this->setpoint_changes_sensor_->publish_state(stats.setpoint_changes_per_day());
+    if (this->time_to_setpoint_sensor_ != nullptr)
+        this->time_to_setpoint_sensor_->publish_state(stats.time_to_setpoint());
+    for (uint8_t i = 0; i < STATS_MODE_COUNT; i++)
+        if (this->mode_hours_sensors_[i] != nullptr)
+            this->mode_hours_sensors_[i]->publish_state(stats.mode_hours(i));
+    for (uint8_t i = 0; i < STATS_FAN_COUNT; i++)
+        if (this->fan_hours_sensors_[i] != nullptr)
+            this->fan_hours_sensors_[i]->publish_state(stats.fan_hours(i));
+}
+
+void SinclairACCNT::save_runtime_stats_()
+{
+    SINCLAIR_PROFILE_SCOPE(PROF_PREF_SAVE);
+    this->pref_runtime_stats_.save(&this->runtime_stats_.totals());
+    this->runtime_stats_.clear_dirty();
+    this->stats_saved_ = millis();
+}
+
+void SinclairACCNT::on_shutdown()
+{
+    /* OTA and reboots from HA end up here, keep what accumulated since the last write-behind */
+    if (this->runtime_stats_.dirty())
+        save_runtime_stats_();
+}
+
+/*
+ * Setpoint compensation: runs while the external sensor is in charge and the AC regulates
+ * towards a setpoint, send_packet() adds the offset to the target temperature
+ */
+void SinclairACCNT::update_compensation_()
+{
+    if (!this->compensation_ || this->state_ != ACState::Ready)
+        return;
+
+    bool regulating = this->mode == climate::CLIMATE_MODE_COOL || this->mode == climate::CLIMATE_MODE_HEAT ||
+                      this->mode == climate::CLIMATE_MODE_HEAT_COOL || this->mode == climate::CLIMATE_MODE_AUTO;
+    bool active = regulating && this->temp_source_state_ == temp_source_options::EXTERNAL_ATC &&
+                  !this->atc_failed_ && this->external_fusion_.fresh_count() > 0 &&
+                  !std::isnan(this->current_temperature);
+
+    bool changed;
+    if (active)
+    {
+        int8_t base = static_cast<int8_t>(round(this->target_temperature));
+        changed = this->compensator_.update(this->target_temperature, this->current_temperature,
+                                            MIN_TEMPERATURE - base, MAX_TEMPERATURE - base, millis());
+    }
+    else
+    {
+        changed = this->compensator_.reset();
+    }
+
+    if (changed)
+    {
+        ESP_LOGD(TAG, "Setpoint offset %+d (controller output %.2f)", this->compensator_.offset(),
+                 this->compensator_.output());
+        if (this->compensation_offset_sensor_ != nullptr)
+            this->compensation_offset_sensor_->publish_state(this->compensator_.offset());
+    }
+
+    /* also covers a resend of the stored packet, which goes out without an offset */
+    if (this->compensator_.offset() != this->sent_offset_ && this->update_ == ACUpdate::NoUpdate)
+        request_user_update_();
 }
 
 /*
@@ -142,7 +649,8 @@ void SinclairACCNT::loop()
 void SinclairACCNT::control(const climate::ClimateCall &call)
 {
     ESP_LOGD(TAG, "CONTROL CALLED! state_=%d", (int)this->state_);
-    if (this->state_ != ACState::Ready)
+    bool queued = this->state_ != ACState::Ready;
+    if (!accept_command_())
     {
         ESP_LOGD(TAG, "CONTROL BLOCKED! state != Ready");
         return;
@@ -151,14 +659,14 @@ void SinclairACCNT::control(const climate::ClimateCall &call)
     {
         ESP_LOGV(TAG, "Requested mode change");
         reqmodechange = true;
-        this->update_ = ACUpdate::UpdateStart;
+        request_user_update_();
         this->mode = *call.get_mode();
     }
 
     if (call.get_target_temperature().has_value())
     {
         ESP_LOGV(TAG, "Requested target teperature change");
-        this->update_ = ACUpdate::UpdateStart;
+        request_user_update_();
         this->target_temperature = *call.get_target_temperature();
         if (this->target_temperature < MIN_TEMPERATURE)
         {
@@ -172,11 +680,16 @@ void SinclairACCNT::control(const climate::ClimateCall &call)
 
     if (call.has_custom_fan_mode()) {
         const char* fan_mode = call.get_custom_fan_mode();
-        if (fan_mode != nullptr) {
+        /* Home Assistant and the schedule send the CUSTOM_FAN_MODES names, the SET encoder
+           and the report compare work on FAN_MODE_OPTIONS */
+        uint8_t fan = codec::fan_mode_index(fan_mode);
+        if (fan < FAN_MODE_OPTIONS_COUNT) {
             ESP_LOGV(TAG, "Requested fan mode change");
             reqmodechange = true;
-            this->update_ = ACUpdate::UpdateStart;
-            this->custom_fan_mode_ = fan_mode;  // Сохранить режим в поле класса
+            request_user_update_();
+            this->custom_fan_mode_ = FAN_MODE_OPTIONS[fan];  // Сохранить режим в поле класса
+        } else if (fan_mode != nullptr) {
+            ESP_LOGW(TAG, "Unknown fan mode %s", fan_mode);
         }
     }
 
@@ -185,7 +698,7 @@ void SinclairACCNT::control(const climate::ClimateCall &call)
     {
         ESP_LOGV(TAG, "Requested swing mode change");
         reqmodechange = true;
-        this->update_ = ACUpdate::UpdateStart;
+        request_user_update_();
         switch (*call.get_swing_mode()) {
             case climate::CLIMATE_SWING_BOTH:
                 this->vertical_swing_state_   =   vertical_swing_options::FULL;
@@ -214,456 +727,462 @@ void SinclairACCNT::control(const climate::ClimateCall &call)
                 break;
         }
     }
+
+    if (queued)
+    {
+        /* no report will confirm it until the link is up, show the requested state now */
+        ESP_LOGD(TAG, "AC not Ready, command queued");
+        this->publish_state();
+    }
 }
 
 /*
- * Send a raw packet, as is
+ * WiFi module bring-up: MAC report followed by the 0x02 frame, one frame per call
  */
-void SinclairACCNT::send_packet()
+void SinclairACCNT::send_handshake_()
 {
-    std::vector<uint8_t> packet(protocol::SET_PACKET_LEN, 0);  /* Initialize packet contents */
-
-    // When ignore_ready_check_ is enabled and the AC is not Ready, allow a send
-    // attempt even if we are waiting for response. This helps to emit TX
-    // frames for debugging or when the AC isn't yet responding. Still respect
-    // the refresh period in general to avoid spamming the bus.
-    ESP_LOGD(TAG, "send_packet():wait=%d time=%lu", this->wait_response_,millis()-this->last_packet_sent_);
-    if (this->wait_response_ == true || (millis() - this->last_packet_sent_ < protocol::TIME_REFRESH_PERIOD_MS))
-    {
-        /* do not send packet too often or when we are waiting for report to come */
-        ESP_LOGD(TAG, "send_packet() BLOCKED");
+    if (millis() - this->handshake_frame_sent_ < protocol::TIME_HANDSHAKE_GAP_MS || !tx_slot_open_())
         return;
-    }
-    
-    packet[protocol::SET_CONST_02_BYTE] = protocol::SET_CONST_02_VAL; /* Some always 0x02 byte... */
-    packet[protocol::SET_CONST_BIT_BYTE] = protocol::SET_CONST_BIT_MASK; /* Some always true bit */
 
-    /* Prepare the rest of the frame */
-    /* this handles tricky part of 0xAF value and flag marking that WiFi does not apply any changes */
-    switch(this->update_)
-    {
-        default:
-        case ACUpdate::NoUpdate:
-            packet[protocol::SET_NOCHANGE_BYTE] |= protocol::SET_NOCHANGE_MASK;
-            break;
-        case ACUpdate::UpdateStart:
-            packet[protocol::SET_AF_BYTE] = protocol::SET_AF_VAL;
-            break;
-        case ACUpdate::UpdateClear:
-            break;
-    }
+    uint8_t frame[protocol::FRAME_MAX_LEN];
+    uint8_t frame_len = 0;
 
-    /* MODE and POWER --------------------------------------------------------------------------- */
-    uint8_t mode = protocol::REPORT_MODE_AUTO;
-    bool power = false;
-    switch (this->mode)
+    switch (this->session_)
     {
-        case climate::CLIMATE_MODE_AUTO:
-            mode = protocol::REPORT_MODE_AUTO;
-            power = true;
-            break;
-        case climate::CLIMATE_MODE_COOL:
-            mode = protocol::REPORT_MODE_COOL;
-            power = true;
-            break;
-        case climate::CLIMATE_MODE_DRY:
-            mode = protocol::REPORT_MODE_DRY;
-            power = true;
-            break;
-        case climate::CLIMATE_MODE_FAN_ONLY:
-            mode = protocol::REPORT_MODE_FAN;
-            power = true;
-            break;
-        case climate::CLIMATE_MODE_HEAT:
-            mode = protocol::REPORT_MODE_HEAT;
-            power = true;
+        case ACSession::SendMac:
+        {
+            uint8_t payload[protocol::MAC_REPORT_LEN] = {0};
+            payload[protocol::MAC_REPORT_TYPE_BYTE] = protocol::MAC_REPORT_TYPE_VAL;
+            get_mac_address_raw(payload + protocol::MAC_REPORT_MAC_BYTE);
+            frame_len = build_frame_(protocol::CMD_OUT_MAC_REPORT, payload, protocol::MAC_REPORT_LEN, frame);
+
+            if (this->handshake_attempts_ == 0)
+                this->handshake_started_ = millis();
+            this->handshake_attempts_++;
+            ESP_LOGD(TAG, "Link bring-up attempt %u: MAC report", this->handshake_attempts_);
+            this->session_ = ACSession::SendUnknown1;
             break;
-        case climate::CLIMATE_MODE_HEAT_COOL:
-            /* HEAT_COOL mode - treat as AUTO */
-            mode = protocol::REPORT_MODE_AUTO;
-            power = true;
+        }
+        case ACSession::SendUnknown1:
+            frame_len = build_frame_(protocol::CMD_OUT_UNKNOWN_1, protocol::UNKNOWN_1_PAYLOAD,
+                                     sizeof(protocol::UNKNOWN_1_PAYLOAD), frame);
+            /* a SET poll still waiting from before the restart will not be answered anymore */
+            this->wait_response_ = false;
+            this->session_ = ACSession::Polling;
+            /* first poll one gap later instead of a full refresh period */
+            this->last_packet_sent_ = millis() - (protocol::TIME_REFRESH_PERIOD_MS - protocol::TIME_HANDSHAKE_GAP_MS);
             break;
         default:
-        case climate::CLIMATE_MODE_OFF:
-            /* In case of MODE_OFF we will not alter the last mode setting recieved from AC, see determine_mode() */
-            switch (this->mode_internal_)
-            {
-                case climate::CLIMATE_MODE_AUTO:
-                    mode = protocol::REPORT_MODE_AUTO;
-                    break;
-                case climate::CLIMATE_MODE_COOL:
-                    mode = protocol::REPORT_MODE_COOL;
-                    break;
-                case climate::CLIMATE_MODE_DRY:
-                    mode = protocol::REPORT_MODE_DRY;
-                    break;
-                case climate::CLIMATE_MODE_FAN_ONLY:
-                    mode = protocol::REPORT_MODE_FAN;
-                    break;
-                case climate::CLIMATE_MODE_HEAT:
-                    mode = protocol::REPORT_MODE_HEAT;
-                    break;
-                case climate::CLIMATE_MODE_HEAT_COOL:
-                    /* HEAT_COOL in internal mode - treat as AUTO */
-                    mode = protocol::REPORT_MODE_AUTO;
-                    break;
-                case climate::CLIMATE_MODE_OFF:
-                    /* OFF in internal mode - default to AUTO */
-                    mode = protocol::REPORT_MODE_AUTO;
-                    break;
-            }
-            power = false;
-            break;
+            return;
     }
 
-    packet[protocol::REPORT_MODE_BYTE] |= (mode << protocol::REPORT_MODE_POS);
-    if (power)
+    this->handshake_frame_sent_ = millis();
+    write_frame_(frame, frame_len);
+}
+
+/*
+ * TX lanes: every frame that expects a report competes for the same slot, the lane with the
+ * lowest TxLane value gets it. User changes are built from the current state, so they also
+ * carry what an older recovery resend would have restored.
+ */
+void SinclairACCNT::request_tx_(TxLane lane)
+{
+    if (this->sniffer_)
     {
-        packet[protocol::REPORT_PWR_BYTE] |= protocol::REPORT_PWR_MASK;
+        ESP_LOGW(TAG, "Sniffer mode, frame not sent");
+        return;
     }
-
-    /* TARGET TEMPERATURE --------------------------------------------------------------------------- */
-    uint8_t temptemp = static_cast<uint8_t>(round(this->target_temperature));
-    uint8_t target_temperature = ((temptemp - protocol::REPORT_TEMP_SET_OFF) << protocol::REPORT_TEMP_SET_POS);
-    packet[protocol::REPORT_TEMP_SET_BYTE] |= (target_temperature & protocol::REPORT_TEMP_SET_MASK);
-
-    if (this->target_temperature - (float)temptemp > 0)
+    /* a bridge only sends our state in place of a module SET */
+    if (this->bridge_ && lane != TxLane::User)
     {
-         packet[protocol::REPORT_DISP_F_BYTE] |= protocol::TEMREC_MASK;
+        ESP_LOGW(TAG, "Bridge mode, the module runs the link, frame not sent");
+        return;
     }
 
-    /* FAN SPEED --------------------------------------------------------------------------- */
-    /* below will default to AUTO */
-    uint8_t fanSpeed1 = 0;
-    uint8_t fanSpeed2 = 0;
-    bool    fanQuiet  = false;
-    bool    fanTurbo  = false;
+    uint8_t i = static_cast<uint8_t>(lane);
+    TxLaneStats &stats = this->tx_lanes_[i];
 
-    if (this->custom_fan_mode_ == fan_modes::FAN_AUTO)
-    {
-        fanSpeed1 = 0;
-        fanSpeed2 = 0;
-        fanQuiet  = false;
-        fanTurbo  = false;
-    }
-    else if (this->custom_fan_mode_ == fan_modes::FAN_QUIET)
-    {
-        fanSpeed1 = 1;
-        fanSpeed2 = 1;
-        fanQuiet  = true;
-        fanTurbo  = false;
-        packet[protocol::REPORT_FAN_SPD2_BYTE] |= 1;
-    }
-    else if (this->custom_fan_mode_ == fan_modes::FAN_LOW)
-    {
-        fanSpeed1 = 1;
-        fanSpeed2 = 1;
-        fanQuiet  = false;
-        fanTurbo  = false;
-        packet[protocol::REPORT_FAN_SPD2_BYTE] |= 1;
-    }
-    else if (this->custom_fan_mode_ == fan_modes::FAN_MEDL)
-    {
-        fanSpeed1 = 2;
-        fanSpeed2 = 2;
-        fanQuiet  = false;
-        fanTurbo  = false;
-        packet[protocol::REPORT_FAN_SPD2_BYTE] |= 2;
-    }
-    else if (this->custom_fan_mode_ == fan_modes::FAN_MED)
-    {
-        fanSpeed1 = 3;
-        fanSpeed2 = 2;
-        fanQuiet  = false;
-        fanTurbo  = false;
-        packet[protocol::REPORT_FAN_SPD2_BYTE] |= 2;
-    }
-    else if (this->custom_fan_mode_ == fan_modes::FAN_MEDH)
-    {
-        fanSpeed1 = 4;
-        fanSpeed2 = 3;
-        fanQuiet  = false;
-        fanTurbo  = false;
-        packet[protocol::REPORT_FAN_SPD2_BYTE] |= 3;
-    }
-    else if (this->custom_fan_mode_ == fan_modes::FAN_HIGH)
-    {
-        fanSpeed1 = 5;
-        fanSpeed2 = 3;
-        fanQuiet  = false;
-        fanTurbo  = false;
-        packet[protocol::REPORT_FAN_SPD2_BYTE] |= 3;
-    }
-    else if (this->custom_fan_mode_ == fan_modes::FAN_TURBO)
-    {
-        fanSpeed1 = 5;
-        fanSpeed2 = 3;
-        fanQuiet  = false;
-        fanTurbo  = true;
-        packet[protocol::REPORT_FAN_SPD2_BYTE] |= 3;
-    }
+    stats.requested++;
+    if (stats.depth == 0)
+        this->tx_pending_since_[i] = millis();
     else
-    {
-        fanSpeed1 = 0;
-        fanSpeed2 = 0;
-        fanQuiet  = false;
-        fanTurbo  = false;
-    }
+        stats.coalesced++;
+    if (stats.depth < UINT8_MAX)
+        stats.depth++;
+    if (stats.depth > stats.max_depth)
+        stats.max_depth = stats.depth;
+}
 
-    // packet[protocol::REPORT_FAN_SPD1_BYTE] |= (fanSpeed1 << protocol::REPORT_FAN_SPD1_POS);
-    // packet[protocol::REPORT_FAN_SPD2_BYTE] |= (fanSpeed2 << protocol::REPORT_FAN_SPD2_POS);
-    
-   
-    
-    if (fanTurbo)
-    {
-        packet[protocol::REPORT_FAN_TURBO_BYTE] |= protocol::REPORT_FAN_TURBO_MASK;
-    }
-    if (fanQuiet)
-    {
-        packet[protocol::REPORT_FAN_QUIET_BYTE] |= protocol::REPORT_FAN_QUIET_MASK;
-    }
+void SinclairACCNT::request_user_update_()
+{
+    if (this->sniffer_)
+        return;
+    this->update_ = ACUpdate::UpdateStart;
+    request_tx_(TxLane::User);
+}
 
-    /* VERTICAL SWING --------------------------------------------------------------------------- */
-    uint8_t mode_vertical_swing = protocol::REPORT_VSWING_OFF;
-    if (this->vertical_swing_state_ == vertical_swing_options::OFF)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_OFF;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::FULL)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_FULL;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::DOWN)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_DOWN;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::MIDD)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_MIDD;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::MID)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_MID;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::MIDU)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_MIDU;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::UP)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_UP;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::CDOWN)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_CDOWN;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::CMIDD)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_CMIDD;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::CMID)
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_CMID;
-    }
-    else if (this->vertical_swing_state_ == vertical_swing_options::CMIDU)
+bool SinclairACCNT::accept_command_()
+{
+    if (this->sniffer_)
     {
-        mode_vertical_swing = protocol::REPORT_VSWING_CMIDU;
+        ESP_LOGW(TAG, "Sniffer mode, command ignored");
+        this->commands_.dropped++;
+        return false;
     }
-    else if (this->vertical_swing_state_ == vertical_swing_options::CUP)
+    if (this->state_ != ACState::Ready && !this->fast_boot_)
     {
-        mode_vertical_swing = protocol::REPORT_VSWING_CUP;
+        this->commands_.dropped++;
+        return false;
     }
+
+    this->commands_.accepted++;
+    if (this->commands_pending_ == 0)
+        this->commands_pending_since_ = millis();
     else
-    {
-        mode_vertical_swing = protocol::REPORT_VSWING_OFF;
-    }
-    packet[protocol::REPORT_VSWING_BYTE] |= (mode_vertical_swing << protocol::REPORT_VSWING_POS);
+        this->commands_.coalesced++;
+    if (this->commands_pending_ < UINT16_MAX)
+        this->commands_pending_++;
+    return true;
+}
 
-    /* HORIZONTAL SWING --------------------------------------------------------------------------- */
-    uint8_t mode_horizontal_swing = protocol::REPORT_HSWING_OFF;
-    if (this->horizontal_swing_state_ == horizontal_swing_options::OFF)
-    {
-        mode_horizontal_swing = protocol::REPORT_HSWING_OFF;
-    }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::FULL)
-    {
-        mode_horizontal_swing = protocol::REPORT_HSWING_FULL;
-    }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::CLEFT)
-    {
-        mode_horizontal_swing = protocol::REPORT_HSWING_CLEFT;
-    }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::CMIDL)
-    {
-        mode_horizontal_swing = protocol::REPORT_HSWING_CMIDL;
-    }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::CMID)
-    {
-        mode_horizontal_swing = protocol::REPORT_HSWING_CMID;
-    }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::CMIDR)
+/* First report after the 0xAF frame went out, the AC has the commands it carried */
+void SinclairACCNT::confirm_commands_()
+{
+    if (this->commands_in_flight_ == 0)
+        return;
+
+    CommandStats &stats = this->commands_;
+    uint32_t latency = millis() - this->commands_in_flight_since_;
+    stats.confirmed += this->commands_in_flight_;
+    stats.latency_samples++;
+    stats.latency_total_ms += latency;
+    if (latency > stats.latency_max_ms)
+        stats.latency_max_ms = latency;
+
+    uint8_t bucket = 0;
+    for (uint32_t limit = COMMAND_LATENCY_BUCKET_MS; latency >= limit && bucket < COMMAND_LATENCY_BUCKETS - 1; limit <<= 1)
+        bucket++;
+    stats.latency_buckets[bucket]++;
+
+    this->commands_in_flight_ = 0;
+}
+
+TxLane SinclairACCNT::next_tx_lane_()
+{
+    /* the 0xAF frame and the one clearing it belong to the same command */
+    if (this->update_ != ACUpdate::NoUpdate)
+        return TxLane::User;
+    if (this->tx_lanes_[static_cast<uint8_t>(TxLane::Recovery)].depth > 0 && this->has_last_packet_)
+        return TxLane::Recovery;
+    if (this->tx_lanes_[static_cast<uint8_t>(TxLane::Test)].depth > 0)
+        return TxLane::Test;
+    return TxLane::Keepalive;
+}
+
+void SinclairACCNT::service_tx_()
+{
+    /* the caller already made sure no report is outstanding */
+    TxLane lane = next_tx_lane_();
+
+    /* keepalives only poll at the refresh rate, everything else takes the first free slot */
+    if (lane == TxLane::Keepalive && millis() - this->last_packet_sent_ < protocol::TIME_REFRESH_PERIOD_MS)
+        return;
+    if (!tx_slot_open_())
+        return;
+
+    bool user_start = lane == TxLane::User && this->update_ == ACUpdate::UpdateStart;
+
+    switch (lane)
     {
-        mode_horizontal_swing = protocol::REPORT_HSWING_CMIDR;
+        case TxLane::User:
+        case TxLane::Keepalive:
+            send_packet();
+            break;
+        case TxLane::Recovery:
+            send_stored_packet_();
+            break;
+        case TxLane::Test:
+            send_test_frame_();
+            break;
     }
-    else if (this->horizontal_swing_state_ == horizontal_swing_options::CRIGHT)
+
+    /* the 0xAF frame is the one that applies the command, the follow-up is bookkeeping */
+    if (lane != TxLane::User || user_start)
+        complete_tx_(lane);
+}
+
+/*
+ * The link is half-duplex and the AC answers every SET with a report, so the next slot opens
+ * once our frame has left the wire, nothing is arriving and the report ended tx_guard_ ago
+ */
+bool SinclairACCNT::tx_slot_open_()
+{
+    uint32_t now = millis();
+
+    if ((int32_t) (now - this->tx_done_at_) < 0)
+        return false;
+    if (this->serialProcess_.state == STATE_RECIEVE || this->available())
+        return false;
+    return now - this->last_rx_byte_ >= this->tx_guard_;
+}
+
+void SinclairACCNT::complete_tx_(TxLane lane)
+{
+    uint8_t i = static_cast<uint8_t>(lane);
+    TxLaneStats &stats = this->tx_lanes_[i];
+    uint32_t now = millis();
+
+    stats.sent++;
+    if (lane == TxLane::Keepalive)
     {
-        mode_horizontal_swing = protocol::REPORT_HSWING_CRIGHT;
+        stats.requested++;  /* queued implicitly whenever nothing else is */
     }
     else
     {
-        mode_horizontal_swing = protocol::REPORT_HSWING_OFF;
+        uint32_t latency = now - this->tx_pending_since_[i];
+        stats.latency_last_ms = latency;
+        stats.latency_total_ms += latency;
+        if (latency > stats.latency_max_ms)
+            stats.latency_max_ms = latency;
     }
-    packet[protocol::REPORT_HSWING_BYTE] |= (mode_horizontal_swing << protocol::REPORT_HSWING_POS);
+    stats.depth = 0;
 
-    /* DISPLAY --------------------------------------------------------------------------- */
-    uint8_t display_mode = protocol::REPORT_DISP_MODE_AUTO;
-    if (this->display_state_ == display_options::AUTO)
-    {
-        display_mode = protocol::REPORT_DISP_MODE_AUTO;
-        this->display_power_internal_ = true;
-    }
-    else if (this->display_state_ == display_options::SET)
+    /* the 0xAF frame carries every command accepted so far */
+    if (lane == TxLane::User && this->commands_pending_ > 0)
     {
-        display_mode = protocol::REPORT_DISP_MODE_SET;
-        this->display_power_internal_ = true;
+        if (this->commands_in_flight_ == 0)
+            this->commands_in_flight_since_ = this->commands_pending_since_;
+        this->commands_in_flight_ += this->commands_pending_;
+        this->commands_pending_ = 0;
     }
-    else if (this->display_state_ == display_options::ACT)
-    {
-        display_mode = protocol::REPORT_DISP_MODE_ACT;
-        this->display_power_internal_ = true;
-    }
-    else if (this->display_state_ == display_options::OUT)
+
+    /* a recovery resend queued before this command would roll it back */
+    uint8_t r = static_cast<uint8_t>(TxLane::Recovery);
+    TxLaneStats &recovery = this->tx_lanes_[r];
+    if (lane == TxLane::User && recovery.depth > 0 &&
+        (int32_t) (this->tx_pending_since_[r] - this->tx_pending_since_[i]) <= 0)
     {
-        display_mode = protocol::REPORT_DISP_MODE_OUT;
-        this->display_power_internal_ = true;
+        ESP_LOGD(TAG, "User command supersedes the pending stored packet resend");
+        recovery.superseded++;
+        recovery.depth = 0;
     }
-    else if (this->display_state_ == display_options::OFF)
-    {
-        /* we do not want to alter display setting - only turn it off */
-        this->display_power_internal_ = false;
-        if (this->display_mode_internal_ == display_options::AUTO)
-        {
-            display_mode = protocol::REPORT_DISP_MODE_AUTO;
-        }
-        else if (this->display_mode_internal_ == display_options::SET)
-        {
-            display_mode = protocol::REPORT_DISP_MODE_SET;
-        }
-        else if (this->display_mode_internal_ == display_options::ACT)
-        {
-            display_mode = protocol::REPORT_DISP_MODE_ACT;
-        }
-        else if (this->display_mode_internal_ == display_options::OUT)
-        {
-            display_mode = protocol::REPORT_DISP_MODE_OUT;
-        }
+}
+
+void SinclairACCNT::log_command_stats()
+{
+    const CommandStats &stats = this->commands_;
+    ESP_LOGI(TAG, "Commands accepted=%u dropped=%u coalesced=%u confirmed=%u lost=%u pending=%u in_flight=%u",
+             (unsigned) stats.accepted, (unsigned) stats.dropped, (unsigned) stats.coalesced,
+             (unsigned) stats.confirmed, (unsigned) stats.lost, this->commands_pending_, this->commands_in_flight_);
+    ESP_LOGI(TAG, "Command latency max=%u avg=%u ms",
+             (unsigned) stats.latency_max_ms,
+             (unsigned) (stats.latency_samples ? stats.latency_total_ms / stats.latency_samples : 0));
+
+    uint32_t low = 0;
+    uint32_t high = COMMAND_LATENCY_BUCKET_MS;
+    for (uint8_t i = 0; i < COMMAND_LATENCY_BUCKETS; i++)
+    {
+        if (i == COMMAND_LATENCY_BUCKETS - 1)
+            ESP_LOGI(TAG, "  >=%5u ms: %u", (unsigned) low, (unsigned) stats.latency_buckets[i]);
         else
-        {
-            display_mode = protocol::REPORT_DISP_MODE_AUTO;
-        }
+            ESP_LOGI(TAG, "  %5u-%5u ms: %u", (unsigned) low, (unsigned) high, (unsigned) stats.latency_buckets[i]);
+        low = high;
+        high <<= 1;
     }
-    else
+}
+
+void SinclairACCNT::log_tx_stats()
+{
+    static const char *const LANE_NAMES[TX_LANE_COUNT] = {"user", "recovery", "test", "keepalive"};
+
+    for (uint8_t i = 0; i < TX_LANE_COUNT; i++)
     {
-        display_mode = protocol::REPORT_DISP_MODE_AUTO;
-        this->display_power_internal_ = true;
+        const TxLaneStats &stats = this->tx_lanes_[i];
+        ESP_LOGI(TAG, "TX %-9s req=%u coalesced=%u sent=%u superseded=%u depth=%u/%u latency last=%u max=%u avg=%u ms",
+                 LANE_NAMES[i], (unsigned) stats.requested, (unsigned) stats.coalesced, (unsigned) stats.sent,
+                 (unsigned) stats.superseded, stats.depth, stats.max_depth, (unsigned) stats.latency_last_ms,
+                 (unsigned) stats.latency_max_ms,
+                 (unsigned) (stats.sent ? stats.latency_total_ms / stats.sent : 0));
     }
+}
+
+/*
+ * Send a raw packet, as is
+ */
+void SinclairACCNT::send_packet()
+{
+    SINCLAIR_PROFILE_SCOPE(PROF_SEND_PACKET);
 
-    packet[protocol::REPORT_DISP_MODE_BYTE] |= (display_mode << protocol::REPORT_DISP_MODE_POS);
+    uint8_t packet[protocol::SET_PACKET_LEN];
+    build_set_payload_(packet);
 
-    if (this->display_power_internal_)
-    {
-        packet[protocol::REPORT_DISP_ON_BYTE] |= protocol::REPORT_DISP_ON_MASK;
-    }
+    /* Do the SYNC, length, command and checksum */
+    uint8_t frame[protocol::FRAME_MAX_LEN];
+    uint8_t frame_len = build_frame_(protocol::CMD_OUT_PARAMS_SET, packet, protocol::SET_PACKET_LEN, frame);
 
-    /* DISPLAY UNIT --------------------------------------------------------------------------- */
-    if (this->display_unit_state_ == display_unit_options::DEGF)
-    {
-        packet[protocol::REPORT_DISP_F_BYTE] |= protocol::REPORT_DISP_F_MASK;
-    }
+    //ESP_LOGV(TAG, "Stamp1: %lx", this->last_packet_sent_);
+    send_request_frame_(frame, frame_len);    /* Sent the packet by UART and log it */
 
-    /* PLASMA --------------------------------------------------------------------------- */
-    if (this->plasma_state_)
-    {
-        packet[protocol::REPORT_PLASMA1_BYTE] |= protocol::REPORT_PLASMA1_MASK;
-        packet[protocol::REPORT_PLASMA2_BYTE] |= protocol::REPORT_PLASMA2_MASK;
-    }
+    advance_update_();
+}
 
-    /* BEEPER --------------------------------------------------------------------------- */
-    if (!this->beeper_state_)
-    {
-        packet[protocol::REPORT_BEEPER_BYTE] |= protocol::REPORT_BEEPER_MASK;
-    }
+void SinclairACCNT::build_set_payload_(uint8_t *packet)
+{
+    std::memset(packet, 0, protocol::SET_PACKET_LEN);  /* Initialize packet contents */
+    
+    packet[protocol::SET_CONST_02_BYTE] = protocol::SET_CONST_02_VAL; /* Some always 0x02 byte... */
+    packet[protocol::SET_CONST_BIT_BYTE] = protocol::SET_CONST_BIT_MASK; /* Some always true bit */
 
-    /* SLEEP --------------------------------------------------------------------------- */
-    if (this->sleep_state_)
+    /* Prepare the rest of the frame */
+    /* this handles tricky part of 0xAF value and flag marking that WiFi does not apply any changes */
+    switch(this->update_)
     {
-        packet[protocol::REPORT_SLEEP_BYTE] |= protocol::REPORT_SLEEP_MASK;
+        default:
+        case ACUpdate::NoUpdate:
+            packet[protocol::SET_NOCHANGE_BYTE] |= protocol::SET_NOCHANGE_MASK;
+            break;
+        case ACUpdate::UpdateStart:
+            packet[protocol::SET_AF_BYTE] = protocol::SET_AF_VAL;
+            break;
+        case ACUpdate::UpdateClear:
+            break;
     }
 
-    /* XFAN --------------------------------------------------------------------------- */
-    if (this->xfan_state_)
+    /* MODE and POWER --------------------------------------------------------------------------- */
+    uint8_t mode = protocol::REPORT_MODE_AUTO;
+    bool power = false;
+    switch (this->mode)
     {
-        packet[protocol::REPORT_XFAN_BYTE] |= protocol::REPORT_XFAN_MASK;
+        case climate::CLIMATE_MODE_AUTO:
+            mode = protocol::REPORT_MODE_AUTO;
+            power = true;
+            break;
+        case climate::CLIMATE_MODE_COOL:
+            mode = protocol::REPORT_MODE_COOL;
+            power = true;
+            break;
+        case climate::CLIMATE_MODE_DRY:
+            mode = protocol::REPORT_MODE_DRY;
+            power = true;
+            break;
+        case climate::CLIMATE_MODE_FAN_ONLY:
+            mode = protocol::REPORT_MODE_FAN;
+            power = true;
+            break;
+        case climate::CLIMATE_MODE_HEAT:
+            mode = protocol::REPORT_MODE_HEAT;
+            power = true;
+            break;
+        case climate::CLIMATE_MODE_HEAT_COOL:
+            /* HEAT_COOL mode - treat as AUTO */
+            mode = protocol::REPORT_MODE_AUTO;
+            power = true;
+            break;
+        default:
+        case climate::CLIMATE_MODE_OFF:
+            /* In case of MODE_OFF we will not alter the last mode setting recieved from AC, see determine_mode() */
+            switch (this->mode_internal_)
+            {
+                case climate::CLIMATE_MODE_AUTO:
+                    mode = protocol::REPORT_MODE_AUTO;
+                    break;
+                case climate::CLIMATE_MODE_COOL:
+                    mode = protocol::REPORT_MODE_COOL;
+                    break;
+                case climate::CLIMATE_MODE_DRY:
+                    mode = protocol::REPORT_MODE_DRY;
+                    break;
+                case climate::CLIMATE_MODE_FAN_ONLY:
+                    mode = protocol::REPORT_MODE_FAN;
+                    break;
+                case climate::CLIMATE_MODE_HEAT:
+                    mode = protocol::REPORT_MODE_HEAT;
+                    break;
+                case climate::CLIMATE_MODE_HEAT_COOL:
+                    /* HEAT_COOL in internal mode - treat as AUTO */
+                    mode = protocol::REPORT_MODE_AUTO;
+                    break;
+                case climate::CLIMATE_MODE_OFF:
+                    /* OFF in internal mode - default to AUTO */
+                    mode = protocol::REPORT_MODE_AUTO;
+                    break;
+            }
+            power = false;
+            break;
     }
 
-    /* SAVE --------------------------------------------------------------------------- */
-    if (this->save_state_)
+    codec::encode_power_mode(packet, power, mode);
+
+    /* TARGET TEMPERATURE --------------------------------------------------------------------------- */
+    codec::encode_target_temperature(packet, this->target_temperature);
+
+    /* FAN SPEED --------------------------------------------------------------------------- */
+    /* unknown names encode as AUTO */
+    codec::encode_fan_mode(packet, codec::fan_mode_index(this->custom_fan_mode_.c_str()));
+
+    /* SWING --------------------------------------------------------------------------- */
+    codec::encode_vertical_swing(packet, codec::option_index(VERTICAL_SWING_OPTIONS, VERTICAL_SWING_OPTIONS_COUNT,
+                                                             this->vertical_swing_state_.c_str(), 0));
+    codec::encode_horizontal_swing(packet, codec::option_index(HORIZONTAL_SWING_OPTIONS, HORIZONTAL_SWING_OPTIONS_COUNT,
+                                                               this->horizontal_swing_state_.c_str(), 0));
+
+    /* DISPLAY --------------------------------------------------------------------------- */
+    uint8_t display = codec::option_index(DISPLAY_OPTIONS, DISPLAY_OPTIONS_COUNT, this->display_state_.c_str(), 1);
+    this->display_power_internal_ = display != 0;
+    if (!this->display_power_internal_)
     {
-        packet[protocol::REPORT_SAVE_BYTE] |= protocol::REPORT_SAVE_MASK;
+        /* we do not want to alter display setting - only turn it off */
+        display = codec::option_index(DISPLAY_OPTIONS, DISPLAY_OPTIONS_COUNT, this->display_mode_internal_, 1);
     }
+    codec::encode_display(packet, this->display_power_internal_, display);
+    codec::encode_display_fahrenheit(packet, this->display_unit_state_ == display_unit_options::DEGF);
+
+    /* EXTRAS --------------------------------------------------------------------------- */
+    codec::encode_plasma(packet, this->plasma_state_);
+    codec::encode_beeper(packet, this->beeper_state_);
+    codec::encode_sleep(packet, this->sleep_state_);
+    codec::encode_xfan(packet, this->xfan_state_);
+    codec::encode_save(packet, this->save_state_);
 
     /* Save the 45-byte SET payload for power-outage recovery (before CMD/len/checksum/SYNC) */
     if (this->update_ != ACUpdate::NoUpdate)
     {
         // Copy the 45-byte payload to RAM using memcpy for better performance
-        std::memcpy(this->last_packet_payload_.data, packet.data(), protocol::SET_PACKET_LEN);
+        std::memcpy(this->last_packet_payload_.data, packet, protocol::SET_PACKET_LEN);
         
-        // Save to NVS
-        this->pref_last_packet_.save(&this->last_packet_payload_);
+        // Save to NVS, with fast boot it is part of the blob written on the next loop
+        if (this->fast_boot_)
+        {
+            std::memcpy(this->fast_boot_state_.last_packet, packet, protocol::SET_PACKET_LEN);
+            this->fast_boot_state_.has_last_packet = true;
+            this->fast_boot_dirty_ = true;
+        }
+        else
+        {
+            SINCLAIR_PROFILE_SCOPE(PROF_PREF_SAVE);
+            this->pref_last_packet_.save(&this->last_packet_payload_);
+        }
         this->has_last_packet_ = true;
+        std::memcpy(this->warm_state_.last_packet, packet, protocol::SET_PACKET_LEN);
+        this->warm_state_.has_last_packet = true;
+        this->warm_dirty_ = true;
         
         ESP_LOGD(TAG, "Saved last update payload to NVS");
     }
 
-    /* Do the command, length */
-
+    /* SETPOINT COMPENSATION ----------------------------------------------------------------- */
+    /* the stored copy above keeps the user's setpoint, a resend after a power loss starts from it */
+    if (this->update_ != ACUpdate::NoUpdate)
+        this->sent_offset_ = this->compensator_.offset();
+    if (this->sent_offset_ != 0)
+        codec::encode_target_temperature(packet, this->target_temperature, this->sent_offset_);
 
     for (int i = 0; i < 20; i++)
          lastpacket[i] = packet[i];
-    
-    packet.insert(packet.begin(), protocol::CMD_OUT_PARAMS_SET);
-    packet.insert(packet.begin(), protocol::SET_PACKET_LEN + 2); /* Add 2 bytes as we added a command and will add checksum */
-
-    /* Do checksum - sum of all bytes except sync and checksum itself% 0x100 
-       the module would be realized by the fact that we are using uint8_t*/
-    uint8_t checksum = 0;
-    for (uint8_t i = 0 ; i < packet.size() ; i++)
-    {
-        checksum += packet[i];
-    }
-    packet.push_back(checksum);
-
-    /* Do SYNC bytes */
-    packet.insert(packet.begin(), protocol::SYNC);
-    packet.insert(packet.begin(), protocol::SYNC);
-
-    //ESP_LOGV(TAG, "Stamp1: %lx", this->last_packet_sent_);
-    this->last_packet_sent_ = millis();  /* Save the time when we sent the last packet */
-    
-    this->wait_response_ = true;
-
-    // СЫРОЙ ЛОГ ПЕРЕДАЧИ
-    ESP_LOGVV("sinclair_uart_raw", "TX frame len=%u", (unsigned)packet.size());
-    for (size_t i = 0; i < packet.size(); i++) {
-        ESP_LOGVV("sinclair_uart_raw", "TX[%u]=0x%02X", (unsigned)i, packet[i]);
-    }
-    
-    write_array(packet);                 /* Sent the packet by UART */
-    log_packet(packet, true);            /* Log uart for debug purposes */
-   
+}
 
-    
+void SinclairACCNT::advance_update_()
+{
     /* update setting state-machine */
     switch(this->update_)
     {
@@ -681,17 +1200,100 @@ void SinclairACCNT::send_packet()
     }
 }
 
+/*
+ * Framing helpers, frames are built on the stack so no TX path touches the heap
+ */
+uint8_t SinclairACCNT::build_frame_(uint8_t cmd, const uint8_t *payload, uint8_t payload_len, uint8_t *frame)
+{
+    frame[0] = protocol::SYNC;
+    frame[1] = protocol::SYNC;
+    frame[2] = payload_len + 2; /* Add 2 bytes as we add a command and a checksum */
+    frame[3] = cmd;
+    std::memcpy(frame + 4, payload, payload_len);
+
+    uint8_t len = payload_len + protocol::FRAME_OVERHEAD;
+    frame[len - 1] = protocol::frame_checksum(frame, len);
+
+    return len;
+}
+
+void SinclairACCNT::write_frame_(const uint8_t *frame, uint8_t len)
+{
+    // СЫРОЙ ЛОГ ПЕРЕДАЧИ
+    ESP_LOGVV("sinclair_uart_raw", "TX frame len=%u", (unsigned)len);
+    for (uint8_t i = 0; i < len; i++) {
+        ESP_LOGVV("sinclair_uart_raw", "TX[%u]=0x%02X", (unsigned)i, frame[i]);
+    }
+
+    this->tx_done_at_ = millis() + protocol::wire_time_ms(len);
+    write_array(frame, len);             /* Sent the packet by UART */
+    log_packet(frame, len, true);        /* Log uart for debug purposes */
+    notify_frame_(frame, len, true, millis());
+}
+
+void SinclairACCNT::send_request_frame_(const uint8_t *frame, uint8_t len)
+{
+    std::memcpy(this->in_flight_frame_, frame, len);
+    this->in_flight_len_ = len;
+    this->retries_ = 0;
+
+    this->last_packet_sent_ = millis();  /* Save the time when we sent the last packet */
+    this->wait_response_ = true;
+    write_frame_(frame, len);
+}
+
+/*
+ * A lost or corrupted report must not stall TX until the next valid frame: resend the
+ * frame that is still in flight, and give it up after max_retries_ so polling resumes
+ */
+void SinclairACCNT::check_response_deadline_()
+{
+    /* the deadline runs from the end of our frame, and a report already coming in gets to finish */
+    if ((int32_t) (millis() - this->tx_done_at_) < (int32_t) this->response_timeout_ ||
+        this->serialProcess_.state == STATE_RECIEVE)
+        return;
+    if (!tx_slot_open_())
+        return;
+
+    this->response_timeouts_++;
+
+    if (this->retries_ < this->max_retries_ && this->in_flight_len_ > 0)
+    {
+        this->retries_++;
+        this->retransmits_++;
+        ESP_LOGD(TAG, "No response in %u ms, retransmitting (retry %u/%u)",
+                 (unsigned) this->response_timeout_, this->retries_, this->max_retries_);
+        this->last_packet_sent_ = millis();
+        write_frame_(this->in_flight_frame_, this->in_flight_len_);
+        return;
+    }
+
+    this->frames_abandoned_++;
+    ESP_LOGW(TAG, "No response after %u retries, giving up on frame (timeouts=%u abandoned=%u)",
+             this->retries_, (unsigned) this->response_timeouts_, (unsigned) this->frames_abandoned_);
+    this->retries_ = 0;
+    this->wait_response_ = false;
+    this->commands_.lost += this->commands_in_flight_;
+    this->commands_in_flight_ = 0;
+    /* a setpoint offset in that frame never arrived, update_compensation_() sends it again */
+    this->sent_offset_ = this->confirmed_offset_;
+}
+
 /*
  * Packet handling
  */
 
-bool SinclairACCNT::verify_packet()
+FrameKind SinclairACCNT::verify_packet()
 {
+    SINCLAIR_PROFILE_SCOPE(PROF_VERIFY_PACKET);
+
     /* At least 2 sync bytes + length + type + checksum */
     if (this->serialProcess_.data.size() < 5)
     {
         ESP_LOGW(TAG, "Dropping invalid packet (length)");
-        return false;
+        this->link_.bad_length++;
+        note_link_damage_();
+        return FRAME_DROP;
     }
 
     /* The header (aka sync bytes) was checked by SinclairAC::read_data() */
@@ -699,39 +1301,50 @@ bool SinclairACCNT::verify_packet()
     /* The frame len was assumed by SinclairAC::read_data() */
 
     /* Check if this packet type sould be processed */
-    bool commandAllowed = false;
-    for (uint8_t packet : allowedPackets)
+    uint8_t command = this->serialProcess_.data[3];
+    FrameKind kind = static_cast<FrameKind>(FRAME_KINDS.kind[command]);
+    if (kind == FRAME_DROP)
     {
-        if (this->serialProcess_.data[3] == packet)
-        {
-            commandAllowed = true;
-            break;
-        }
+        ESP_LOGW(TAG, "Dropping invalid packet (command [%02X] not allowed)", command);
+        this->link_.bad_command++;
+        note_link_damage_();
+        return FRAME_DROP;
     }
-    if (!commandAllowed)
+    /* telemetry nobody reads is not even checksummed */
+    if (kind == FRAME_TELEMETRY && !telemetry_wanted_(command))
     {
-        ESP_LOGW(TAG, "Dropping invalid packet (command [%02X] not allowed)", this->serialProcess_.data[3]);
-        return false;
+        ESP_LOGV(TAG, "Ignoring telemetry frame [%02X], no sensor configured", command);
+        return FRAME_DROP;
     }
 
-    /* Check checksum - sum of all bytes except sync and checksum itself% 0x100 
-       the module would be realized by the fact that we are using uint8_t*/
-    uint8_t checksum = 0;
-    for (uint8_t i = 2 ; i < this->serialProcess_.data.size() - 1 ; i++)
-    {
-        checksum += this->serialProcess_.data[i];
-    }
+    uint8_t checksum = protocol::frame_checksum(this->serialProcess_.data.data(), this->serialProcess_.data.size());
     if (checksum != this->serialProcess_.data[this->serialProcess_.data.size()-1])
     {
         ESP_LOGD(TAG, "Dropping invalid packet (checksum)");
-        return false;
+        this->link_.bad_checksum++;
+        note_link_damage_();
+        return FRAME_DROP;
     }
 
-    return true;
+    this->link_.frames_ok++;
+    if (this->link_damaged_since_ != 0)
+    {
+        uint32_t resync = millis() - this->link_damaged_since_;
+        this->link_.resyncs++;
+        this->link_.resync_total_ms += resync;
+        if (resync > this->link_.resync_max_ms)
+            this->link_.resync_max_ms = resync;
+        this->link_damaged_since_ = 0;
+    }
+
+    return kind;
 }
 
+
 void SinclairACCNT::handle_packet()
 {
+    SINCLAIR_PROFILE_SCOPE(PROF_HANDLE_PACKET);
+
     if (this->serialProcess_.data[3] == protocol::CMD_IN_UNIT_REPORT)
     {
         // как только дошли сюда, пакет валиден и от AC
@@ -768,6 +1381,16 @@ void SinclairACCNT::handle_packet()
         /* now process the data */
         this->processUnitReport();
 
+        /* keep the warm restart copy of the report current */
+        if (this->serialProcess_.data.size() >= protocol::SET_PACKET_LEN &&
+            (!this->warm_state_.has_report ||
+             std::memcmp(this->warm_state_.report, this->serialProcess_.data.data(), protocol::SET_PACKET_LEN) != 0))
+        {
+            std::memcpy(this->warm_state_.report, this->serialProcess_.data.data(), protocol::SET_PACKET_LEN);
+            this->warm_state_.has_report = true;
+            this->warm_dirty_ = true;
+        }
+
         //Only send new data to HA if we did not initiate that ourselves!
         if (newdata || reqmodechange)
         {
@@ -780,7 +1403,7 @@ void SinclairACCNT::handle_packet()
             ESP_LOGD(TAG, "New packet !");
             reqmodechange = false;
             
-            this->publish_state();
+            this->publish_climate_();
         }
 
     }
@@ -801,26 +1424,30 @@ bool SinclairACCNT::processUnitReport()
     if (this->mode != newMode) hasChanged = true;
     this->mode = newMode;
 
-    std::string newFanMode = determine_fan_mode();
+    const char *newFanMode = determine_fan_mode();
     if (this->custom_fan_mode_ != newFanMode) hasChanged = true;
     this->custom_fan_mode_ = newFanMode;
     
     //float newTargetTemperature = (float)(((this->serialProcess_.data[protocol::REPORT_TEMP_SET_BYTE] & protocol::REPORT_TEMP_SET_MASK) >> protocol::REPORT_TEMP_SET_POS)
      //   + protocol::REPORT_TEMP_SET_OFF);
 
-    int Temset = (this->serialProcess_.data[protocol::REPORT_TEMP_SET_BYTE] & protocol::REPORT_TEMP_SET_MASK) >> protocol::REPORT_TEMP_SET_POS;
-    bool Temrec = this->serialProcess_.data[protocol::REPORT_DISP_F_BYTE] & protocol::TEMREC_MASK;
+    float newTargetTemperature = determine_target_temperature(this->sent_offset_);
 
-    float newTargetTemperature = 0;
-    
-    if (Temset < 0 || Temset > 15)
-          ESP_LOGW(TAG, "Invalid Temset reived !");
-    else
+    /* until the AC took a new setpoint offset, its reports still carry the old one */
+    if (this->sent_offset_ != this->confirmed_offset_ && newTargetTemperature != 0)
     {
-        if (Temrec)
-            newTargetTemperature = Temrec1[Temset];
+        if (lroundf(newTargetTemperature) == lroundf(this->target_temperature))
+        {
+            this->confirmed_offset_ = this->sent_offset_;
+            this->warm_state_.setpoint_offset = this->confirmed_offset_;
+            this->warm_dirty_ = true;
+        }
         else
-            newTargetTemperature = Temrec0[Temset];
+        {
+            float before = determine_target_temperature(this->confirmed_offset_);
+            if (before != 0 && lroundf(before) == lroundf(this->target_temperature))
+                newTargetTemperature = before;
+        }
     }
 
     if (newTargetTemperature == 0)
@@ -832,19 +1459,17 @@ bool SinclairACCNT::processUnitReport()
     }
     
     /* if there is no external sensor mapped to represent current temperature we will get data from AC unit */
-    float acIndoorTemperature = (float)(this->serialProcess_.data[protocol::REPORT_TEMP_ACT_BYTE] - 40);
+    float acIndoorTemperature = codec::decode_room_temperature(this->serialProcess_.data.data());
     
     // Publish AC indoor temperature sensor if available
-    if (this->ac_indoor_temp_sensor_ != nullptr) {
-        this->ac_indoor_temp_sensor_->publish_state(acIndoorTemperature);
-    }
+    this->publish_ac_indoor_temperature_(acIndoorTemperature);
     
     // Update current_temperature based on selected source
     // Use AC temperature when: 
-    //  - No external sensor configured (current_temperature_sensor_ == nullptr), OR
+    //  - No external sensor configured, OR
     //  - AC Own Sensor mode selected, OR
     //  - ATC Fail mode selected
-    if (this->current_temperature_sensor_ == nullptr ||
+    if (this->external_fusion_.size() == 0 ||
         this->temp_source_state_ == temp_source_options::AC_OWN ||
         this->temp_source_state_ == temp_source_options::ATC_FAIL ||
         this->atc_failed_)
@@ -855,20 +1480,19 @@ bool SinclairACCNT::processUnitReport()
     }
     // Otherwise, if using External ATC Sensor and not failed, external sensor callback handles temperature
 
-    std::string verticalSwing = determine_vertical_swing();
-    std::string horizontalSwing = determine_horizontal_swing();
-
-    this->update_swing_vertical(verticalSwing);
-    this->update_swing_horizontal(horizontalSwing);
+    this->update_swing_vertical(determine_vertical_swing());
+    this->update_swing_horizontal(determine_horizontal_swing());
 
     climate::ClimateSwingMode newSwingMode;
     /* update legacy swing mode to somehow represent actual state and support
        this setting without detailed settings done with additional switches */
-    if (verticalSwing == vertical_swing_options::FULL && horizontalSwing == horizontal_swing_options::FULL)
+    bool verticalFull = this->vertical_swing_state_ == vertical_swing_options::FULL;
+    bool horizontalFull = this->horizontal_swing_state_ == horizontal_swing_options::FULL;
+    if (verticalFull && horizontalFull)
         newSwingMode = climate::CLIMATE_SWING_BOTH;
-    else if (verticalSwing == vertical_swing_options::FULL)
+    else if (verticalFull)
         newSwingMode = climate::CLIMATE_SWING_VERTICAL;
-    else if (horizontalSwing == horizontal_swing_options::FULL)
+    else if (horizontalFull)
         newSwingMode = climate::CLIMATE_SWING_HORIZONTAL;
     else
         newSwingMode = climate::CLIMATE_SWING_OFF;
@@ -884,20 +1508,24 @@ bool SinclairACCNT::processUnitReport()
     this->update_xfan(determine_xfan());
     this->update_save(determine_save());
 
+    uint8_t fanIndex = codec::option_index(FAN_MODE_OPTIONS, FAN_MODE_OPTIONS_COUNT, newFanMode, 0);
+    uint8_t rawMode = codec::decode_mode(this->serialProcess_.data.data());
+    this->runtime_stats_.add_report(millis(), this->power_internal_, rawMode, fanIndex,
+                                    newTargetTemperature, acIndoorTemperature);
+
     return hasChanged;
 }
 
 climate::ClimateMode SinclairACCNT::determine_mode()
 {
-    uint8_t mode = (this->serialProcess_.data[protocol::REPORT_MODE_BYTE] & protocol::REPORT_MODE_MASK) >> protocol::REPORT_MODE_POS;
+    const uint8_t *payload = this->serialProcess_.data.data();
 
     /* as mode presented by climate component incorporates both power and mode we will store this separately for Sinclair
        in _internal_ fields */
-    /* check unit power flag */
-    this->power_internal_ = (this->serialProcess_.data[protocol::REPORT_PWR_BYTE] & protocol::REPORT_PWR_MASK) != 0;
+    this->power_internal_ = codec::decode_power(payload);
 
     /* check unit mode */
-    switch (mode)
+    switch (codec::decode_mode(payload))
     {
         case protocol::REPORT_MODE_AUTO:
             this->mode_internal_ = climate::CLIMATE_MODE_AUTO;
@@ -931,138 +1559,60 @@ climate::ClimateMode SinclairACCNT::determine_mode()
     }
 }
 
-std::string SinclairACCNT::determine_fan_mode()
+float SinclairACCNT::determine_target_temperature(int8_t offset)
 {
-    /* fan setting has quite complex representation in the packet, brace for it */
-    uint8_t fanSpeed1 = (this->serialProcess_.data[protocol::REPORT_FAN_SPD1_BYTE]  & protocol::REPORT_FAN_SPD1_MASK) >> protocol::REPORT_FAN_SPD1_POS;
-    uint8_t fanSpeed2 = (this->serialProcess_.data[protocol::REPORT_FAN_SPD2_BYTE]  & protocol::REPORT_FAN_SPD2_MASK) >> protocol::REPORT_FAN_SPD2_POS;
-    bool    fanQuiet  = (this->serialProcess_.data[protocol::REPORT_FAN_QUIET_BYTE] & protocol::REPORT_FAN_QUIET_MASK) != 0;
-    bool    fanTurbo  = (this->serialProcess_.data[protocol::REPORT_FAN_TURBO_BYTE] & protocol::REPORT_FAN_TURBO_MASK) != 0;
+    float target = codec::decode_target_temperature(this->serialProcess_.data.data(), offset);
+    if (target == 0)
+        ESP_LOGW(TAG, "Invalid Temset reived !");
+    return target;
+}
 
-    /* we have extracted all the data, let's do the processing */
-    if      (fanSpeed1 == 0 && fanSpeed2 == 0 && fanQuiet == false && fanTurbo == false)
+const char *SinclairACCNT::determine_fan_mode()
+{
+    uint8_t fan = codec::decode_fan_mode(this->serialProcess_.data.data());
+    if (fan >= FAN_MODE_OPTIONS_COUNT)
     {
+        ESP_LOGW(TAG, "Received unknown fan mode");
         return fan_modes::FAN_AUTO;
     }
-    else if (fanSpeed1 == 1 && fanSpeed2 == 1 && fanQuiet == true  && fanTurbo == false)
-    {
-        return fan_modes::FAN_QUIET;
-    }
-    else if (fanSpeed1 == 1 && fanSpeed2 == 1 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_LOW;
-    }
-    else if (fanSpeed1 == 2 && fanSpeed2 == 2 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_MEDL;
-    }
-    else if (fanSpeed1 == 3 && fanSpeed2 == 2 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_MED;
-    }
-    else if (fanSpeed1 == 4 && fanSpeed2 == 3 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_MEDH;
-    }
-    else if (fanSpeed1 == 5 && fanSpeed2 == 3 && fanQuiet == false && fanTurbo == false)
-    {
-        return fan_modes::FAN_HIGH;
-    }
-    else if (fanSpeed1 == 5 && fanSpeed2 == 3 && fanQuiet == false && fanTurbo == true )
-    {
-        return fan_modes::FAN_TURBO;
-    }
-    else 
+    return FAN_MODE_OPTIONS[fan];
+}
+
+const char *SinclairACCNT::determine_vertical_swing()
+{
+    uint8_t swing = codec::decode_vertical_swing(this->serialProcess_.data.data());
+    if (swing >= VERTICAL_SWING_OPTIONS_COUNT)
     {
-        ESP_LOGW(TAG, "Received unknown fan mode");
-        return fan_modes::FAN_AUTO;
+        ESP_LOGW(TAG, "Received unknown vertical swing mode");
+        return vertical_swing_options::OFF;
     }
+    return VERTICAL_SWING_OPTIONS[swing];
 }
 
-std::string SinclairACCNT::determine_vertical_swing()
-{
-    uint8_t mode = (this->serialProcess_.data[protocol::REPORT_VSWING_BYTE]  & protocol::REPORT_VSWING_MASK) >> protocol::REPORT_VSWING_POS;
-
-    switch (mode) {
-        case protocol::REPORT_VSWING_OFF:
-            return vertical_swing_options::OFF;
-        case protocol::REPORT_VSWING_FULL:
-            return vertical_swing_options::FULL;
-        case protocol::REPORT_VSWING_DOWN:
-            return vertical_swing_options::DOWN;
-        case protocol::REPORT_VSWING_MIDD:
-            return vertical_swing_options::MIDD;
-        case protocol::REPORT_VSWING_MID:
-            return vertical_swing_options::MID;
-        case protocol::REPORT_VSWING_MIDU:
-            return vertical_swing_options::MIDU;
-        case protocol::REPORT_VSWING_UP:
-            return vertical_swing_options::UP;
-        case protocol::REPORT_VSWING_CDOWN:
-            return vertical_swing_options::CDOWN;
-        case protocol::REPORT_VSWING_CMIDD:
-            return vertical_swing_options::CMIDD;
-        case protocol::REPORT_VSWING_CMID:
-            return vertical_swing_options::CMID;
-        case protocol::REPORT_VSWING_CMIDU:
-            return vertical_swing_options::CMIDU;
-        case protocol::REPORT_VSWING_CUP:
-            return vertical_swing_options::CUP;
-        default:
-            ESP_LOGW(TAG, "Received unknown vertical swing mode");
-            return vertical_swing_options::OFF;;
-    }
-}
-
-std::string SinclairACCNT::determine_horizontal_swing()
-{
-    uint8_t mode = (this->serialProcess_.data[protocol::REPORT_HSWING_BYTE]  & protocol::REPORT_HSWING_MASK) >> protocol::REPORT_HSWING_POS;
-
-    switch (mode) {
-        case protocol::REPORT_HSWING_OFF:
-            return horizontal_swing_options::OFF;
-        case protocol::REPORT_HSWING_FULL:
-            return horizontal_swing_options::FULL;
-        case protocol::REPORT_HSWING_CLEFT:
-            return horizontal_swing_options::CLEFT;
-        case protocol::REPORT_HSWING_CMIDL:
-            return horizontal_swing_options::CMIDL;
-        case protocol::REPORT_HSWING_CMID:
-            return horizontal_swing_options::CMID;
-        case protocol::REPORT_HSWING_CMIDR:
-            return horizontal_swing_options::CMIDR;
-        case protocol::REPORT_HSWING_CRIGHT:
-            return horizontal_swing_options::CRIGHT;
-        default:
-            ESP_LOGW(TAG, "Received unknown horizontal swing mode");
-            return horizontal_swing_options::OFF;
+const char *SinclairACCNT::determine_horizontal_swing()
+{
+    uint8_t swing = codec::decode_horizontal_swing(this->serialProcess_.data.data());
+    if (swing >= HORIZONTAL_SWING_OPTIONS_COUNT)
+    {
+        ESP_LOGW(TAG, "Received unknown horizontal swing mode");
+        return horizontal_swing_options::OFF;
     }
+    return HORIZONTAL_SWING_OPTIONS[swing];
 }
 
-std::string SinclairACCNT::determine_display()
+const char *SinclairACCNT::determine_display()
 {
-    uint8_t mode = (this->serialProcess_.data[protocol::REPORT_DISP_MODE_BYTE] & protocol::REPORT_DISP_MODE_MASK) >> protocol::REPORT_DISP_MODE_POS;
+    const uint8_t *payload = this->serialProcess_.data.data();
 
-    this->display_power_internal_ = (this->serialProcess_.data[protocol::REPORT_DISP_ON_BYTE] & protocol::REPORT_DISP_ON_MASK);
+    this->display_power_internal_ = codec::decode_display_on(payload);
 
-    switch (mode) {
-        case protocol::REPORT_DISP_MODE_AUTO:
-            this->display_mode_internal_ = display_options::AUTO;
-            break;
-        case protocol::REPORT_DISP_MODE_SET:
-            this->display_mode_internal_ = display_options::SET;
-            break;
-        case protocol::REPORT_DISP_MODE_ACT:
-            this->display_mode_internal_ = display_options::ACT;
-            break;
-        case protocol::REPORT_DISP_MODE_OUT:
-            this->display_mode_internal_ = display_options::OUT;
-            break;
-        default:
-            ESP_LOGW(TAG, "Received unknown display mode");
-            this->display_mode_internal_ = display_options::AUTO;
-            break;
+    uint8_t mode = codec::decode_display_mode(payload);
+    if (mode >= DISPLAY_OPTIONS_COUNT)
+    {
+        ESP_LOGW(TAG, "Received unknown display mode");
+        mode = 1;  /* AUTO */
     }
+    this->display_mode_internal_ = DISPLAY_OPTIONS[mode];
 
     if (this->display_power_internal_)
     {
@@ -1074,9 +1624,9 @@ std::string SinclairACCNT::determine_display()
     }
 }
 
-std::string SinclairACCNT::determine_display_unit()
+const char *SinclairACCNT::determine_display_unit()
 {
-    if (this->serialProcess_.data[protocol::REPORT_DISP_F_BYTE] & protocol::REPORT_DISP_F_MASK)
+    if (codec::decode_display_fahrenheit(this->serialProcess_.data.data()))
     {
         return display_unit_options::DEGF;
     }
@@ -1087,21 +1637,19 @@ std::string SinclairACCNT::determine_display_unit()
 }
 
 bool SinclairACCNT::determine_plasma(){
-    bool plasma1 = (this->serialProcess_.data[protocol::REPORT_PLASMA1_BYTE] & protocol::REPORT_PLASMA1_MASK) != 0;
-    bool plasma2 = (this->serialProcess_.data[protocol::REPORT_PLASMA2_BYTE] & protocol::REPORT_PLASMA2_MASK) != 0;
-    return plasma1 || plasma2;
+    return codec::decode_plasma(this->serialProcess_.data.data());
 }
 
 bool SinclairACCNT::determine_sleep(){
-    return (this->serialProcess_.data[protocol::REPORT_SLEEP_BYTE] & protocol::REPORT_SLEEP_MASK) != 0;
+    return codec::decode_sleep(this->serialProcess_.data.data());
 }
 
 bool SinclairACCNT::determine_xfan(){
-    return (this->serialProcess_.data[protocol::REPORT_XFAN_BYTE] & protocol::REPORT_XFAN_MASK) != 0;
+    return codec::decode_xfan(this->serialProcess_.data.data());
 }
 
 bool SinclairACCNT::determine_save(){
-    return (this->serialProcess_.data[protocol::REPORT_SAVE_BYTE] & protocol::REPORT_SAVE_MASK) != 0;
+    return codec::decode_save(this->serialProcess_.data.data());
 }
 
 
@@ -1111,45 +1659,45 @@ bool SinclairACCNT::determine_save(){
 
 void SinclairACCNT::on_vertical_swing_change(const std::string &swing)
 {
-    if (this->state_ != ACState::Ready)
+    if (!accept_command_())
         return;
 
     ESP_LOGD(TAG, "Setting vertical swing position");
 
-    this->update_ = ACUpdate::UpdateStart;
+    request_user_update_();
     this->vertical_swing_state_ = swing;
 }
 
 void SinclairACCNT::on_horizontal_swing_change(const std::string &swing)
 {
-    if (this->state_ != ACState::Ready)
+    if (!accept_command_())
         return;
 
     ESP_LOGD(TAG, "Setting horizontal swing position");
 
-    this->update_ = ACUpdate::UpdateStart;
+    request_user_update_();
     this->horizontal_swing_state_ = swing;
 }
 
 void SinclairACCNT::on_display_change(const std::string &display)
 {
-    if (this->state_ != ACState::Ready)
+    if (!accept_command_())
         return;
 
     ESP_LOGD(TAG, "Setting display mode");
 
-    this->update_ = ACUpdate::UpdateStart;
+    request_user_update_();
     this->display_state_ = display;
 }
 
 void SinclairACCNT::on_display_unit_change(const std::string &display_unit)
 {
-    if (this->state_ != ACState::Ready)
+    if (!accept_command_())
         return;
 
     ESP_LOGD(TAG, "Setting display unit");
 
-    this->update_ = ACUpdate::UpdateStart;
+    request_user_update_();
     this->display_unit_state_ = display_unit;
 }
 
@@ -1182,56 +1730,56 @@ void SinclairACCNT::on_temp_source_change(const std::string &temp_source)
 
 void SinclairACCNT::on_plasma_change(bool plasma)
 {
-    if (this->state_ != ACState::Ready)
+    if (!accept_command_())
         return;
 
     ESP_LOGD(TAG, "Setting plasma");
 
-    this->update_ = ACUpdate::UpdateStart;
+    request_user_update_();
     this->plasma_state_ = plasma;
 }
 
 void SinclairACCNT::on_beeper_change(bool beeper)
 {
-    if (this->state_ != ACState::Ready)
+    if (!accept_command_())
         return;
 
     ESP_LOGD(TAG, "Setting beeper");
 
-    this->update_ = ACUpdate::UpdateStart;
+    request_user_update_();
     this->beeper_state_ = beeper;
 }
 
 void SinclairACCNT::on_sleep_change(bool sleep)
 {
-    if (this->state_ != ACState::Ready)
+    if (!accept_command_())
         return;
 
     ESP_LOGD(TAG, "Setting sleep");
 
-    this->update_ = ACUpdate::UpdateStart;
+    request_user_update_();
     this->sleep_state_ = sleep;
 }
 
 void SinclairACCNT::on_xfan_change(bool xfan)
 {
-    if (this->state_ != ACState::Ready)
+    if (!accept_command_())
         return;
 
     ESP_LOGD(TAG, "Setting xfan");
 
-    this->update_ = ACUpdate::UpdateStart;
+    request_user_update_();
     this->xfan_state_ = xfan;
 }
 
 void SinclairACCNT::on_save_change(bool save)
 {
-    if (this->state_ != ACState::Ready)
+    if (!accept_command_())
         return;
 
     ESP_LOGD(TAG, "Setting save");
 
-    this->update_ = ACUpdate::UpdateStart;
+    request_user_update_();
     this->save_state_ = save;
 }
 
@@ -1253,7 +1801,7 @@ void SinclairACCNT::force_resend_last_packet()
     }
     
     ESP_LOGI(TAG, "Manually triggering resend of last stored packet");
-    send_stored_packet_();
+    request_tx_(TxLane::Recovery);
 }
 
 /*
@@ -1267,36 +1815,16 @@ void SinclairACCNT::send_stored_packet_()
         return;
     }
     
-    // Create packet vector and copy stored 45-byte payload
-    std::vector<uint8_t> packet(protocol::SET_PACKET_LEN);
-    std::memcpy(packet.data(), this->last_packet_payload_.data, protocol::SET_PACKET_LEN);
-    
-    // Add CMD and length
-    packet.insert(packet.begin(), protocol::CMD_OUT_PARAMS_SET);
-    packet.insert(packet.begin(), protocol::SET_PACKET_LEN + 2); /* Add 2 bytes as we added a command and will add checksum */
-    
-    // Calculate and add checksum - sum of all bytes except sync and checksum itself (modulo 0x100 via uint8_t)
-    uint8_t checksum = 0;
-    for (uint8_t i = 0 ; i < packet.size() ; i++)
-    {
-        checksum += packet[i];
-    }
-    packet.push_back(checksum);
-    
-    // Add SYNC bytes
-    packet.insert(packet.begin(), protocol::SYNC);
-    packet.insert(packet.begin(), protocol::SYNC);
+    // Frame the stored 45-byte payload (SYNC, length, CMD and checksum)
+    uint8_t frame[protocol::FRAME_MAX_LEN];
+    uint8_t frame_len = build_frame_(protocol::CMD_OUT_PARAMS_SET, this->last_packet_payload_.data,
+                                     protocol::SET_PACKET_LEN, frame);
     
     // Send the packet
-    this->last_packet_sent_ = millis();
-    this->wait_response_ = true;
-    write_array(packet);
-    log_packet(packet, true);
+    send_request_frame_(frame, frame_len);
+    this->sent_offset_ = 0;  /* the stored payload holds the user's setpoint */
     
     ESP_LOGI(TAG, "Resent last stored packet (45-byte payload)");
-    
-    // Clear the update flag since we just sent
-    this->update_ = ACUpdate::NoUpdate;
 }
 
 /*
@@ -1314,25 +1842,13 @@ void SinclairACCNT::inject_saved_packet()
         return;
     }
 
-    std::vector<uint8_t> packet(protocol::SET_PACKET_LEN);
-    std::memcpy(packet.data(), this->last_packet_payload_.data, protocol::SET_PACKET_LEN);
-
-    // Prepend command and length (mimic incoming unit report)
-    packet.insert(packet.begin(), protocol::CMD_IN_UNIT_REPORT);
-    packet.insert(packet.begin(), protocol::SET_PACKET_LEN + 2);
-
-    // Calculate checksum over length + cmd + payload
-    uint8_t checksum = 0;
-    for (uint8_t i = 0; i < packet.size(); i++)
-        checksum += packet[i];
-    packet.push_back(checksum);
-
-    // Prepend sync bytes
-    packet.insert(packet.begin(), protocol::SYNC);
-    packet.insert(packet.begin(), protocol::SYNC);
+    // Frame the payload with the unit report command (mimic incoming unit report)
+    uint8_t frame[protocol::FRAME_MAX_LEN];
+    uint8_t frame_len = build_frame_(protocol::CMD_IN_UNIT_REPORT, this->last_packet_payload_.data,
+                                     protocol::SET_PACKET_LEN, frame);
 
     // Inject into serial receive buffer and mark complete so loop() will handle it
-    this->serialProcess_.data = packet;
+    this->serialProcess_.data.assign(frame, frame + frame_len);
     this->serialProcess_.state = STATE_COMPLETE;
     ESP_LOGI(TAG, "Injected saved packet as incoming (simulated unit report)");
 }
@@ -1347,7 +1863,7 @@ void SinclairACCNT::inject_default_report()
     // - beeper OFF
     // - all extras OFF except plasma ON
 
-    std::vector<uint8_t> payload(protocol::SET_PACKET_LEN, 0);
+    uint8_t payload[protocol::SET_PACKET_LEN] = {0};
 
     // Ensure power bit cleared => CLIMATE_MODE_OFF will be reported
     // Leave mode bits at 0 (auto/unused when power=0)
@@ -1369,47 +1885,41 @@ void SinclairACCNT::inject_default_report()
     // Make sure sleep/xfan/save are OFF (leave bits 0)
 
     // Build full framed packet as incoming unit report
-    std::vector<uint8_t> packet = payload;
-    packet.insert(packet.begin(), protocol::CMD_IN_UNIT_REPORT);
-    packet.insert(packet.begin(), protocol::SET_PACKET_LEN + 2);
-
-    uint8_t checksum = 0;
-    for (uint8_t i = 0; i < packet.size(); i++) checksum += packet[i];
-    packet.push_back(checksum);
-
-    packet.insert(packet.begin(), protocol::SYNC);
-    packet.insert(packet.begin(), protocol::SYNC);
+    uint8_t frame[protocol::FRAME_MAX_LEN];
+    uint8_t frame_len = build_frame_(protocol::CMD_IN_UNIT_REPORT, payload, protocol::SET_PACKET_LEN, frame);
 
     // Also explicitly update beeper state so HA reflects beeper OFF (processUnitReport doesn't update beeper)
     this->update_beeper(false);
 
     // Inject and mark complete so loop() processes it
-    this->serialProcess_.data = packet;
+    this->serialProcess_.data.assign(frame, frame + frame_len);
     this->serialProcess_.state = STATE_COMPLETE;
     ESP_LOGI(TAG, "Injected default simulated unit report (power OFF, display OFF, °C, swings OFF, beeper OFF, plasma ON)");
 }
 
 /*
- * Send a predefined test SET packet (used by example buttons in repo)
- * This will write the exact frame bytes created in the web generator example
+ * Queue a predefined test SET packet (used by example buttons in repo)
  */
 void SinclairACCNT::send_test_set()
 {
-    std::vector<uint8_t> frame = {
+    request_tx_(TxLane::Test);
+}
+
+/*
+ * This will write the exact frame bytes created in the web generator example
+ */
+void SinclairACCNT::send_test_frame_()
+{
+    static const uint8_t frame[] = {
         0x7E,0x7E,0x2F,0x01,
         0x00,0x00,0x00,0x00,0xC0,0x70,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x04,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
         0x66
     };
 
-    // Update last sent timestamp and mark waiting for response
-    this->last_packet_sent_ = millis();
-    this->wait_response_ = true;
-
-    // Send directly over UART
-    write_array(frame);
-    log_packet(frame, true);
+    // Send directly over UART and wait for the response
+    send_request_frame_(frame, sizeof(frame));
 
-    ESP_LOGI(TAG, "send_test_set(): Test SET packet sent (length=%d)", (int)frame.size());
+    ESP_LOGI(TAG, "send_test_set(): Test SET packet sent (length=%d)", (int)sizeof(frame));
 }
 
 // (ignore_ready feature removed)
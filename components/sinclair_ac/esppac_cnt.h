@@ -2,6 +2,9 @@
 #include "esphome/components/climate/climate.h"
 #include "esphome/components/climate/climate_mode.h"
 #include "esppac.h"
+#include "esppac_compensation.h"
+#include "esppac_protocol.h"
+#include "esppac_stats.h"
 
 namespace esphome {
 namespace sinclair_ac {
@@ -12,147 +15,101 @@ enum class ACState {
     Ready,        /* AC talking to us */
 };
 
+enum class ACSession {
+    SendMac,      /* announce our MAC the way the original WiFi module does at power-up */
+    SendUnknown1, /* follow with the 0x02 frame captured from the original module */
+    Polling,      /* bring-up done, SET frames poll the AC for reports */
+};
+
 enum class ACUpdate {
     NoUpdate,    /* no parameters changed - normally process data, static flag set */
     UpdateStart, /* start update with 0xAF and cleared static flag */
     UpdateClear, /* update without 0xAF and cleared static flag */
 };
 
+/* TX priority classes, lower value wins the next free slot */
+enum class TxLane : uint8_t {
+    User,      /* changes from HA, control() and the select/switch entities */
+    Recovery,  /* stored packet resend after the AC became Ready, or on request */
+    Test,      /* fixed test SET frame from send_test_set() */
+    Keepalive, /* no-change SET that polls the AC for a report */
+};
+static const uint8_t TX_LANE_COUNT = 4;
+
+struct TxLaneStats {
+    uint32_t requested = 0;        /* requests queued on the lane */
+    uint32_t coalesced = 0;        /* requests merged into one already waiting */
+    uint32_t sent = 0;
+    uint32_t superseded = 0;       /* dropped because a newer user command carried the state */
+    uint8_t depth = 0;             /* requests waiting right now */
+    uint8_t max_depth = 0;
+    uint32_t latency_last_ms = 0;  /* first request to transmission */
+    uint32_t latency_max_ms = 0;
+    uint32_t latency_total_ms = 0;
+};
+
+/* Command path from HA/automation calls to the report that shows the AC took them. Latency runs
+   from the first command of a batch to that report, in buckets of COMMAND_LATENCY_BUCKET_MS
+   doubling per bucket, the last one is open-ended. */
+static const uint8_t COMMAND_LATENCY_BUCKETS = 8;
+static const uint32_t COMMAND_LATENCY_BUCKET_MS = 50;
+
+struct CommandStats {
+    uint32_t accepted = 0;       /* control() and on_*_change() calls that were taken */
+    uint32_t dropped = 0;        /* rejected because the AC was not Ready (and fast_boot is off) */
+    uint32_t coalesced = 0;      /* accepted while an earlier one still waited for its frame, sent together */
+    uint32_t confirmed = 0;      /* went out and a report answered the frame */
+    uint32_t lost = 0;           /* went out but the frame was given up after max_retries */
+    uint32_t latency_buckets[COMMAND_LATENCY_BUCKETS] = {0};
+    uint32_t latency_max_ms = 0;
+    uint32_t latency_total_ms = 0;
+    uint32_t latency_samples = 0;
+};
+
+/* Sniffer and bridge: the module side of the line, the unit side is counted in LinkStats. The
+   backlogs are the most bytes found waiting in a UART at one loop, close to its rx_buffer_size
+   means bytes were about to be lost. */
+struct SnifferStats {
+    uint32_t frames = 0;           /* complete frames the module sent */
+    uint32_t bad = 0;              /* failed the length or checksum check */
+    uint32_t truncated = 0;        /* stopped mid-frame for READ_TIMEOUT */
+    uint32_t sets = 0;
+    uint32_t updates = 0;          /* SETs with the 0xAF marker, the module changed something */
+    uint32_t handshakes = 0;       /* MAC report and 0x02 frames */
+    uint32_t other = 0;            /* valid frames of any other command */
+    uint32_t unit_backlog_max = 0;
+    uint32_t module_backlog_max = 0;
+};
+
+/* Bridge: unit bytes are cut through to the module as they are read, module frames are stored and
+   forwarded whole so a SET can carry our state instead. A module frame's latency runs from the loop
+   that read its first byte to the write, so it includes the frame's own wire time. */
+struct BridgeStats {
+    uint32_t unit_wait_max_ms = 0;        /* longest a unit byte waited in the RX buffer, one loop gap */
+    uint32_t module_frames = 0;           /* forwarded to the unit, with our state or not */
+    uint32_t injected = 0;                /* module SETs replaced by one with our update */
+    uint32_t deferred = 0;                /* our update held back as the module's own SET carried one */
+    uint32_t module_latency_last_ms = 0;
+    uint32_t module_latency_max_ms = 0;
+    uint32_t module_latency_total_ms = 0;
+};
+
 // Structure for storing the 45-byte SET packet payload in NVS
 struct LastPacketPayload {
     uint8_t data[45];  // Must match protocol::SET_PACKET_LEN (45 bytes)
 };
 
-namespace protocol {
-    /* SYNC */
-    static const uint8_t SYNC                = 0x7E;
-    /* packet types */
-    static const uint8_t CMD_IN_UNIT_REPORT  = 0x31;
-    static const uint8_t CMD_OUT_PARAMS_SET  = 0x01;
-    static const uint8_t CMD_OUT_SYNC_TIME   = 0x03;
-    static const uint8_t CMD_OUT_MAC_REPORT  = 0x04; /* 7e 7e 0d 04 04 00 00 00 AA BB CC DD EE FF 00 -> AA BB CC DD EE FF = MAC address */
-    static const uint8_t CMD_OUT_UNKNOWN_1   = 0x02; /* 7e 7e 10 02 00 00 00 00 00 00 01 00 28 1e 19 23 23 00 b8 */
-    static const uint8_t CMD_IN_UNKNOWN_1    = 0x44; /* 7e 7e 1a 44 01 00 01 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 01 */
-    static const uint8_t CMD_IN_UNKNOWN_2    = 0x33; /* 7e 7e 2f 33 00 00 40 00 09 20 19 0a 00 10 00 14 17 5b 08 08 00 00 00 00 00 00 00 00 01 00 00 0d 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 */
-
-    /* byte indexes are AFTER we remove first 4 bytes from the packet (sync, length, type) as well as a checksum */
-    /* unit report packet data fields, for binary values there is no need to define bit offset/position */
-    static const uint8_t REPORT_PWR_BYTE       = 4;
-    static const uint8_t REPORT_PWR_MASK       = 0b10000000;
-
-    static const uint8_t REPORT_MODE_BYTE      = 4;
-    static const uint8_t REPORT_MODE_MASK      = 0b01110000;
-    static const uint8_t REPORT_MODE_POS       = 4;
-    static const uint8_t REPORT_MODE_AUTO          = 0;
-    static const uint8_t REPORT_MODE_COOL          = 1;
-    static const uint8_t REPORT_MODE_DRY           = 2;
-    static const uint8_t REPORT_MODE_FAN           = 3;
-    static const uint8_t REPORT_MODE_HEAT          = 4;
-
-    static const uint8_t REPORT_FAN_SPD1_BYTE  = 18;
-    static const uint8_t REPORT_FAN_SPD1_MASK  = 0b00001111;
-    static const uint8_t REPORT_FAN_SPD1_POS   = 0;
-    static const uint8_t REPORT_FAN_SPD2_BYTE  = 4;
-    static const uint8_t REPORT_FAN_SPD2_MASK  = 0b00000011;
-    static const uint8_t REPORT_FAN_SPD2_POS   = 0;
-    static const uint8_t REPORT_FAN_QUIET_BYTE = 16;
-    static const uint8_t REPORT_FAN_QUIET_MASK = 0b00001000;
-    static const uint8_t REPORT_FAN_TURBO_BYTE = 6;
-    static const uint8_t REPORT_FAN_TURBO_MASK = 0b00000001;
-
-    static const uint8_t REPORT_FAN_MODE_MASK = 0b00000011;
-
-    static const uint8_t REPORT_TEMP_SET_BYTE  = 5;
-    static const uint8_t REPORT_TEMP_SET_MASK  = 0b11110000;
-    static const uint8_t REPORT_TEMP_SET_POS   = 4;
-    static const uint8_t REPORT_TEMP_SET_OFF   = 16; /* temperature offset from value in packet */
-
-    static const uint8_t REPORT_TEMP_ACT_BYTE  = 42;
-    static const uint8_t REPORT_TEMP_ACT_MASK  = 0b11111111;
-    static const uint8_t REPORT_TEMP_ACT_POS   = 0;
-    static const uint8_t REPORT_TEMP_ACT_OFF   = 16;  /* temperature offset from value in packet */
-    static const float   REPORT_TEMP_ACT_DIV   = 2.0; /* temperature divider from value in packet */
-
-    static const uint8_t REPORT_HSWING_BYTE    = 8;
-    static const uint8_t REPORT_HSWING_MASK    = 0b00000111;
-    static const uint8_t REPORT_HSWING_POS     = 0;
-    static const uint8_t REPORT_HSWING_OFF         = 0;
-    static const uint8_t REPORT_HSWING_FULL        = 1;
-    static const uint8_t REPORT_HSWING_CLEFT       = 2;
-    static const uint8_t REPORT_HSWING_CMIDL       = 3;
-    static const uint8_t REPORT_HSWING_CMID        = 4;
-    static const uint8_t REPORT_HSWING_CMIDR       = 5;
-    static const uint8_t REPORT_HSWING_CRIGHT      = 6;
-
-    static const uint8_t REPORT_VSWING_BYTE    = 8;
-    static const uint8_t REPORT_VSWING_MASK    = 0b11110000;
-    static const uint8_t REPORT_VSWING_POS     = 4;
-    static const uint8_t REPORT_VSWING_OFF         = 0;
-    static const uint8_t REPORT_VSWING_FULL        = 1;
-    static const uint8_t REPORT_VSWING_CUP         = 2;
-    static const uint8_t REPORT_VSWING_CMIDU       = 3;
-    static const uint8_t REPORT_VSWING_CMID        = 4;
-    static const uint8_t REPORT_VSWING_CMIDD       = 5;
-    static const uint8_t REPORT_VSWING_CDOWN       = 6;
-    static const uint8_t REPORT_VSWING_DOWN        = 7;
-    static const uint8_t REPORT_VSWING_MIDD        = 8;
-    static const uint8_t REPORT_VSWING_MID         = 9;
-    static const uint8_t REPORT_VSWING_MIDU        = 10;
-    static const uint8_t REPORT_VSWING_UP          = 11;
-
-    static const uint8_t REPORT_DISP_ON_BYTE   = 6;
-    static const uint8_t REPORT_DISP_ON_MASK   = 0b00000010;
-    static const uint8_t REPORT_DISP_MODE_BYTE = 9;
-    static const uint8_t REPORT_DISP_MODE_MASK = 0b00110000;
-    static const uint8_t REPORT_DISP_MODE_POS  = 4;
-    static const uint8_t REPORT_DISP_MODE_AUTO     = 0;
-    static const uint8_t REPORT_DISP_MODE_SET      = 1;
-    static const uint8_t REPORT_DISP_MODE_ACT      = 2;
-    static const uint8_t REPORT_DISP_MODE_OUT      = 3;
-
-    static const uint8_t REPORT_DISP_F_BYTE    = 7;
-    static const uint8_t TEMREC_MASK           = 0b01000000;
-    static const uint8_t REPORT_DISP_F_MASK    = 0b10000000;
-
-    static const uint8_t REPORT_PLASMA1_BYTE   = 6;
-    static const uint8_t REPORT_PLASMA1_MASK   = 0b00000100;
-    static const uint8_t REPORT_PLASMA2_BYTE   = 0;
-    static const uint8_t REPORT_PLASMA2_MASK   = 0b00000100;
-
-    static const uint8_t REPORT_SLEEP_BYTE     = 4;
-    static const uint8_t REPORT_SLEEP_MASK     = 0b00001000;
-
-    static const uint8_t REPORT_XFAN_BYTE      = 6;
-    static const uint8_t REPORT_XFAN_MASK      = 0b00001000;
-
-    static const uint8_t REPORT_SAVE_BYTE      = 11;
-    static const uint8_t REPORT_SAVE_MASK      = 0b01000000;
-
-    static const uint8_t REPORT_BEEPER_BYTE    = 40;
-    static const uint8_t REPORT_BEEPER_MASK    = 0b00000001;
-
-    /* SET packet shares all the byte definition with REPORT */
-    static const uint8_t SET_PACKET_LEN        = 45;
-    
-    static const uint8_t SET_CONST_02_BYTE     = 39;
-    static const uint8_t SET_CONST_02_VAL      = 0x02;
-
-    static const uint8_t SET_AF_BYTE           = 3;
-    static const uint8_t SET_AF_VAL            = 0xAF;
-
-    static const uint8_t SET_NOCHANGE_BYTE     = 11;
-    static const uint8_t SET_NOCHANGE_MASK     = 0b00001000;
-
-    static const uint8_t SET_CONST_BIT_BYTE    = 7;
-    static const uint8_t SET_CONST_BIT_MASK    = 0b00000010;
-
-    /* time constraints */
-    static const unsigned long TIME_REFRESH_PERIOD_MS   =  300;
-    static const unsigned long TIME_TIMEOUT_INACTIVE_MS = 1000;
-}
-
-/* Define packets from AC that would be processed by software */
-const std::vector<uint8_t> allowedPackets = {protocol::CMD_IN_UNIT_REPORT};
+/* A sensor fed from one byte field of a telemetry frame, value = ((payload[byte] & mask) >> shift) * multiply + offset */
+struct TelemetryField {
+    sensor::Sensor *sensor;
+    uint8_t command;
+    uint8_t byte;
+    uint8_t mask;
+    uint8_t shift;
+    float multiply;
+    float offset;
+    int16_t last;        /* raw field last published, -1 before the first one */
+};
 
 class SinclairACCNT : public SinclairAC {
     public:
@@ -174,6 +131,68 @@ class SinclairACCNT : public SinclairAC {
         void setup() override;
         void loop() override;
 
+        void set_response_timeout(uint32_t timeout_ms) { this->response_timeout_ = timeout_ms; }
+        void set_max_retries(uint8_t max_retries) { this->max_retries_ = max_retries; }
+        void set_tx_guard(uint32_t guard_ms) { this->tx_guard_ = guard_ms; }
+
+        /* Passive sniffer: nothing is ever sent, the UART of the component taps what the unit sends
+           and module_uart what the original WiFi module sends. Reports are decoded and published as
+           usual, the module's SET frames are decoded to the log. */
+        void set_sniffer_uart(uart::UARTComponent *module_uart)
+        {
+            this->sniffer_ = true;
+            this->module_uart_ = module_uart;
+        }
+        bool is_sniffer() const { return this->sniffer_; }
+        const SnifferStats &get_sniffer_stats() const { return this->sniffer_stats_; }
+        void log_sniffer_stats();
+
+        /* Bridge: the component sits between the original WiFi module and the unit and forwards both
+           ways, module_uart is wired to the module. The module keeps running the link, our commands
+           go out in place of the module's next SET that does not carry an update of its own. */
+        void set_bridge_uart(uart::UARTComponent *module_uart)
+        {
+            this->bridge_ = true;
+            this->module_uart_ = module_uart;
+            this->rx_mirror_ = module_uart;
+        }
+        bool is_bridge() const { return this->bridge_; }
+        const BridgeStats &get_bridge_stats() const { return this->bridge_stats_; }
+        void log_bridge_stats();
+
+        void set_stats_update_interval(uint32_t interval_ms) { this->stats_update_interval_ = interval_ms; }
+        void set_power_on_hours_sensor(sensor::Sensor *sens) { this->power_on_hours_sensor_ = sens; }
+        void set_setpoint_changes_sensor(sensor::Sensor *sens) { this->setpoint_changes_sensor_ = sens; }
+        void set_time_to_setpoint_sensor(sensor::Sensor *sens) { this->time_to_setpoint_sensor_ = sens; }
+        /* mode is the raw report value (REPORT_MODE_*), fan the index into FAN_MODE_OPTIONS */
+        void set_mode_hours_sensor(uint8_t mode, sensor::Sensor *sens) { this->mode_hours_sensors_[mode] = sens; }
+        void set_fan_hours_sensor(uint8_t fan, sensor::Sensor *sens) { this->fan_hours_sensors_[fan] = sens; }
+        const RuntimeStats &get_runtime_stats() const { return this->runtime_stats_; }
+
+        void set_setpoint_compensation(bool enabled) { this->compensation_ = enabled; }
+        void set_compensation_gains(float kp, float ki) { this->compensator_.set_gains(kp, ki); }
+        void set_compensation_max_offset(int8_t max_offset) { this->compensator_.set_max_offset(max_offset); }
+        void set_compensation_interval(uint32_t interval_ms) { this->compensator_.set_interval(interval_ms); }
+        void set_compensation_min_hold(uint32_t hold_ms) { this->compensator_.set_min_hold(hold_ms); }
+        void set_compensation_offset_sensor(sensor::Sensor *sens) { this->compensation_offset_sensor_ = sens; }
+        const SetpointCompensator &get_setpoint_compensator() const { return this->compensator_; }
+
+        /* byte counts from the first payload byte after the command */
+        void add_telemetry_sensor(sensor::Sensor *sens, uint8_t command, uint8_t byte, uint8_t mask, float multiply,
+                                  float offset);
+
+        void on_shutdown() override;
+
+        /* Link counters since boot, usable from lambdas */
+        uint32_t get_response_timeouts() const { return this->response_timeouts_; }
+        uint32_t get_retransmits() const { return this->retransmits_; }
+        uint32_t get_frames_abandoned() const { return this->frames_abandoned_; }
+        const TxLaneStats &get_tx_lane_stats(TxLane lane) const { return this->tx_lanes_[static_cast<uint8_t>(lane)]; }
+        void log_tx_stats();
+        const CommandStats &get_command_stats() const { return this->commands_; }
+        void log_command_stats();
+        void reset_command_stats() { this->commands_ = CommandStats(); }
+
         void force_resend_last_packet();
         // Send a predefined test SET packet (used by example button)
         void send_test_set();
@@ -187,11 +206,59 @@ class SinclairACCNT : public SinclairAC {
     protected:
         ACState state_ = ACState::Initializing; /* Stores if the AC is responsive or not */
         ACUpdate update_ = ACUpdate::NoUpdate;  /* Stores if we need tu send update to AC or no */
+        ACSession session_ = ACSession::SendMac; /* WiFi module bring-up sequence */
+        uint32_t handshake_frame_sent_ = 0;      /* Time the last bring-up frame was sent */
+        uint32_t handshake_started_ = 0;         /* Time the current link attempt started, for time-to-first-report */
+        uint16_t handshake_attempts_ = 0;        /* Bring-up sequences sent since the link was last up */
+
+        uint32_t response_timeout_ = protocol::DEFAULT_RESPONSE_TIMEOUT_MS;
+        uint8_t max_retries_ = protocol::DEFAULT_MAX_RETRIES;
+        uint8_t in_flight_frame_[protocol::FRAME_MAX_LEN]; /* Last SET frame sent, retransmitted on timeout */
+        uint8_t in_flight_len_ = 0;
+        uint8_t retries_ = 0;                    /* Retransmissions of the in-flight frame so far */
+        uint32_t response_timeouts_ = 0;         /* Deadlines that expired without a report */
+        uint32_t retransmits_ = 0;
+        uint32_t frames_abandoned_ = 0;          /* Frames given up after max_retries_ */
+
+        bool sniffer_ = false;
+        bool bridge_ = false;
+        uart::UARTComponent *module_uart_ = nullptr;
+        SerialProcess_t module_process_;         /* Framing of the module side, like serialProcess_ */
+        uint32_t module_last_byte_ = 0;
+        uint32_t module_frame_start_ = 0;        /* Loop that read the first byte of the current module frame */
+        SnifferStats sniffer_stats_;
+        BridgeStats bridge_stats_;
+        uint32_t bridge_last_read_ = 0;          /* Last loop that read the unit side */
+        /* Sniffer or bridge, the original module polls and we never start a frame on our own */
+        bool module_runs_link_() const { return this->module_uart_ != nullptr; }
+
+        uint32_t tx_guard_ = protocol::DEFAULT_TX_GUARD_MS;
+        uint32_t tx_done_at_ = 0;                /* Time our last frame has fully left the wire */
+
+        RuntimeStats runtime_stats_;
+        ESPPreferenceObject pref_runtime_stats_;
+        uint32_t stats_saved_ = 0;               /* Last write-behind of the totals */
+        uint32_t stats_published_ = 0;
+        uint32_t stats_update_interval_ = STATS_DEFAULT_UPDATE_INTERVAL_MS;
+        sensor::Sensor *power_on_hours_sensor_ = nullptr;
+        sensor::Sensor *setpoint_changes_sensor_ = nullptr;   /* setpoint changes per day */
+        sensor::Sensor *time_to_setpoint_sensor_ = nullptr;   /* minutes the last approach took */
+        sensor::Sensor *mode_hours_sensors_[STATS_MODE_COUNT] = {nullptr};
+        sensor::Sensor *fan_hours_sensors_[STATS_FAN_COUNT] = {nullptr};
+
+        bool compensation_ = false;              /* Bias the setpoint sent to the AC so the external sensor reaches it */
+        SetpointCompensator compensator_;
+        std::vector<TelemetryField> telemetry_;  /* Empty unless telemetry sensors are configured */
+        uint8_t telemetry_commands_[2] = {0};    /* Commands some telemetry sensor reads from, 0 for none */
+
+        int8_t sent_offset_ = 0;                 /* Offset carried by the last SET that changed something */
+        int8_t confirmed_offset_ = 0;            /* Offset a report showed the AC runs with */
+        sensor::Sensor *compensation_offset_sensor_ = nullptr;
 
         climate::ClimateMode mode_internal_;
         bool power_internal_;
 
-        std::string display_mode_internal_;
+        const char *display_mode_internal_ = display_options::AUTO;
         bool display_power_internal_;
 
         std::string custom_fan_mode_;  // Текущий режим вентилятора для обновления
@@ -200,30 +267,92 @@ class SinclairACCNT : public SinclairAC {
         LastPacketPayload last_packet_payload_;
         bool has_last_packet_ = false;
         bool packet_resent_on_ready_ = false;
-        bool pending_stored_packet_resend_ = false;
+
+        TxLaneStats tx_lanes_[TX_LANE_COUNT];
+        uint32_t tx_pending_since_[TX_LANE_COUNT] = {0};
+
+        uint32_t reports_since_ready_ = 0;
+
+        CommandStats commands_;
+        uint16_t commands_pending_ = 0;          /* accepted, no 0xAF frame carried them yet */
+        uint32_t commands_pending_since_ = 0;
+        uint16_t commands_in_flight_ = 0;        /* sent, waiting for the report */
+        uint32_t commands_in_flight_since_ = 0;
 
         
 
         bool processUnitReport();
 
+        /* Queue a frame on a lane, service_tx_() sends the highest priority one when the link is free */
+        void request_tx_(TxLane lane);
+        void request_user_update_();
+        /* Entry check of every user command, false (and counted as dropped) while it cannot be taken */
+        bool accept_command_();
+        void confirm_commands_();
+        TxLane next_tx_lane_();
+        void service_tx_();
+        /* True when neither side is on the line and the last report is at least tx_guard_ old */
+        bool tx_slot_open_();
+        void complete_tx_(TxLane lane);
+
         void send_packet();
+        /* The SET payload for the current state and update_, saved for power-outage recovery when it
+           carries an update. advance_update_() moves update_ on once it went out. */
+        void build_set_payload_(uint8_t *packet);
+        void advance_update_();
         void send_stored_packet_();
+        void send_test_frame_();
+        void send_handshake_();
+        void restore_from_stored_packet_();
+        void load_stored_packet_();
+        void restore_from_warm_report_();
+        void update_runtime_stats_();
+        void save_runtime_stats_();
+        void update_compensation_();
+
+        /* Frames a payload into a caller-provided buffer of at least FRAME_MAX_LEN bytes, returns the frame length */
+        uint8_t build_frame_(uint8_t cmd, const uint8_t *payload, uint8_t payload_len, uint8_t *frame);
+        void write_frame_(const uint8_t *frame, uint8_t len);
+        /* Writes a frame the AC answers with a report and arms the response deadline */
+        void send_request_frame_(const uint8_t *frame, uint8_t len);
+        void check_response_deadline_();
 
         bool reqmodechange = false;
         unsigned char lastpacket[60];
         unsigned char lastroomtemp;
 
-        bool verify_packet();
+        /* Handles the complete frame in serialProcess_, false when it was dropped */
+        bool handle_rx_frame_();
+        /* Sniffer and bridge: frames everything the module sent since the last loop and decodes it */
+        void read_module_data_();
+        void handle_module_frame_();
+        /* Bridge: hands a module frame on to the unit, or a SET with our update in its place */
+        void bridge_forward_(const uint8_t *frame, size_t len);
+        void bridge_set_(const uint8_t *frame, size_t len, bool module_update);
+
+        /* Checks length and checksum, returns the frame's kind or FRAME_DROP */
+        FrameKind verify_packet();
         void handle_packet();
 
+        typedef void (SinclairACCNT::*FrameHandler)();
+        static const FrameHandler FRAME_HANDLERS[FRAME_KIND_COUNT];
+        void handle_unit_report_frame_();
+        void handle_telemetry_frame_();
+        bool telemetry_wanted_(uint8_t command) const
+        {
+            return command == this->telemetry_commands_[0] || command == this->telemetry_commands_[1];
+        }
+
         climate::ClimateMode determine_mode();
-        std::string determine_fan_mode();
+        /* offset is the setpoint compensation the report was made with, it is taken off */
+        float determine_target_temperature(int8_t offset = 0);
+        const char *determine_fan_mode();
 
-        std::string determine_vertical_swing();
-        std::string determine_horizontal_swing();
+        const char *determine_vertical_swing();
+        const char *determine_horizontal_swing();
 
-        std::string determine_display();
-        std::string determine_display_unit();
+        const char *determine_display();
+        const char *determine_display_unit();
 
         bool determine_plasma();
         bool determine_sleep();
@@ -0,0 +1,255 @@
+#include "esppac_codec.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace esphome {
+namespace sinclair_ac {
+namespace CNT {
+namespace codec {
+
+const float TEMREC0[16] = {
+    15.5555555555556f, 16.6666666666667f, 17.7777777778f, 18.8888888889f,
+    20.0f,             20.5555555556f,    21.6666666667f, 22.7777777778f,
+    23.8888888889f,    25.0f,             25.5555555556f, 26.6666666667f,
+    27.7777777778f,    28.8888888889f,    30.0f,          30.5555555556f,
+};
+
+const float TEMREC1[16] = {
+    16.1111111111111f, 17.2222222222222f, 18.3333333333333f, 19.4444444444444f,
+    0,                 21.1111111111f,    22.2222222222222f, 23.3333333333f,
+    24.4444444444f,    0,                 26.1111111111111f, 27.2222222222222f,
+    28.3333333333f,    29.4444444444f,    0,                 31.1111111111111f,
+};
+
+const FanEncoding FAN_ENCODINGS[FAN_MODE_OPTIONS_COUNT] = {
+    {0, 0, false, false},  /* auto */
+    {1, 1, true, false},   /* quiet */
+    {1, 1, false, false},  /* low */
+    {2, 2, false, false},  /* medium-low */
+    {3, 2, false, false},  /* medium */
+    {4, 3, false, false},  /* medium-high */
+    {5, 3, false, false},  /* high */
+    {5, 3, false, true},   /* turbo */
+};
+
+const uint8_t VERTICAL_SWING_CODES[VERTICAL_SWING_OPTIONS_COUNT] = {
+    protocol::REPORT_VSWING_OFF,   protocol::REPORT_VSWING_FULL,  protocol::REPORT_VSWING_DOWN,
+    protocol::REPORT_VSWING_MIDD,  protocol::REPORT_VSWING_MID,   protocol::REPORT_VSWING_MIDU,
+    protocol::REPORT_VSWING_UP,    protocol::REPORT_VSWING_CDOWN, protocol::REPORT_VSWING_CMIDD,
+    protocol::REPORT_VSWING_CMID,  protocol::REPORT_VSWING_CMIDU, protocol::REPORT_VSWING_CUP,
+};
+
+const uint8_t HORIZONTAL_SWING_CODES[HORIZONTAL_SWING_OPTIONS_COUNT] = {
+    protocol::REPORT_HSWING_OFF,  protocol::REPORT_HSWING_FULL,  protocol::REPORT_HSWING_CLEFT,
+    protocol::REPORT_HSWING_CMIDL, protocol::REPORT_HSWING_CMID, protocol::REPORT_HSWING_CMIDR,
+    protocol::REPORT_HSWING_CRIGHT,
+};
+
+const uint8_t DISPLAY_MODE_CODES[DISPLAY_OPTIONS_COUNT - 1] = {
+    protocol::REPORT_DISP_MODE_AUTO, protocol::REPORT_DISP_MODE_SET,
+    protocol::REPORT_DISP_MODE_ACT,  protocol::REPORT_DISP_MODE_OUT,
+};
+
+static void set_field(uint8_t *payload, uint8_t byte, uint8_t mask, uint8_t pos, uint8_t value)
+{
+    payload[byte] = (payload[byte] & ~mask) | ((value << pos) & mask);
+}
+
+static uint8_t get_field(const uint8_t *payload, uint8_t byte, uint8_t mask, uint8_t pos)
+{
+    return (payload[byte] & mask) >> pos;
+}
+
+static void set_flag(uint8_t *payload, uint8_t byte, uint8_t mask, bool value)
+{
+    if (value)
+        payload[byte] |= mask;
+    else
+        payload[byte] &= ~mask;
+}
+
+static bool get_flag(const uint8_t *payload, uint8_t byte, uint8_t mask) { return (payload[byte] & mask) != 0; }
+
+/* Reverse lookup of a wire value, count when the value has no option */
+static uint8_t code_index(const uint8_t *codes, uint8_t count, uint8_t code)
+{
+    for (uint8_t i = 0; i < count; i++)
+        if (codes[i] == code)
+            return i;
+    return count;
+}
+
+uint8_t option_index(const char *const *table, uint8_t count, const char *name, uint8_t fallback)
+{
+    if (name == nullptr)
+        return fallback;
+    for (uint8_t i = 0; i < count; i++)
+        if (table[i] == name || std::strcmp(table[i], name) == 0)
+            return i;
+    return fallback;
+}
+
+uint8_t fan_mode_index(const char *name)
+{
+    uint8_t fan = option_index(FAN_MODE_OPTIONS, FAN_MODE_OPTIONS_COUNT, name, FAN_MODE_OPTIONS_COUNT);
+    if (fan < FAN_MODE_OPTIONS_COUNT)
+        return fan;
+    return option_index(CUSTOM_FAN_MODES, FAN_MODE_OPTIONS_COUNT, name, FAN_MODE_OPTIONS_COUNT);
+}
+
+void encode_power_mode(uint8_t *payload, bool power, uint8_t mode)
+{
+    set_field(payload, protocol::REPORT_MODE_BYTE, protocol::REPORT_MODE_MASK, protocol::REPORT_MODE_POS, mode);
+    set_flag(payload, protocol::REPORT_PWR_BYTE, protocol::REPORT_PWR_MASK, power);
+}
+
+bool decode_power(const uint8_t *payload) { return get_flag(payload, protocol::REPORT_PWR_BYTE, protocol::REPORT_PWR_MASK); }
+
+uint8_t decode_mode(const uint8_t *payload)
+{
+    return get_field(payload, protocol::REPORT_MODE_BYTE, protocol::REPORT_MODE_MASK, protocol::REPORT_MODE_POS);
+}
+
+void encode_target_temperature(uint8_t *payload, float target, int8_t offset)
+{
+    uint8_t rounded = static_cast<uint8_t>(std::round(target));
+    uint8_t field = static_cast<uint8_t>(rounded + offset - protocol::REPORT_TEMP_SET_OFF);
+    set_field(payload, protocol::REPORT_TEMP_SET_BYTE, protocol::REPORT_TEMP_SET_MASK, protocol::REPORT_TEMP_SET_POS, field);
+    set_flag(payload, protocol::REPORT_DISP_F_BYTE, protocol::TEMREC_MASK, target - (float) rounded > 0);
+}
+
+float decode_target_temperature(const uint8_t *payload, int8_t offset)
+{
+    int field = get_field(payload, protocol::REPORT_TEMP_SET_BYTE, protocol::REPORT_TEMP_SET_MASK,
+                          protocol::REPORT_TEMP_SET_POS) - offset;
+    if (field < 0 || field > 15)
+        return 0;
+    return get_flag(payload, protocol::REPORT_DISP_F_BYTE, protocol::TEMREC_MASK) ? TEMREC1[field] : TEMREC0[field];
+}
+
+float decode_room_temperature(const uint8_t *payload)
+{
+    /* the unit sends it with 40 added */
+    return (float) (payload[protocol::REPORT_TEMP_ACT_BYTE] - 40);
+}
+
+void encode_fan_mode(uint8_t *payload, uint8_t fan)
+{
+    const FanEncoding &enc = FAN_ENCODINGS[fan < FAN_MODE_OPTIONS_COUNT ? fan : 0];
+    /* speed1 stays 0: the unit fills it in its reports */
+    set_field(payload, protocol::REPORT_FAN_SPD2_BYTE, protocol::REPORT_FAN_SPD2_MASK, protocol::REPORT_FAN_SPD2_POS,
+              enc.speed2);
+    set_flag(payload, protocol::REPORT_FAN_QUIET_BYTE, protocol::REPORT_FAN_QUIET_MASK, enc.quiet);
+    set_flag(payload, protocol::REPORT_FAN_TURBO_BYTE, protocol::REPORT_FAN_TURBO_MASK, enc.turbo);
+}
+
+uint8_t decode_fan_mode(const uint8_t *payload)
+{
+    FanEncoding enc = {
+        get_field(payload, protocol::REPORT_FAN_SPD1_BYTE, protocol::REPORT_FAN_SPD1_MASK, protocol::REPORT_FAN_SPD1_POS),
+        get_field(payload, protocol::REPORT_FAN_SPD2_BYTE, protocol::REPORT_FAN_SPD2_MASK, protocol::REPORT_FAN_SPD2_POS),
+        get_flag(payload, protocol::REPORT_FAN_QUIET_BYTE, protocol::REPORT_FAN_QUIET_MASK),
+        get_flag(payload, protocol::REPORT_FAN_TURBO_BYTE, protocol::REPORT_FAN_TURBO_MASK),
+    };
+    for (uint8_t i = 0; i < FAN_MODE_OPTIONS_COUNT; i++)
+    {
+        const FanEncoding &known = FAN_ENCODINGS[i];
+        if (known.speed1 == enc.speed1 && known.speed2 == enc.speed2 && known.quiet == enc.quiet && known.turbo == enc.turbo)
+            return i;
+    }
+    return FAN_MODE_OPTIONS_COUNT;
+}
+
+void encode_vertical_swing(uint8_t *payload, uint8_t swing)
+{
+    set_field(payload, protocol::REPORT_VSWING_BYTE, protocol::REPORT_VSWING_MASK, protocol::REPORT_VSWING_POS,
+              VERTICAL_SWING_CODES[swing < VERTICAL_SWING_OPTIONS_COUNT ? swing : 0]);
+}
+
+uint8_t decode_vertical_swing(const uint8_t *payload)
+{
+    uint8_t code = get_field(payload, protocol::REPORT_VSWING_BYTE, protocol::REPORT_VSWING_MASK, protocol::REPORT_VSWING_POS);
+    return code_index(VERTICAL_SWING_CODES, VERTICAL_SWING_OPTIONS_COUNT, code);
+}
+
+void encode_horizontal_swing(uint8_t *payload, uint8_t swing)
+{
+    set_field(payload, protocol::REPORT_HSWING_BYTE, protocol::REPORT_HSWING_MASK, protocol::REPORT_HSWING_POS,
+              HORIZONTAL_SWING_CODES[swing < HORIZONTAL_SWING_OPTIONS_COUNT ? swing : 0]);
+}
+
+uint8_t decode_horizontal_swing(const uint8_t *payload)
+{
+    uint8_t code = get_field(payload, protocol::REPORT_HSWING_BYTE, protocol::REPORT_HSWING_MASK, protocol::REPORT_HSWING_POS);
+    return code_index(HORIZONTAL_SWING_CODES, HORIZONTAL_SWING_OPTIONS_COUNT, code);
+}
+
+void encode_display(uint8_t *payload, bool on, uint8_t mode)
+{
+    /* DISPLAY_OPTIONS[0] is OFF, the modes follow it */
+    uint8_t code = (mode >= 1 && mode < DISPLAY_OPTIONS_COUNT) ? DISPLAY_MODE_CODES[mode - 1] : protocol::REPORT_DISP_MODE_AUTO;
+    set_field(payload, protocol::REPORT_DISP_MODE_BYTE, protocol::REPORT_DISP_MODE_MASK, protocol::REPORT_DISP_MODE_POS, code);
+    set_flag(payload, protocol::REPORT_DISP_ON_BYTE, protocol::REPORT_DISP_ON_MASK, on);
+}
+
+bool decode_display_on(const uint8_t *payload)
+{
+    return get_flag(payload, protocol::REPORT_DISP_ON_BYTE, protocol::REPORT_DISP_ON_MASK);
+}
+
+uint8_t decode_display_mode(const uint8_t *payload)
+{
+    uint8_t code = get_field(payload, protocol::REPORT_DISP_MODE_BYTE, protocol::REPORT_DISP_MODE_MASK,
+                             protocol::REPORT_DISP_MODE_POS);
+    return code_index(DISPLAY_MODE_CODES, DISPLAY_OPTIONS_COUNT - 1, code) + 1;
+}
+
+void encode_display_fahrenheit(uint8_t *payload, bool fahrenheit)
+{
+    set_flag(payload, protocol::REPORT_DISP_F_BYTE, protocol::REPORT_DISP_F_MASK, fahrenheit);
+}
+
+bool decode_display_fahrenheit(const uint8_t *payload)
+{
+    return get_flag(payload, protocol::REPORT_DISP_F_BYTE, protocol::REPORT_DISP_F_MASK);
+}
+
+void encode_plasma(uint8_t *payload, bool plasma)
+{
+    set_flag(payload, protocol::REPORT_PLASMA1_BYTE, protocol::REPORT_PLASMA1_MASK, plasma);
+    set_flag(payload, protocol::REPORT_PLASMA2_BYTE, protocol::REPORT_PLASMA2_MASK, plasma);
+}
+
+bool decode_plasma(const uint8_t *payload)
+{
+    return get_flag(payload, protocol::REPORT_PLASMA1_BYTE, protocol::REPORT_PLASMA1_MASK) ||
+           get_flag(payload, protocol::REPORT_PLASMA2_BYTE, protocol::REPORT_PLASMA2_MASK);
+}
+
+void encode_beeper(uint8_t *payload, bool beeper)
+{
+    set_flag(payload, protocol::REPORT_BEEPER_BYTE, protocol::REPORT_BEEPER_MASK, !beeper);
+}
+
+bool decode_beeper(const uint8_t *payload)
+{
+    return !get_flag(payload, protocol::REPORT_BEEPER_BYTE, protocol::REPORT_BEEPER_MASK);
+}
+
+void encode_sleep(uint8_t *payload, bool sleep) { set_flag(payload, protocol::REPORT_SLEEP_BYTE, protocol::REPORT_SLEEP_MASK, sleep); }
+
+bool decode_sleep(const uint8_t *payload) { return get_flag(payload, protocol::REPORT_SLEEP_BYTE, protocol::REPORT_SLEEP_MASK); }
+
+void encode_xfan(uint8_t *payload, bool xfan) { set_flag(payload, protocol::REPORT_XFAN_BYTE, protocol::REPORT_XFAN_MASK, xfan); }
+
+bool decode_xfan(const uint8_t *payload) { return get_flag(payload, protocol::REPORT_XFAN_BYTE, protocol::REPORT_XFAN_MASK); }
+
+void encode_save(uint8_t *payload, bool save) { set_flag(payload, protocol::REPORT_SAVE_BYTE, protocol::REPORT_SAVE_MASK, save); }
+
+bool decode_save(const uint8_t *payload) { return get_flag(payload, protocol::REPORT_SAVE_BYTE, protocol::REPORT_SAVE_MASK); }
+
+}  // namespace codec
+}  // namespace CNT
+}  // namespace sinclair_ac
+}  // namespace esphome
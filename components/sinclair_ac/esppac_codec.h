@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esppac_options.h"
+#include "esppac_protocol.h"
+
+/* Field encoders and decoders for the 45-byte SET payload and unit report, shared by
+   send_packet() and the determine_*() decoders. Only standard headers, so host tools like
+   scripts/sinclair_roundtrip.cpp run the exact code the component does. Every encoder clears
+   its own bits first, so a field can be rewritten in place. Select-like fields travel as
+   indexes into the option tables in esppac_options.h: the tables are static, so every
+   translation unit has its own copy and pointers into them do not compare across files. A
+   decoder returns the table's count for a value the table does not know. */
+
+namespace esphome {
+namespace sinclair_ac {
+namespace CNT {
+namespace codec {
+
+/* Setpoints the AC reports, indexed by the 4-bit field and split by the Temrec bit. They are
+   the Fahrenheit steps converted to Celsius, 0 marks combinations that can not happen. */
+extern const float TEMREC0[16];
+extern const float TEMREC1[16];
+
+/* How the unit represents each FAN_MODE_OPTIONS entry, same order */
+struct FanEncoding {
+    uint8_t speed1;  /* REPORT_FAN_SPD1, only reported by the unit */
+    uint8_t speed2;  /* REPORT_FAN_SPD2 */
+    bool quiet;
+    bool turbo;
+};
+extern const FanEncoding FAN_ENCODINGS[FAN_MODE_OPTIONS_COUNT];
+
+/* Wire values of VERTICAL_SWING_OPTIONS, HORIZONTAL_SWING_OPTIONS and the DISPLAY_OPTIONS
+   after OFF, same order */
+extern const uint8_t VERTICAL_SWING_CODES[VERTICAL_SWING_OPTIONS_COUNT];
+extern const uint8_t HORIZONTAL_SWING_CODES[HORIZONTAL_SWING_OPTIONS_COUNT];
+extern const uint8_t DISPLAY_MODE_CODES[DISPLAY_OPTIONS_COUNT - 1];
+
+/* Index of name in table by content, fallback when it is not there */
+uint8_t option_index(const char *const *table, uint8_t count, const char *name, uint8_t fallback);
+
+/* FAN_MODE_OPTIONS index of a fan mode given by either its FAN_MODE_OPTIONS name or the
+   CUSTOM_FAN_MODES name the traits advertise, FAN_MODE_OPTIONS_COUNT when it is neither */
+uint8_t fan_mode_index(const char *name);
+
+/* mode is a protocol::REPORT_MODE_* value */
+void encode_power_mode(uint8_t *payload, bool power, uint8_t mode);
+bool decode_power(const uint8_t *payload);
+/* Raw 3-bit mode field, values above REPORT_MODE_HEAT are unknown */
+uint8_t decode_mode(const uint8_t *payload);
+
+/* The field carries round(target) + offset, the Temrec bit marks a target just above it */
+void encode_target_temperature(uint8_t *payload, float target, int8_t offset = 0);
+/* With the offset taken out again, 0 when the field holds nothing valid */
+float decode_target_temperature(const uint8_t *payload, int8_t offset = 0);
+
+/* Room temperature in whole degrees, reports only */
+float decode_room_temperature(const uint8_t *payload);
+
+/* A SET frame only carries speed2 and the quiet/turbo bits, an index out of range encodes as auto */
+void encode_fan_mode(uint8_t *payload, uint8_t fan);
+uint8_t decode_fan_mode(const uint8_t *payload);
+
+/* An index out of range encodes as OFF */
+void encode_vertical_swing(uint8_t *payload, uint8_t swing);
+uint8_t decode_vertical_swing(const uint8_t *payload);
+void encode_horizontal_swing(uint8_t *payload, uint8_t swing);
+uint8_t decode_horizontal_swing(const uint8_t *payload);
+
+/* mode indexes DISPLAY_OPTIONS, anything but AUTO/SET/ACT/OUT encodes as AUTO. Turning the
+   display off keeps the mode, so the two are separate fields. */
+void encode_display(uint8_t *payload, bool on, uint8_t mode);
+bool decode_display_on(const uint8_t *payload);
+uint8_t decode_display_mode(const uint8_t *payload);
+
+void encode_display_fahrenheit(uint8_t *payload, bool fahrenheit);
+bool decode_display_fahrenheit(const uint8_t *payload);
+
+void encode_plasma(uint8_t *payload, bool plasma);
+bool decode_plasma(const uint8_t *payload);
+/* The bit is set to silence the beeper */
+void encode_beeper(uint8_t *payload, bool beeper);
+bool decode_beeper(const uint8_t *payload);
+void encode_sleep(uint8_t *payload, bool sleep);
+bool decode_sleep(const uint8_t *payload);
+void encode_xfan(uint8_t *payload, bool xfan);
+bool decode_xfan(const uint8_t *payload);
+void encode_save(uint8_t *payload, bool save);
+bool decode_save(const uint8_t *payload);
+
+}  // namespace codec
+}  // namespace CNT
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,86 @@
+#include "esppac_compensation.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace sinclair_ac {
+
+bool SetpointCompensator::update(float setpoint, float measured, int8_t low, int8_t high, uint32_t now)
+{
+    if (low < -this->max_offset_)
+        low = -this->max_offset_;
+    if (high > this->max_offset_)
+        high = this->max_offset_;
+
+    /* the user moved the setpoint close to the AC's limits, the offset has to follow at once */
+    int8_t previous = this->offset_;
+    if (this->offset_ < low)
+        this->offset_ = low;
+    else if (this->offset_ > high)
+        this->offset_ = high;
+
+    if (!this->running_)
+    {
+        this->running_ = true;
+        this->last_sample_ = now;
+    }
+    else if (now - this->last_sample_ >= this->interval_)
+    {
+        float hours = (now - this->last_sample_) / 3600000.0f;
+        this->last_sample_ = now;
+
+        float error = setpoint - measured;
+        float limit = this->max_offset_;
+        float unclamped = this->kp_ * error + this->ki_ * (this->integral_ + error * hours);
+        /* anti-windup: do not integrate further into saturation */
+        if (!(unclamped > limit && error > 0) && !(unclamped < -limit && error < 0))
+            this->integral_ += error * hours;
+        if (this->ki_ > 0)
+        {
+            float max_integral = limit / this->ki_;
+            if (this->integral_ > max_integral)
+                this->integral_ = max_integral;
+            else if (this->integral_ < -max_integral)
+                this->integral_ = -max_integral;
+        }
+        this->output_ = this->kp_ * error + this->ki_ * this->integral_;
+
+        bool hold_passed = !this->changed_once_ || now - this->last_change_ >= this->min_hold_;
+        if (hold_passed && std::fabs(this->output_ - this->offset_) >= COMP_HYSTERESIS)
+        {
+            int8_t step = this->output_ > this->offset_ ? 1 : -1;
+            int8_t next = this->offset_ + step;
+            if (next >= low && next <= high)
+                this->offset_ = next;
+        }
+    }
+
+    if (this->offset_ == previous)
+        return false;
+    this->last_change_ = now;
+    this->changed_once_ = true;
+    this->changes_++;
+    return true;
+}
+
+bool SetpointCompensator::reset()
+{
+    bool changed = this->offset_ != 0;
+    this->offset_ = 0;
+    this->integral_ = 0;
+    this->output_ = 0;
+    this->running_ = false;
+    return changed;
+}
+
+void SetpointCompensator::restore(int8_t offset, uint32_t now)
+{
+    this->offset_ = offset;
+    this->integral_ = this->ki_ > 0 ? offset / this->ki_ : 0;
+    this->output_ = offset;
+    this->last_change_ = now;
+    this->changed_once_ = true;
+}
+
+}  // namespace sinclair_ac
+}  // namespace esphome
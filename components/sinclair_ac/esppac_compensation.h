@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace sinclair_ac {
+
+static const float COMP_DEFAULT_KP = 0.5f;                // Offset degrees per degree of error
+static const float COMP_DEFAULT_KI = 1.0f;                // Offset degrees per degree-hour of error
+static const int8_t COMP_DEFAULT_MAX_OFFSET = 2;          // Whole degrees either way
+static const uint32_t COMP_DEFAULT_INTERVAL_MS = 60000;   // Controller sample period
+static const uint32_t COMP_DEFAULT_MIN_HOLD_MS = 600000;  // An offset is kept at least this long, protects the compressor
+static const float COMP_HYSTERESIS = 0.75f;               // The output has to be this far from the offset to move it
+
+/* PI controller that biases the setpoint sent to the AC so an external sensor reaches the
+   user's setpoint while the AC regulates on its own return air sensor. The output is a whole
+   degree offset, since that is what the SET frame carries. It moves by one degree at a time,
+   at most once per min_hold and only when the controller output is past the hysteresis.
+   The integral is frozen while the output is saturated. */
+class SetpointCompensator {
+    public:
+        void set_gains(float kp, float ki)
+        {
+            this->kp_ = kp;
+            this->ki_ = ki;
+        }
+        void set_max_offset(int8_t max_offset) { this->max_offset_ = max_offset; }
+        void set_interval(uint32_t interval_ms) { this->interval_ = interval_ms; }
+        void set_min_hold(uint32_t hold_ms) { this->min_hold_ = hold_ms; }
+
+        /* Runs one sample when the interval has passed. low and high bound the offset so the
+           biased setpoint stays within what the AC accepts. True when offset() changed. */
+        bool update(float setpoint, float measured, int8_t low, int8_t high, uint32_t now);
+        /* Back to no offset with an empty integral, true when offset() changed */
+        bool reset();
+        /* Continues from an offset the AC already runs with, the integral is set to hold it */
+        void restore(int8_t offset, uint32_t now);
+
+        int8_t offset() const { return this->offset_; }
+        float output() const { return this->output_; }
+        uint32_t changes() const { return this->changes_; }
+
+    protected:
+        float kp_ = COMP_DEFAULT_KP;
+        float ki_ = COMP_DEFAULT_KI;
+        int8_t max_offset_ = COMP_DEFAULT_MAX_OFFSET;
+        uint32_t interval_ = COMP_DEFAULT_INTERVAL_MS;
+        uint32_t min_hold_ = COMP_DEFAULT_MIN_HOLD_MS;
+
+        float integral_ = 0;       // Degree-hours
+        float output_ = 0;         // Last unquantized controller output
+        int8_t offset_ = 0;
+        bool running_ = false;     // A first sample was taken since the last reset
+        uint32_t last_sample_ = 0;
+        uint32_t last_change_ = 0;
+        bool changed_once_ = false;
+        uint32_t changes_ = 0;
+};
+
+}  // namespace sinclair_ac
+}  // namespace esphome
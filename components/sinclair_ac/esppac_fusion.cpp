@@ -0,0 +1,109 @@
+#include "esppac_fusion.h"
+
+namespace esphome {
+namespace sinclair_ac {
+
+uint8_t TemperatureFusion::add_source(uint32_t timeout_ms, float weight)
+{
+    if (this->count_ >= FUSION_MAX_SOURCES)
+        return FUSION_MAX_SOURCES;
+
+    FusionSource &source = this->sources_[this->count_];
+    source.timeout_ms = timeout_ms;
+    source.weight = weight;
+    return this->count_++;
+}
+
+void TemperatureFusion::update(uint8_t source, float value, uint32_t now)
+{
+    if (source >= this->count_ || std::isnan(value))
+        return;
+
+    FusionSource &s = this->sources_[source];
+    s.value = value;
+    s.updated = now;
+    s.fresh = true;
+    s.readings++;
+}
+
+uint8_t TemperatureFusion::expire(uint32_t now)
+{
+    uint8_t expired = 0;
+    for (uint8_t i = 0; i < this->count_; i++)
+    {
+        FusionSource &s = this->sources_[i];
+        if (s.fresh && now - s.updated > s.timeout_ms)
+        {
+            s.fresh = false;
+            s.rejected = false;
+            s.timeouts++;
+            expired++;
+        }
+    }
+    return expired;
+}
+
+float TemperatureFusion::fuse(uint32_t now)
+{
+    /* median of the fresh values, insertion sort over at most FUSION_MAX_SOURCES entries */
+    float sorted[FUSION_MAX_SOURCES];
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < this->count_; i++)
+    {
+        if (!this->sources_[i].fresh)
+            continue;
+        uint8_t j = n++;
+        for (; j > 0 && sorted[j - 1] > this->sources_[i].value; j--)
+            sorted[j] = sorted[j - 1];
+        sorted[j] = this->sources_[i].value;
+    }
+    if (n == 0)
+        return NAN;
+    float median = (n % 2) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+
+    /* with two sources there is no telling which one is wrong, a source already rejected
+       stays out for as long as it disagrees with the other one */
+    float sum = 0, weights = 0, plain = 0;
+    uint8_t used = 0;
+    for (uint8_t i = 0; i < this->count_; i++)
+    {
+        FusionSource &s = this->sources_[i];
+        if (!s.fresh)
+            continue;
+
+        float deviation = std::fabs(s.value - median);
+        bool outlier = (n >= 3 && deviation > this->outlier_) ||
+                       (n == 2 && s.rejected && 2 * deviation > this->outlier_);
+        if (outlier && !s.rejected)
+            s.rejections++;
+        s.rejected = outlier;
+        if (outlier)
+            continue;
+
+        uint32_t age = now - s.updated;
+        float w = s.weight * (1.0f - (float) age / (float) (s.timeout_ms + 1));
+        sum += s.value * w;
+        weights += w;
+        plain += s.value;
+        used++;
+    }
+    /* the sources split into groups with nothing in the middle, no group wins */
+    if (used == 0)
+        return median;
+    /* all remaining weights faded to zero, fall back to the plain mean */
+    if (weights <= 0)
+        return plain / used;
+    return sum / weights;
+}
+
+uint8_t TemperatureFusion::fresh_count() const
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < this->count_; i++)
+        if (this->sources_[i].fresh)
+            n++;
+    return n;
+}
+
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace sinclair_ac {
+
+static const uint8_t FUSION_MAX_SOURCES = 4;
+static const float FUSION_DEFAULT_OUTLIER = 3.0f;   // Degrees away from the median of the fresh sources
+static const float FUSION_DEFAULT_DEADBAND = 0.1f;  // Smaller moves of the fused value are not published
+
+struct FusionSource {
+    float value = NAN;
+    uint32_t updated = 0;      // Time of the last reading
+    uint32_t timeout_ms = 0;   // The source drops out when its last reading is older
+    float weight = 1.0f;
+    bool fresh = false;
+    bool rejected = false;     // Too far from the others at the last fusion
+    uint32_t readings = 0;
+    uint32_t rejections = 0;
+    uint32_t timeouts = 0;
+};
+
+/* Fuses up to FUSION_MAX_SOURCES external temperature readings. Each fresh source counts
+   with its weight scaled down linearly from its last reading to its timeout, so a sensor
+   that stopped reporting fades out instead of dropping out at once. With three or more
+   fresh sources, the ones too far from the median are left out, and stay out while they
+   disagree with the last source left. Every call works on at most FUSION_MAX_SOURCES
+   entries. */
+class TemperatureFusion {
+    public:
+        /* Index of the new source, FUSION_MAX_SOURCES when all slots are taken */
+        uint8_t add_source(uint32_t timeout_ms, float weight);
+        void set_outlier_threshold(float threshold) { this->outlier_ = threshold; }
+
+        /* Records a reading, NAN (sensor unavailable) is ignored */
+        void update(uint8_t source, float value, uint32_t now);
+        /* Marks sources without a reading for their timeout as stale, returns how many just went stale */
+        uint8_t expire(uint32_t now);
+        /* Weighted mean of the fresh sources that are not outliers, NAN when none is fresh */
+        float fuse(uint32_t now);
+
+        uint8_t size() const { return this->count_; }
+        uint8_t fresh_count() const;
+        const FusionSource &source(uint8_t source) const { return this->sources_[source]; }
+
+    protected:
+        FusionSource sources_[FUSION_MAX_SOURCES];
+        uint8_t count_ = 0;
+        float outlier_ = FUSION_DEFAULT_OUTLIER;
+};
+
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,90 @@
+#include "esppac_governor.h"
+
+namespace esphome {
+namespace sinclair_ac {
+
+void PublishGovernor::set_rate_limit(uint16_t per_second)
+{
+    this->rate_ = per_second;
+    this->tokens_milli_ = per_second * 1000u;
+}
+
+bool PublishGovernor::request(PublishEntity entity, uint32_t now)
+{
+    if (!interval_passed_(entity, now))
+    {
+        this->stats_[entity].deferred++;
+        this->pending_ |= 1u << entity;
+        return false;
+    }
+    if (!take_token_(now))
+    {
+        this->stats_[entity].throttled++;
+        this->pending_ |= 1u << entity;
+        return false;
+    }
+    mark_published_(entity, now);
+    return true;
+}
+
+PublishEntity PublishGovernor::next_due(uint32_t now)
+{
+    if (this->pending_ == 0)
+        return PUB_ENTITY_COUNT;
+
+    for (uint8_t i = 0; i < PUB_ENTITY_COUNT; i++)
+    {
+        PublishEntity entity = static_cast<PublishEntity>(i);
+        if ((this->pending_ & (1u << i)) == 0 || !interval_passed_(entity, now))
+            continue;
+        if (!take_token_(now))
+            return PUB_ENTITY_COUNT;
+        mark_published_(entity, now);
+        return entity;
+    }
+    return PUB_ENTITY_COUNT;
+}
+
+uint32_t PublishGovernor::suppressed() const
+{
+    uint32_t total = 0;
+    for (const PublishStats &s : this->stats_)
+        total += s.unchanged + s.deferred + s.throttled;
+    return total;
+}
+
+bool PublishGovernor::interval_passed_(PublishEntity entity, uint32_t now) const
+{
+    if ((this->published_ & (1u << entity)) == 0)
+        return true;
+    return now - this->last_[entity] >= this->min_interval_[entity];
+}
+
+bool PublishGovernor::take_token_(uint32_t now)
+{
+    if (this->rate_ == 0)
+        return true;
+
+    /* refill by elapsed time, capped at one second's worth */
+    uint32_t cap = this->rate_ * 1000u;
+    uint32_t elapsed = now - this->refilled_;
+    this->refilled_ = now;
+    uint32_t refill = elapsed >= 1000 ? cap : elapsed * this->rate_;
+    this->tokens_milli_ = this->tokens_milli_ + refill > cap ? cap : this->tokens_milli_ + refill;
+
+    if (this->tokens_milli_ < 1000)
+        return false;
+    this->tokens_milli_ -= 1000;
+    return true;
+}
+
+void PublishGovernor::mark_published_(PublishEntity entity, uint32_t now)
+{
+    this->last_[entity] = now;
+    this->pending_ &= ~(1u << entity);
+    this->published_ |= 1u << entity;
+    this->stats_[entity].published++;
+}
+
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace sinclair_ac {
+
+/* Everything the component publishes to the API */
+enum PublishEntity : uint8_t {
+    PUB_CLIMATE = 0,
+    PUB_AC_INDOOR_TEMP,
+    PUB_VERTICAL_SWING,
+    PUB_HORIZONTAL_SWING,
+    PUB_DISPLAY,
+    PUB_DISPLAY_UNIT,
+    PUB_TEMP_SOURCE,
+    PUB_PLASMA,
+    PUB_BEEPER,
+    PUB_SLEEP,
+    PUB_XFAN,
+    PUB_SAVE,
+    PUB_ENTITY_COUNT,
+};
+
+struct PublishStats {
+    uint32_t published = 0;
+    uint32_t unchanged = 0;  // Skipped, the entity already shows the value
+    uint32_t deferred = 0;   // Held back by the entity's minimum interval
+    uint32_t throttled = 0;  // Held back by the global budget
+};
+
+/* Decides whether a publish may go out now. Held back publishes are not lost: the entity
+   is marked pending and next_due() hands it back once it is allowed, the caller then
+   publishes whatever the current state is. */
+class PublishGovernor {
+    public:
+        void set_min_interval(PublishEntity entity, uint32_t interval_ms) { this->min_interval_[entity] = interval_ms; }
+        /* Updates per second across all entities, 0 for no limit. Bursts up to one second's worth. */
+        void set_rate_limit(uint16_t per_second);
+
+        /* True when the caller should publish now */
+        bool request(PublishEntity entity, uint32_t now);
+        /* The entity already shows the value, a publish still pending for it is moot */
+        void unchanged(PublishEntity entity)
+        {
+            this->stats_[entity].unchanged++;
+            this->pending_ &= ~(1u << entity);
+        }
+        bool published_once(PublishEntity entity) const { return (this->published_ & (1u << entity)) != 0; }
+        /* A pending entity that may be published now, PUB_ENTITY_COUNT when there is none */
+        PublishEntity next_due(uint32_t now);
+        bool has_pending() const { return this->pending_ != 0; }
+
+        const PublishStats &stats(PublishEntity entity) const { return this->stats_[entity]; }
+        uint32_t suppressed() const;
+
+    protected:
+        bool interval_passed_(PublishEntity entity, uint32_t now) const;
+        bool take_token_(uint32_t now);
+        void mark_published_(PublishEntity entity, uint32_t now);
+
+        uint32_t min_interval_[PUB_ENTITY_COUNT] = {0};
+        uint32_t last_[PUB_ENTITY_COUNT] = {0};
+        PublishStats stats_[PUB_ENTITY_COUNT];
+        uint16_t pending_ = 0;    // One bit per entity
+        uint16_t published_ = 0;  // One bit per entity, the first publish is never held back
+
+        uint16_t rate_ = 0;
+        uint32_t tokens_milli_ = 0;  // Budget in thousandths of a publish
+        uint32_t refilled_ = 0;
+};
+
+static_assert(PUB_ENTITY_COUNT <= 16, "pending_ and published_ hold one bit per entity");
+
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace sinclair_ac {
+
+/* Option tables for the select entities and fan modes. This is the only definition:
+   climate.py reads every *_OPTIONS table below when validating the config, so keep
+   one quoted string per line. The tables are constexpr and live in flash. */
+
+static constexpr const char *const FAN_MODE_OPTIONS[] = {
+    "0 - Auto",
+    "1 - Quiet",
+    "2 - Low",
+    "3 - Medium-Low",
+    "4 - Medium",
+    "5 - Medium-High",
+    "6 - High",
+    "7 - Turbo",
+};
+
+/* Custom fan mode names advertised in the climate traits, same order as FAN_MODE_OPTIONS */
+static constexpr const char *const CUSTOM_FAN_MODES[] = {
+    "FAN_AUTO",
+    "FAN_QUIET",
+    "FAN_LOW",
+    "FAN_MEDL",
+    "FAN_MED",
+    "FAN_MEDH",
+    "FAN_HIGH",
+    "FAN_TURBO",
+};
+
+static constexpr const char *const HORIZONTAL_SWING_OPTIONS[] = {
+    "0 - OFF",
+    "1 - Swing - Full",
+    "2 - Constant - Left",
+    "3 - Constant - Mid-Left",
+    "4 - Constant - Middle",
+    "5 - Constant - Mid-Right",
+    "6 - Constant - Right",
+};
+
+static constexpr const char *const VERTICAL_SWING_OPTIONS[] = {
+    "00 - OFF",
+    "01 - Swing - Full",
+    "02 - Swing - Down",
+    "03 - Swing - Mid-Down",
+    "04 - Swing - Middle",
+    "05 - Swing - Mid-Up",
+    "06 - Swing - Up",
+    "07 - Constant - Down",
+    "08 - Constant - Mid-Down",
+    "09 - Constant - Middle",
+    "10 - Constant - Mid-Up",
+    "11 - Constant - Up",
+};
+
+static constexpr const char *const DISPLAY_OPTIONS[] = {
+    "0 - OFF",
+    "1 - Auto",
+    "2 - Set temperature",
+    "3 - Actual temperature",
+    "4 - Outside temperature",
+};
+
+static constexpr const char *const DISPLAY_UNIT_OPTIONS[] = {
+    "C",
+    "F",
+};
+
+static constexpr const char *const TEMP_SOURCE_OPTIONS[] = {
+    "AC Own Sensor",
+    "External ATC Sensor",
+    "ATC Fail",
+};
+
+static constexpr uint8_t FAN_MODE_OPTIONS_COUNT         = sizeof(FAN_MODE_OPTIONS) / sizeof(FAN_MODE_OPTIONS[0]);
+static constexpr uint8_t HORIZONTAL_SWING_OPTIONS_COUNT = sizeof(HORIZONTAL_SWING_OPTIONS) / sizeof(HORIZONTAL_SWING_OPTIONS[0]);
+static constexpr uint8_t VERTICAL_SWING_OPTIONS_COUNT   = sizeof(VERTICAL_SWING_OPTIONS) / sizeof(VERTICAL_SWING_OPTIONS[0]);
+static constexpr uint8_t DISPLAY_OPTIONS_COUNT          = sizeof(DISPLAY_OPTIONS) / sizeof(DISPLAY_OPTIONS[0]);
+static constexpr uint8_t DISPLAY_UNIT_OPTIONS_COUNT     = sizeof(DISPLAY_UNIT_OPTIONS) / sizeof(DISPLAY_UNIT_OPTIONS[0]);
+static constexpr uint8_t TEMP_SOURCE_OPTIONS_COUNT      = sizeof(TEMP_SOURCE_OPTIONS) / sizeof(TEMP_SOURCE_OPTIONS[0]);
+
+namespace fan_modes{
+    static constexpr const char *const FAN_AUTO  = FAN_MODE_OPTIONS[0];
+    static constexpr const char *const FAN_QUIET = FAN_MODE_OPTIONS[1];
+    static constexpr const char *const FAN_LOW   = FAN_MODE_OPTIONS[2];
+    static constexpr const char *const FAN_MEDL  = FAN_MODE_OPTIONS[3];
+    static constexpr const char *const FAN_MED   = FAN_MODE_OPTIONS[4];
+    static constexpr const char *const FAN_MEDH  = FAN_MODE_OPTIONS[5];
+    static constexpr const char *const FAN_HIGH  = FAN_MODE_OPTIONS[6];
+    static constexpr const char *const FAN_TURBO = FAN_MODE_OPTIONS[7];
+}
+
+namespace horizontal_swing_options{
+    static constexpr const char *const OFF    = HORIZONTAL_SWING_OPTIONS[0];
+    static constexpr const char *const FULL   = HORIZONTAL_SWING_OPTIONS[1];
+    static constexpr const char *const CLEFT  = HORIZONTAL_SWING_OPTIONS[2];
+    static constexpr const char *const CMIDL  = HORIZONTAL_SWING_OPTIONS[3];
+    static constexpr const char *const CMID   = HORIZONTAL_SWING_OPTIONS[4];
+    static constexpr const char *const CMIDR  = HORIZONTAL_SWING_OPTIONS[5];
+    static constexpr const char *const CRIGHT = HORIZONTAL_SWING_OPTIONS[6];
+}
+
+namespace vertical_swing_options{
+    static constexpr const char *const OFF   = VERTICAL_SWING_OPTIONS[0];
+    static constexpr const char *const FULL  = VERTICAL_SWING_OPTIONS[1];
+    static constexpr const char *const DOWN  = VERTICAL_SWING_OPTIONS[2];
+    static constexpr const char *const MIDD  = VERTICAL_SWING_OPTIONS[3];
+    static constexpr const char *const MID   = VERTICAL_SWING_OPTIONS[4];
+    static constexpr const char *const MIDU  = VERTICAL_SWING_OPTIONS[5];
+    static constexpr const char *const UP    = VERTICAL_SWING_OPTIONS[6];
+    static constexpr const char *const CDOWN = VERTICAL_SWING_OPTIONS[7];
+    static constexpr const char *const CMIDD = VERTICAL_SWING_OPTIONS[8];
+    static constexpr const char *const CMID  = VERTICAL_SWING_OPTIONS[9];
+    static constexpr const char *const CMIDU = VERTICAL_SWING_OPTIONS[10];
+    static constexpr const char *const CUP   = VERTICAL_SWING_OPTIONS[11];
+}
+
+namespace display_options{
+    static constexpr const char *const OFF  = DISPLAY_OPTIONS[0];
+    static constexpr const char *const AUTO = DISPLAY_OPTIONS[1];
+    static constexpr const char *const SET  = DISPLAY_OPTIONS[2];
+    static constexpr const char *const ACT  = DISPLAY_OPTIONS[3];
+    static constexpr const char *const OUT  = DISPLAY_OPTIONS[4];
+}
+
+namespace display_unit_options{
+    static constexpr const char *const DEGC = DISPLAY_UNIT_OPTIONS[0];
+    static constexpr const char *const DEGF = DISPLAY_UNIT_OPTIONS[1];
+}
+
+namespace temp_source_options{
+    static constexpr const char *const AC_OWN       = TEMP_SOURCE_OPTIONS[0];
+    static constexpr const char *const EXTERNAL_ATC = TEMP_SOURCE_OPTIONS[1];
+    static constexpr const char *const ATC_FAIL     = TEMP_SOURCE_OPTIONS[2];
+}
+
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,128 @@
+#include "esppac_profile.h"
+
+#ifdef SINCLAIR_AC_PROFILE
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace sinclair_ac {
+namespace profile {
+
+static const char *const TAG = "sinclair_ac.profile";
+
+static const char *const SLOT_NAMES[PROF_SLOT_COUNT] = {
+    "read_data",
+    "verify_packet",
+    "handle_packet",
+    "send_packet",
+    "index_mapper",
+    "pref_save",
+};
+
+ProfileCounter counters[PROF_SLOT_COUNT];
+uint32_t steady_state_allocs = 0;
+
+/* The ESP8266 Arduino core defines operator new itself, replacing it there
+   would not link, so allocations are only counted on ESP32 and host builds. */
+#ifndef USE_ESP8266
+static std::atomic<uint32_t> allocation_count{0};
+
+uint32_t allocations() { return allocation_count.load(std::memory_order_relaxed); }
+#else
+uint32_t allocations() { return 0; }
+#endif
+
+void add_bytes(ProfileSlot slot, uint32_t bytes) { counters[slot].bytes += bytes; }
+
+void reset()
+{
+    std::memset(counters, 0, sizeof(counters));
+    steady_state_allocs = 0;
+}
+
+SteadyStateCheck::~SteadyStateCheck()
+{
+    if (counters[PROF_HANDLE_PACKET].calls <= PROFILE_WARMUP_REPORTS)
+        return;
+
+    uint32_t allocs = allocations() - this->start_allocs_;
+    allocs -= counters[PROF_PREF_SAVE].allocs - this->start_pref_allocs_;
+    if (allocs == 0)
+        return;
+
+    if (steady_state_allocs == 0)
+        ESP_LOGW(TAG, "Heap allocation in steady-state loop (%u allocations)", (unsigned) allocs);
+    steady_state_allocs += allocs;
+}
+
+void dump()
+{
+    if (steady_state_allocs > 0)
+    {
+        ESP_LOGW(TAG, "steady-state allocations since boot: %u", (unsigned) steady_state_allocs);
+    }
+    else if (counters[PROF_HANDLE_PACKET].calls > PROFILE_WARMUP_REPORTS)
+    {
+        ESP_LOGI(TAG, "steady-state allocations since boot: 0");
+    }
+
+    for (uint8_t i = 0; i < PROF_SLOT_COUNT; i++)
+    {
+        const ProfileCounter &c = counters[i];
+        if (c.calls == 0)
+            continue;
+
+        /* micros() resolution, so averages stay in us */
+        float us_per_op = (float) c.total_us / c.calls;
+        float allocs_per_op = (float) c.allocs / c.calls;
+        if (c.bytes > 0)
+        {
+            float us_per_byte = (float) c.total_us / c.bytes;
+            ESP_LOGI(TAG, "%-14s calls=%u us/op=%.1f max_us=%u allocs/op=%.2f bytes=%u us/byte=%.2f", SLOT_NAMES[i],
+                     (unsigned) c.calls, us_per_op, (unsigned) c.max_us, allocs_per_op, (unsigned) c.bytes, us_per_byte);
+        }
+        else
+        {
+            ESP_LOGI(TAG, "%-14s calls=%u us/op=%.1f max_us=%u allocs/op=%.2f", SLOT_NAMES[i], (unsigned) c.calls,
+                     us_per_op, (unsigned) c.max_us, allocs_per_op);
+        }
+    }
+}
+
+}  // namespace profile
+}  // namespace sinclair_ac
+}  // namespace esphome
+
+#ifndef USE_ESP8266
+/* Counting allocator: every C++ heap allocation goes through one of these */
+void *operator new(size_t size)
+{
+    esphome::sinclair_ac::profile::allocation_count.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = std::malloc(size ? size : 1);
+    if (ptr == nullptr)
+        std::abort();
+    return ptr;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    esphome::sinclair_ac::profile::allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+#endif  // USE_ESP8266
+
+#endif  // SINCLAIR_AC_PROFILE
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/core/hal.h"
+
+namespace esphome {
+namespace sinclair_ac {
+
+/* Hot paths measured when the firmware is built with -DSINCLAIR_AC_PROFILE.
+   Timings are inclusive, e.g. HANDLE_PACKET contains the mapper and preference
+   calls done while decoding the report. */
+enum ProfileSlot : uint8_t {
+    PROF_READ_DATA = 0,
+    PROF_VERIFY_PACKET,
+    PROF_HANDLE_PACKET,
+    PROF_SEND_PACKET,
+    PROF_INDEX_MAPPER,
+    PROF_PREF_SAVE,
+    PROF_SLOT_COUNT,
+};
+
+#ifdef SINCLAIR_AC_PROFILE
+
+static const uint32_t PROFILE_DUMP_INTERVAL_MS = 60000;  // How often the counters are logged
+static const uint32_t PROFILE_WARMUP_REPORTS = 10;       // Reports handled before the link counts as steady-state
+
+struct ProfileCounter {
+    uint32_t calls;     // Number of times the slot was entered
+    uint32_t bytes;     // Bytes processed (only used by READ_DATA)
+    uint64_t total_us;  // Accumulated time spent inside the slot
+    uint32_t max_us;    // Worst single call
+    uint32_t allocs;    // Heap allocations done while inside the slot
+};
+
+namespace profile {
+
+extern ProfileCounter counters[PROF_SLOT_COUNT];
+extern uint32_t steady_state_allocs;  // Allocations seen in the component loop after warm-up
+
+/* Number of operator new calls since boot, 0 where the counting allocator is not available */
+uint32_t allocations();
+
+void add_bytes(ProfileSlot slot, uint32_t bytes);
+void dump();
+void reset();
+
+class Scope {
+    public:
+        explicit Scope(ProfileSlot slot) : slot_(slot), start_us_(micros()), start_allocs_(allocations()) {}
+        ~Scope()
+        {
+            uint32_t elapsed = micros() - this->start_us_;
+            ProfileCounter &c = counters[this->slot_];
+            c.calls++;
+            c.total_us += elapsed;
+            if (elapsed > c.max_us)
+                c.max_us = elapsed;
+            c.allocs += allocations() - this->start_allocs_;
+        }
+
+    protected:
+        ProfileSlot slot_;
+        uint32_t start_us_;
+        uint32_t start_allocs_;
+};
+
+/* Wraps one pass of the component loop; once warmed up, a healthy link must not allocate
+   while handling reports or sending keepalives. Preference writes only happen when a setting
+   really changed, so their allocations are not counted. */
+class SteadyStateCheck {
+    public:
+        SteadyStateCheck() : start_allocs_(allocations()), start_pref_allocs_(counters[PROF_PREF_SAVE].allocs) {}
+        ~SteadyStateCheck();
+
+    protected:
+        uint32_t start_allocs_;
+        uint32_t start_pref_allocs_;
+};
+
+}  // namespace profile
+
+#define SINCLAIR_PROFILE_SCOPE(slot) ::esphome::sinclair_ac::profile::Scope sinclair_profile_scope_(slot)
+#define SINCLAIR_PROFILE_BYTES(slot, n) ::esphome::sinclair_ac::profile::add_bytes(slot, n)
+#define SINCLAIR_PROFILE_STEADY_STATE() ::esphome::sinclair_ac::profile::SteadyStateCheck sinclair_profile_steady_state_
+
+#else
+
+#define SINCLAIR_PROFILE_SCOPE(slot)
+#define SINCLAIR_PROFILE_BYTES(slot, n)
+#define SINCLAIR_PROFILE_STEADY_STATE()
+
+#endif  // SINCLAIR_AC_PROFILE
+
+}  // namespace sinclair_ac
+}  // namespace esphome
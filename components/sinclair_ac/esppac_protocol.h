@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* Wire protocol of the indoor unit: framing, what each received command is handled as, byte
+   layout of the report and SET payloads and line timing. Only standard headers, so host tools
+   like scripts/sinclair_emulator.cpp can share it. */
+
+namespace esphome {
+namespace sinclair_ac {
+namespace CNT {
+
+namespace protocol {
+    /* SYNC */
+    static const uint8_t SYNC                = 0x7E;
+    /* packet types */
+    static const uint8_t CMD_IN_UNIT_REPORT  = 0x31;
+    static const uint8_t CMD_OUT_PARAMS_SET  = 0x01;
+    static const uint8_t CMD_OUT_SYNC_TIME   = 0x03;
+    static const uint8_t CMD_OUT_MAC_REPORT  = 0x04; /* 7e 7e 0d 04 04 00 00 00 AA BB CC DD EE FF 00 -> AA BB CC DD EE FF = MAC address */
+    static const uint8_t CMD_OUT_UNKNOWN_1   = 0x02; /* 7e 7e 10 02 00 00 00 00 00 00 01 00 28 1e 19 23 23 00 b8 */
+    static const uint8_t CMD_IN_UNKNOWN_1    = 0x44; /* 7e 7e 1a 44 01 00 01 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 01 */
+    static const uint8_t CMD_IN_UNKNOWN_2    = 0x33; /* 7e 7e 2f 33 00 00 40 00 09 20 19 0a 00 10 00 14 17 5b 08 08 00 00 00 00 00 00 00 00 01 00 00 0d 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 */
+    static const uint8_t FRAME_HEADER_LEN    = 4;    /* SYNC SYNC LEN CMD, payload bytes are counted from here */
+
+    /* byte indexes are AFTER we remove first 4 bytes from the packet (sync, length, type) as well as a checksum */
+    /* unit report packet data fields, for binary values there is no need to define bit offset/position */
+    static const uint8_t REPORT_PWR_BYTE       = 4;
+    static const uint8_t REPORT_PWR_MASK       = 0b10000000;
+
+    static const uint8_t REPORT_MODE_BYTE      = 4;
+    static const uint8_t REPORT_MODE_MASK      = 0b01110000;
+    static const uint8_t REPORT_MODE_POS       = 4;
+    static const uint8_t REPORT_MODE_AUTO          = 0;
+    static const uint8_t REPORT_MODE_COOL          = 1;
+    static const uint8_t REPORT_MODE_DRY           = 2;
+    static const uint8_t REPORT_MODE_FAN           = 3;
+    static const uint8_t REPORT_MODE_HEAT          = 4;
+
+    static const uint8_t REPORT_FAN_SPD1_BYTE  = 18;
+    static const uint8_t REPORT_FAN_SPD1_MASK  = 0b00001111;
+    static const uint8_t REPORT_FAN_SPD1_POS   = 0;
+    static const uint8_t REPORT_FAN_SPD2_BYTE  = 4;
+    static const uint8_t REPORT_FAN_SPD2_MASK  = 0b00000011;
+    static const uint8_t REPORT_FAN_SPD2_POS   = 0;
+    static const uint8_t REPORT_FAN_QUIET_BYTE = 16;
+    static const uint8_t REPORT_FAN_QUIET_MASK = 0b00001000;
+    static const uint8_t REPORT_FAN_TURBO_BYTE = 6;
+    static const uint8_t REPORT_FAN_TURBO_MASK = 0b00000001;
+
+    static const uint8_t REPORT_FAN_MODE_MASK = 0b00000011;
+
+    static const uint8_t REPORT_TEMP_SET_BYTE  = 5;
+    static const uint8_t REPORT_TEMP_SET_MASK  = 0b11110000;
+    static const uint8_t REPORT_TEMP_SET_POS   = 4;
+    static const uint8_t REPORT_TEMP_SET_OFF   = 16; /* temperature offset from value in packet */
+
+    static const uint8_t REPORT_TEMP_ACT_BYTE  = 42;
+    static const uint8_t REPORT_TEMP_ACT_MASK  = 0b11111111;
+    static const uint8_t REPORT_TEMP_ACT_POS   = 0;
+    static const uint8_t REPORT_TEMP_ACT_OFF   = 16;  /* temperature offset from value in packet */
+    static const float   REPORT_TEMP_ACT_DIV   = 2.0; /* temperature divider from value in packet */
+
+    static const uint8_t REPORT_HSWING_BYTE    = 8;
+    static const uint8_t REPORT_HSWING_MASK    = 0b00000111;
+    static const uint8_t REPORT_HSWING_POS     = 0;
+    static const uint8_t REPORT_HSWING_OFF         = 0;
+    static const uint8_t REPORT_HSWING_FULL        = 1;
+    static const uint8_t REPORT_HSWING_CLEFT       = 2;
+    static const uint8_t REPORT_HSWING_CMIDL       = 3;
+    static const uint8_t REPORT_HSWING_CMID        = 4;
+    static const uint8_t REPORT_HSWING_CMIDR       = 5;
+    static const uint8_t REPORT_HSWING_CRIGHT      = 6;
+
+    static const uint8_t REPORT_VSWING_BYTE    = 8;
+    static const uint8_t REPORT_VSWING_MASK    = 0b11110000;
+    static const uint8_t REPORT_VSWING_POS     = 4;
+    static const uint8_t REPORT_VSWING_OFF         = 0;
+    static const uint8_t REPORT_VSWING_FULL        = 1;
+    static const uint8_t REPORT_VSWING_CUP         = 2;
+    static const uint8_t REPORT_VSWING_CMIDU       = 3;
+    static const uint8_t REPORT_VSWING_CMID        = 4;
+    static const uint8_t REPORT_VSWING_CMIDD       = 5;
+    static const uint8_t REPORT_VSWING_CDOWN       = 6;
+    static const uint8_t REPORT_VSWING_DOWN        = 7;
+    static const uint8_t REPORT_VSWING_MIDD        = 8;
+    static const uint8_t REPORT_VSWING_MID         = 9;
+    static const uint8_t REPORT_VSWING_MIDU        = 10;
+    static const uint8_t REPORT_VSWING_UP          = 11;
+
+    static const uint8_t REPORT_DISP_ON_BYTE   = 6;
+    static const uint8_t REPORT_DISP_ON_MASK   = 0b00000010;
+    static const uint8_t REPORT_DISP_MODE_BYTE = 9;
+    static const uint8_t REPORT_DISP_MODE_MASK = 0b00110000;
+    static const uint8_t REPORT_DISP_MODE_POS  = 4;
+    static const uint8_t REPORT_DISP_MODE_AUTO     = 0;
+    static const uint8_t REPORT_DISP_MODE_SET      = 1;
+    static const uint8_t REPORT_DISP_MODE_ACT      = 2;
+    static const uint8_t REPORT_DISP_MODE_OUT      = 3;
+
+    static const uint8_t REPORT_DISP_F_BYTE    = 7;
+    static const uint8_t TEMREC_MASK           = 0b01000000;
+    static const uint8_t REPORT_DISP_F_MASK    = 0b10000000;
+
+    static const uint8_t REPORT_PLASMA1_BYTE   = 6;
+    static const uint8_t REPORT_PLASMA1_MASK   = 0b00000100;
+    static const uint8_t REPORT_PLASMA2_BYTE   = 0;
+    static const uint8_t REPORT_PLASMA2_MASK   = 0b00000100;
+
+    static const uint8_t REPORT_SLEEP_BYTE     = 4;
+    static const uint8_t REPORT_SLEEP_MASK     = 0b00001000;
+
+    static const uint8_t REPORT_XFAN_BYTE      = 6;
+    static const uint8_t REPORT_XFAN_MASK      = 0b00001000;
+
+    static const uint8_t REPORT_SAVE_BYTE      = 11;
+    static const uint8_t REPORT_SAVE_MASK      = 0b01000000;
+
+    static const uint8_t REPORT_BEEPER_BYTE    = 40;
+    static const uint8_t REPORT_BEEPER_MASK    = 0b00000001;
+
+    /* SET packet shares all the byte definition with REPORT */
+    static const uint8_t SET_PACKET_LEN        = 45;
+
+    /* framing: SYNC SYNC LEN CMD <payload> CHECKSUM, LEN counts CMD, payload and CHECKSUM */
+    static const uint8_t FRAME_OVERHEAD        = 5;
+    static const uint8_t FRAME_MAX_LEN         = SET_PACKET_LEN + FRAME_OVERHEAD;
+    
+    static const uint8_t SET_CONST_02_BYTE     = 39;
+    static const uint8_t SET_CONST_02_VAL      = 0x02;
+
+    static const uint8_t SET_AF_BYTE           = 3;
+    static const uint8_t SET_AF_VAL            = 0xAF;
+
+    static const uint8_t SET_NOCHANGE_BYTE     = 11;
+    static const uint8_t SET_NOCHANGE_MASK     = 0b00001000;
+
+    static const uint8_t SET_CONST_BIT_BYTE    = 7;
+    static const uint8_t SET_CONST_BIT_MASK    = 0b00000010;
+
+    /* MAC report payload: 04 00 00 00 <MAC 6 bytes> 00 */
+    static const uint8_t MAC_REPORT_LEN        = 11;
+    static const uint8_t MAC_REPORT_TYPE_BYTE  = 0;
+    static const uint8_t MAC_REPORT_TYPE_VAL   = 0x04;
+    static const uint8_t MAC_REPORT_MAC_BYTE   = 4;
+
+    /* 0x02 payload as sent by the original module, meaning unknown */
+    static const uint8_t UNKNOWN_1_PAYLOAD[]   = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x28, 0x1E, 0x19, 0x23, 0x23, 0x00};
+
+    /* time constraints */
+    static const unsigned long TIME_REFRESH_PERIOD_MS   =  300;
+    static const unsigned long TIME_TIMEOUT_INACTIVE_MS = 1000;
+    static const unsigned long TIME_HANDSHAKE_GAP_MS    =   50; /* between the bring-up frames */
+    static const unsigned long TIME_HANDSHAKE_RETRY_MS  = 2000; /* no report this long after bring-up - start over */
+    static const uint32_t DEFAULT_RESPONSE_TIMEOUT_MS   =  500; /* no report this long after a SET left the wire - retransmit it */
+    static const uint32_t DEFAULT_TX_GUARD_MS           =   40; /* quiet line after a report before we transmit */
+
+    /* line timing: 4800 baud 8E1, start + 8 data + parity + stop bits per byte */
+    static const uint32_t UART_BAUD                     = 4800;
+    static const uint8_t  UART_BITS_PER_BYTE            =   11;
+
+    /* Time a frame of len bytes occupies the line, rounded up (a 50-byte SET frame takes 115 ms) */
+    static constexpr uint32_t wire_time_ms(uint32_t len)
+    {
+        return (len * UART_BITS_PER_BYTE * 1000 + UART_BAUD - 1) / UART_BAUD;
+    }
+    static const uint8_t  DEFAULT_MAX_RETRIES           =    2; /* retransmissions before the frame is given up */
+
+    /* Sum of LEN, CMD and payload modulo 0x100, i.e. every byte but the SYNC bytes and the checksum itself */
+    static inline uint8_t frame_checksum(const uint8_t *frame, size_t len)
+    {
+        uint8_t checksum = 0;
+        for (size_t i = 2; i + 1 < len; i++)
+            checksum += frame[i];
+        return checksum;
+    }
+}
+
+/* What a frame from the AC is handled as, indexed by its command byte */
+enum FrameKind : uint8_t {
+    FRAME_DROP = 0,      /* unknown command, dropped with a warning */
+    FRAME_UNIT_REPORT,
+    FRAME_TELEMETRY,     /* decoded only when a telemetry sensor reads from this command */
+    FRAME_KIND_COUNT,
+};
+
+struct FrameKindTable {
+    uint8_t kind[256];
+    constexpr FrameKindTable() : kind()
+    {
+        kind[protocol::CMD_IN_UNIT_REPORT] = FRAME_UNIT_REPORT;
+        kind[protocol::CMD_IN_UNKNOWN_1] = FRAME_TELEMETRY;
+        kind[protocol::CMD_IN_UNKNOWN_2] = FRAME_TELEMETRY;
+    }
+};
+/* In flash, one lookup per frame instead of a scan */
+static constexpr FrameKindTable FRAME_KINDS{};
+
+}  // namespace CNT
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,154 @@
+#include "esppac_schedule.h"
+
+#include <cstring>
+
+#include "esppac_options.h"
+
+namespace esphome {
+namespace sinclair_ac {
+
+/* Index is the climate::ClimateMode / climate::ClimateSwingMode value */
+static const char *const SCHEDULE_MODE_NAMES[] = {"off", "heat_cool", "cool", "heat", "fan_only", "dry", "auto"};
+static const char *const SCHEDULE_SWING_NAMES[] = {"off", "both", "vertical", "horizontal"};
+
+static const uint8_t ALL_DAYS = 0x7F;
+
+bool Schedule::add(const ScheduleEntry &entry)
+{
+    if (entry.minute >= SCHEDULE_MINUTES_PER_DAY || (entry.days & ALL_DAYS) == 0)
+        return false;
+
+    uint8_t count = this->table_.count;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        ScheduleEntry &existing = this->table_.entries[i];
+        if (existing.minute == entry.minute && existing.days == entry.days)
+        {
+            existing = entry;
+            return true;
+        }
+    }
+    if (count >= SCHEDULE_MAX_ENTRIES)
+        return false;
+
+    /* keep the table sorted by minute, entries of the same minute stay in insertion order */
+    uint8_t i = count;
+    for (; i > 0 && this->table_.entries[i - 1].minute > entry.minute; i--)
+        this->table_.entries[i] = this->table_.entries[i - 1];
+    this->table_.entries[i] = entry;
+    this->table_.entries[i].days &= ALL_DAYS;
+    this->table_.count++;
+
+    seek_(this->minute_);
+    return true;
+}
+
+bool Schedule::remove(uint8_t index)
+{
+    if (index >= this->table_.count)
+        return false;
+
+    for (uint8_t i = index; i + 1 < this->table_.count; i++)
+        this->table_.entries[i] = this->table_.entries[i + 1];
+    this->table_.count--;
+
+    seek_(this->minute_);
+    return true;
+}
+
+void Schedule::clear()
+{
+    this->table_.count = 0;
+    this->cursor_ = 0;
+}
+
+bool Schedule::restore(const ScheduleTable &table)
+{
+    if (table.version != SCHEDULE_VERSION || table.count > SCHEDULE_MAX_ENTRIES)
+        return false;
+    for (uint8_t i = 0; i < table.count; i++)
+    {
+        if (table.entries[i].minute >= SCHEDULE_MINUTES_PER_DAY ||
+            (i > 0 && table.entries[i].minute < table.entries[i - 1].minute))
+            return false;
+    }
+
+    this->table_ = table;
+    seek_(this->minute_);
+    return true;
+}
+
+const ScheduleEntry *Schedule::next_due(uint8_t day, uint16_t minute)
+{
+    if (day != this->day_)
+    {
+        bool first = this->day_ == SCHEDULE_KEEP;
+        this->day_ = day;
+        this->minute_ = minute;
+        if (first)
+        {
+            seek_(minute);
+            return nullptr;
+        }
+        /* a new day starts from its first transition */
+        this->cursor_ = 0;
+    }
+    else if (minute < this->minute_)
+    {
+        seek_(minute);
+    }
+    this->minute_ = minute;
+
+    while (this->cursor_ < this->table_.count && this->table_.entries[this->cursor_].minute <= minute)
+    {
+        const ScheduleEntry *entry = &this->table_.entries[this->cursor_++];
+        if (entry->days & (1u << day))
+            return entry;
+    }
+    return nullptr;
+}
+
+void Schedule::seek_(uint16_t minute)
+{
+    this->cursor_ = 0;
+    while (this->cursor_ < this->table_.count && this->table_.entries[this->cursor_].minute <= minute)
+        this->cursor_++;
+}
+
+static uint8_t index_of(const char *name, const char *const *names, uint8_t count)
+{
+    if (name == nullptr)
+        return SCHEDULE_KEEP;
+    for (uint8_t i = 0; i < count; i++)
+        if (strcmp(name, names[i]) == 0)
+            return i;
+    return SCHEDULE_KEEP;
+}
+
+uint8_t schedule_mode_from_string(const char *mode)
+{
+    return index_of(mode, SCHEDULE_MODE_NAMES, sizeof(SCHEDULE_MODE_NAMES) / sizeof(SCHEDULE_MODE_NAMES[0]));
+}
+
+uint8_t schedule_fan_from_string(const char *fan)
+{
+    return index_of(fan, CUSTOM_FAN_MODES, FAN_MODE_OPTIONS_COUNT);
+}
+
+uint8_t schedule_swing_from_string(const char *swing)
+{
+    return index_of(swing, SCHEDULE_SWING_NAMES, sizeof(SCHEDULE_SWING_NAMES) / sizeof(SCHEDULE_SWING_NAMES[0]));
+}
+
+const char *schedule_mode_to_string(uint8_t mode)
+{
+    return mode < sizeof(SCHEDULE_MODE_NAMES) / sizeof(SCHEDULE_MODE_NAMES[0]) ? SCHEDULE_MODE_NAMES[mode] : "-";
+}
+
+const char *schedule_swing_to_string(uint8_t swing)
+{
+    return swing < sizeof(SCHEDULE_SWING_NAMES) / sizeof(SCHEDULE_SWING_NAMES[0]) ? SCHEDULE_SWING_NAMES[swing] : "-";
+}
+
+}  // namespace sinclair_ac
+}  // namespace esphome
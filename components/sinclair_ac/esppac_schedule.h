@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace sinclair_ac {
+
+static const uint8_t SCHEDULE_MAX_ENTRIES = 32;
+static const uint8_t SCHEDULE_VERSION = 1;      // Bump when the layout changes, a stored table of another layout is dropped
+static const uint8_t SCHEDULE_KEEP = 0xFF;      // Field the entry leaves as it is
+static const uint16_t SCHEDULE_MINUTES_PER_DAY = 1440;
+
+/* One transition. days has bit 0 for Sunday up to bit 6 for Saturday (ESPTime::day_of_week - 1). */
+struct ScheduleEntry {
+    uint16_t minute;     // Minute of the day
+    uint8_t days;
+    uint8_t mode;        // climate::ClimateMode or SCHEDULE_KEEP
+    uint8_t target_x2;   // Setpoint in half degrees or SCHEDULE_KEEP
+    uint8_t fan;         // Index into CUSTOM_FAN_MODES or SCHEDULE_KEEP
+    uint8_t swing;       // climate::ClimateSwingMode or SCHEDULE_KEEP
+    uint8_t reserved;
+};
+
+/* The whole table is one preference blob, entries sorted by minute */
+struct ScheduleTable {
+    uint8_t version;
+    uint8_t count;
+    uint8_t enabled;
+    uint8_t reserved;
+    ScheduleEntry entries[SCHEDULE_MAX_ENTRIES];
+};
+
+/* Weekly schedule. A cursor walks the sorted entries as the day goes by, so each minute
+   costs O(1) amortized: every entry is looked at once a day. */
+class Schedule {
+    public:
+        /* Adds or replaces the entry for the same minute and days, false when it is invalid or the table is full */
+        bool add(const ScheduleEntry &entry);
+        bool remove(uint8_t index);
+        void clear();
+        void set_enabled(bool enabled) { this->table_.enabled = enabled; }
+        /* Takes a stored table, false when it is from another layout or damaged */
+        bool restore(const ScheduleTable &table);
+
+        /* The next entry due on day (0 = Sunday) at or before minute, nullptr once there is none.
+           The first call, a clock going back and edits only reposition, they never fire anything. */
+        const ScheduleEntry *next_due(uint8_t day, uint16_t minute);
+
+        bool enabled() const { return this->table_.enabled != 0; }
+        uint8_t size() const { return this->table_.count; }
+        const ScheduleEntry &entry(uint8_t index) const { return this->table_.entries[index]; }
+        const ScheduleTable &table() const { return this->table_; }
+
+    protected:
+        void seek_(uint16_t minute);
+
+        ScheduleTable table_{SCHEDULE_VERSION, 0, 1, 0, {}};
+        uint8_t cursor_ = 0;
+        uint8_t day_ = SCHEDULE_KEEP;    // Day the cursor is on, SCHEDULE_KEEP before the first call
+        uint16_t minute_ = 0;
+};
+
+/* Names as the climate entity uses them, SCHEDULE_KEEP for "" and names it does not know */
+uint8_t schedule_mode_from_string(const char *mode);
+uint8_t schedule_fan_from_string(const char *fan);
+uint8_t schedule_swing_from_string(const char *swing);
+const char *schedule_mode_to_string(uint8_t mode);
+const char *schedule_swing_to_string(uint8_t swing);
+
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,127 @@
+#include "esppac_stats.h"
+
+#include <cmath>
+
+namespace esphome {
+namespace sinclair_ac {
+
+/* Same values as protocol::REPORT_MODE_COOL / REPORT_MODE_HEAT */
+static const uint8_t MODE_COOL = 1;
+static const uint8_t MODE_HEAT = 4;
+
+void RuntimeStats::add_report(uint32_t now, bool power, uint8_t mode, uint8_t fan, float target, float current)
+{
+    if (mode >= STATS_MODE_COUNT)
+        mode = 0;
+    if (fan >= STATS_FAN_COUNT)
+        fan = 0;
+
+    if (!this->started_)
+    {
+        this->started_ = true;
+        this->last_report_ = now;
+        this->last_power_ = power;
+        this->last_mode_ = mode;
+        this->last_target_ = target;
+        return;
+    }
+
+    uint32_t gap = now - this->last_report_;
+    this->last_report_ = now;
+    if (gap <= STATS_MAX_REPORT_GAP_MS)
+    {
+        this->carry_ms_ += gap;
+        uint32_t seconds = this->carry_ms_ / 1000;
+        if (seconds > 0)
+        {
+            this->carry_ms_ -= seconds * 1000;
+            this->totals_.observed_s += seconds;
+            if (power)
+            {
+                this->totals_.power_on_s += seconds;
+                this->totals_.mode_s[mode] += seconds;
+                this->totals_.fan_s[fan] += seconds;
+            }
+            this->dirty_ = true;
+        }
+    }
+
+    /* a new setpoint, power-on or mode switch starts a new approach */
+    bool target_changed = target != 0 && this->last_target_ != 0 && target != this->last_target_;
+    if (target_changed)
+    {
+        this->totals_.setpoint_changes++;
+        this->dirty_ = true;
+    }
+    if (power && (target_changed || !this->last_power_ || mode != this->last_mode_))
+    {
+        this->approaching_ = !setpoint_reached_(mode, target, current);
+        this->approach_start_ = now;
+    }
+    else if (!power)
+    {
+        this->approaching_ = false;
+    }
+
+    if (this->approaching_ && setpoint_reached_(mode, target, current))
+    {
+        uint32_t took = (now - this->approach_start_) / 1000;
+        this->approaching_ = false;
+        this->totals_.setpoint_reached++;
+        this->totals_.setpoint_reach_total_s += took;
+        this->totals_.setpoint_reach_last_s = took;
+        this->dirty_ = true;
+    }
+
+    this->last_power_ = power;
+    this->last_mode_ = mode;
+    if (target != 0)
+        this->last_target_ = target;
+}
+
+bool RuntimeStats::setpoint_reached_(uint8_t mode, float target, float current) const
+{
+    if (target == 0 || std::isnan(current))
+        return false;
+
+    /* cooling and heating count an overshoot as reached, other modes need to get close */
+    if (mode == MODE_COOL)
+        return current <= target + STATS_SETPOINT_TOLERANCE;
+    if (mode == MODE_HEAT)
+        return current >= target - STATS_SETPOINT_TOLERANCE;
+    return std::fabs(current - target) <= STATS_SETPOINT_TOLERANCE;
+}
+
+bool RuntimeStats::restore(const RuntimeTotals &totals)
+{
+    if (totals.version != RUNTIME_STATS_VERSION)
+        return false;
+
+    this->totals_ = totals;
+    this->dirty_ = false;
+    return true;
+}
+
+float RuntimeStats::setpoint_changes_per_day() const
+{
+    if (this->totals_.observed_s < 3600)
+        return NAN;
+    return this->totals_.setpoint_changes * 86400.0f / this->totals_.observed_s;
+}
+
+float RuntimeStats::time_to_setpoint() const
+{
+    if (this->totals_.setpoint_reached == 0)
+        return NAN;
+    return this->totals_.setpoint_reach_last_s / 60.0f;
+}
+
+float RuntimeStats::mean_time_to_setpoint() const
+{
+    if (this->totals_.setpoint_reached == 0)
+        return NAN;
+    return this->totals_.setpoint_reach_total_s / 60.0f / this->totals_.setpoint_reached;
+}
+
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esppac_options.h"
+
+namespace esphome {
+namespace sinclair_ac {
+
+static const uint16_t RUNTIME_STATS_VERSION = 1;       // Bump when the layout changes
+static const uint8_t STATS_MODE_COUNT = 5;             // Raw report modes: auto, cool, dry, fan, heat
+static const uint8_t STATS_FAN_COUNT = FAN_MODE_OPTIONS_COUNT;
+static const uint32_t STATS_MAX_REPORT_GAP_MS = 5000;  // Longer gaps mean the link was down, they are not counted
+static const float STATS_SETPOINT_TOLERANCE = 0.5f;    // Room temperature this close to the target counts as reached
+static const uint32_t STATS_SAVE_INTERVAL_MS = 900000; // Write-behind period for the totals, 15 minutes
+static const uint32_t STATS_DEFAULT_UPDATE_INTERVAL_MS = 60000;
+
+/* Totals since the counters were first started, persisted with write-behind. Times are seconds. */
+struct RuntimeTotals {
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t observed_s;              // Time with a live link, the base for per-day rates
+    uint32_t power_on_s;
+    uint32_t mode_s[STATS_MODE_COUNT];
+    uint32_t fan_s[STATS_FAN_COUNT];
+    uint32_t setpoint_changes;
+    uint32_t setpoint_reached;        // Completed approaches to a new setpoint
+    uint32_t setpoint_reach_total_s;  // Sum of their durations
+    uint32_t setpoint_reach_last_s;
+};
+
+/* Running min/mean/max over a time window, O(1) per sample */
+struct WindowAggregate {
+    float min;
+    float max;
+    float sum;
+    uint32_t count = 0;  // Reports in the window, a day at ~3 reports/s is far from wrapping
+    uint32_t start = 0;  // Time the window was opened
+
+    void add(float value)
+    {
+        if (this->count == 0 || value < this->min)
+            this->min = value;
+        if (this->count == 0 || value > this->max)
+            this->max = value;
+        this->sum = this->count == 0 ? value : this->sum + value;
+        this->count++;
+    }
+    float mean() const { return this->sum / this->count; }
+    void reset(uint32_t now)
+    {
+        this->count = 0;
+        this->start = now;
+    }
+};
+
+/* Fed with every decoded unit report, each report costs O(1) */
+class RuntimeStats {
+    public:
+        void add_report(uint32_t now, bool power, uint8_t mode, uint8_t fan, float target, float current);
+
+        /* Starts over from persisted totals, false when the layout does not match */
+        bool restore(const RuntimeTotals &totals);
+        const RuntimeTotals &totals() const { return this->totals_; }
+
+        /* Something changed since the last clear_dirty() */
+        bool dirty() const { return this->dirty_; }
+        void clear_dirty() { this->dirty_ = false; }
+
+        float power_on_hours() const { return this->totals_.power_on_s / 3600.0f; }
+        float mode_hours(uint8_t mode) const { return this->totals_.mode_s[mode] / 3600.0f; }
+        float fan_hours(uint8_t fan) const { return this->totals_.fan_s[fan] / 3600.0f; }
+        /* NAN until an hour has been observed */
+        float setpoint_changes_per_day() const;
+        /* Minutes the last approach took, NAN before the first one */
+        float time_to_setpoint() const;
+        float mean_time_to_setpoint() const;
+
+    protected:
+        bool setpoint_reached_(uint8_t mode, float target, float current) const;
+
+        RuntimeTotals totals_{RUNTIME_STATS_VERSION};
+        bool dirty_ = false;
+
+        bool started_ = false;
+        uint32_t last_report_ = 0;
+        uint32_t carry_ms_ = 0;    // Report spacing is not whole seconds, the rest is carried over
+
+        bool last_power_ = false;
+        uint8_t last_mode_ = 0;
+        float last_target_ = 0;
+        bool approaching_ = false;  // Waiting for the room to reach a new setpoint
+        uint32_t approach_start_ = 0;
+};
+
+}  // namespace sinclair_ac
+}  // namespace esphome
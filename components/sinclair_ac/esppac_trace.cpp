@@ -0,0 +1,41 @@
+#include "esppac_trace.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace sinclair_ac {
+
+void FrameTrace::set_capacity(uint16_t capacity)
+{
+    this->entries_.assign(capacity, TraceEntry{});
+    this->entries_.shrink_to_fit();
+    this->clear();
+    this->recorded_ = 0;
+}
+
+void FrameTrace::record(const uint8_t *data, size_t len, bool outgoing, uint32_t timestamp)
+{
+    if (this->entries_.empty())
+        return;
+
+    TraceEntry &entry = this->entries_[this->head_];
+    entry.timestamp = timestamp;
+    entry.len = len > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(len);
+    entry.outgoing = outgoing;
+    std::memcpy(entry.data, data, entry.stored());
+
+    if (++this->head_ == this->entries_.size())
+        this->head_ = 0;
+    if (this->count_ < this->entries_.size())
+        this->count_++;
+    this->recorded_++;
+}
+
+const TraceEntry &FrameTrace::at(uint16_t index) const
+{
+    size_t capacity = this->entries_.size();
+    return this->entries_[(this->head_ + capacity - this->count_ + index) % capacity];
+}
+
+}  // namespace sinclair_ac
+}  // namespace esphome
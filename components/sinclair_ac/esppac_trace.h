@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "esppac_protocol.h"
+
+namespace esphome {
+namespace sinclair_ac {
+
+/* One frame as it crossed the line. Frames longer than FRAME_MAX_LEN only keep their head,
+   len still holds the full length. */
+struct TraceEntry {
+    uint32_t timestamp;  // millis() of the last byte
+    uint16_t len;
+    bool outgoing;       // sent by us, or by the module when sniffing
+    uint8_t data[CNT::protocol::FRAME_MAX_LEN];
+
+    size_t stored() const { return this->len < sizeof(this->data) ? this->len : sizeof(this->data); }
+};
+
+/* Ring buffer of the last frames in RAM, the oldest one is overwritten. The buffer is
+   allocated once by set_capacity(), recording never allocates. */
+class FrameTrace {
+    public:
+        void set_capacity(uint16_t capacity);
+        uint16_t capacity() const { return static_cast<uint16_t>(this->entries_.size()); }
+
+        void record(const uint8_t *data, size_t len, bool outgoing, uint32_t timestamp);
+        void clear()
+        {
+            this->head_ = 0;
+            this->count_ = 0;
+        }
+
+        uint16_t size() const { return this->count_; }
+        /* 0 is the oldest frame still held */
+        const TraceEntry &at(uint16_t index) const;
+        uint32_t recorded() const { return this->recorded_; }
+        uint32_t overwritten() const { return this->recorded_ - this->count_; }
+
+    protected:
+        std::vector<TraceEntry> entries_;
+        uint16_t head_ = 0;   // Slot the next frame goes to
+        uint16_t count_ = 0;
+        uint32_t recorded_ = 0;
+};
+
+}  // namespace sinclair_ac
+}  // namespace esphome
@@ -0,0 +1,108 @@
+#include "esppac_warm.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+
+#ifdef USE_ESP32
+#include <esp_attr.h>
+#endif
+
+namespace esphome {
+namespace sinclair_ac {
+namespace warm {
+
+static const char *const TAG = "sinclair_ac.warm";
+
+static uint16_t checksum(const WarmState &state)
+{
+    return crc16(reinterpret_cast<const uint8_t *>(&state), offsetof(WarmState, crc));
+}
+
+#if defined(USE_ESP32)
+/* RTC slow memory that the bootloader leaves alone on software resets */
+static RTC_NOINIT_ATTR WarmState rtc_state;
+
+static bool read_block(WarmState *state)
+{
+    std::memcpy(state, &rtc_state, sizeof(WarmState));
+    return true;
+}
+
+static void write_block(const WarmState &state) { std::memcpy(&rtc_state, &state, sizeof(WarmState)); }
+
+#elif defined(USE_ESP8266)
+/* RTC user memory, ESPHome already manages it for preferences that are not kept in flash */
+static const uint32_t PREF_KEY_WARM_STATE = 0x5341430D;
+static ESPPreferenceObject rtc_pref;
+static bool rtc_pref_made = false;
+
+static ESPPreferenceObject &pref()
+{
+    if (!rtc_pref_made)
+    {
+        rtc_pref = global_preferences->make_preference<WarmState>(PREF_KEY_WARM_STATE, false);
+        rtc_pref_made = true;
+    }
+    return rtc_pref;
+}
+
+static bool read_block(WarmState *state) { return pref().load(state); }
+
+static void write_block(const WarmState &state) { pref().save(&state); }
+
+#else
+/* Simulated backend for host builds */
+static WarmState host_state;
+
+static bool read_block(WarmState *state)
+{
+    std::memcpy(state, &host_state, sizeof(WarmState));
+    return true;
+}
+
+static void write_block(const WarmState &state) { std::memcpy(&host_state, &state, sizeof(WarmState)); }
+
+void simulate_power_loss() { std::memset(&host_state, 0xA5, sizeof(WarmState)); }
+#endif
+
+bool load(WarmState *state)
+{
+    /* the block is only trusted once every check passed, on a cold boot it is whatever the
+       memory powered up with and a later save() would stamp a valid crc over it */
+    WarmState block;
+    *state = WarmState{};
+    if (!read_block(&block))
+        return false;
+
+    if (block.magic != WARM_STATE_MAGIC || block.version != WARM_STATE_VERSION || block.size != sizeof(WarmState))
+    {
+        ESP_LOGD(TAG, "No warm state (cold boot)");
+        return false;
+    }
+
+    if (block.crc != checksum(block))
+    {
+        ESP_LOGW(TAG, "Warm state damaged (crc), ignoring it");
+        return false;
+    }
+
+    *state = block;
+    return true;
+}
+
+void save(WarmState *state)
+{
+    state->magic = WARM_STATE_MAGIC;
+    state->version = WARM_STATE_VERSION;
+    state->size = sizeof(WarmState);
+    state->crc = checksum(*state);
+    write_block(*state);
+}
+
+}  // namespace warm
+}  // namespace sinclair_ac
+}  // namespace esphome
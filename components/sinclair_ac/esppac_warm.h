@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace sinclair_ac {
+
+static const uint16_t WARM_STATE_MAGIC = 0x5357;  // "SW"
+static const uint8_t WARM_STATE_VERSION = 2;       // Bump when the layout changes, an OTA must not restore an old layout
+
+/* Survives software resets (OTA, watchdog, API reboot) but not a power loss. Lives in
+   RTC_NOINIT memory on ESP32, RTC user memory on ESP8266 and a static buffer elsewhere. */
+struct WarmState {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t size;
+
+    /* Preference caches, PREF_NOT_SAVED when unset */
+    uint8_t display_idx;
+    uint8_t display_unit_idx;
+    uint8_t vertical_swing_idx;
+    uint8_t horizontal_swing_idx;
+    uint8_t temp_source_idx;
+    uint8_t plasma;
+    uint8_t beeper;
+    uint8_t sleep;
+    uint8_t xfan;
+    uint8_t save;
+
+    int8_t setpoint_offset;   // Setpoint compensation the AC runs with, the report holds the biased setpoint
+    uint8_t has_report;
+    uint8_t has_last_packet;
+    uint8_t report[45];       // Last decoded unit report payload, must match protocol::SET_PACKET_LEN
+    uint8_t last_packet[45];  // Last SET payload sent to the AC
+
+    uint16_t crc;             // crc16 over everything above
+};
+
+namespace warm {
+
+/* Copies the block into state, false on cold boot or when the block is damaged or from another
+   layout. state is cleared then, nothing of a block that failed a check is kept. */
+bool load(WarmState *state);
+/* Stamps magic, version and crc and writes the block */
+void save(WarmState *state);
+
+#if !defined(USE_ESP32) && !defined(USE_ESP8266)
+/* Simulated backend: the block is a static buffer, a new component instance behaves like a
+   warm restart. This wipes it like a power loss would. */
+void simulate_power_loss();
+#endif
+
+}  // namespace warm
+
+}  // namespace sinclair_ac
+}  // namespace esphome
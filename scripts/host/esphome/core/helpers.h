@@ -0,0 +1,21 @@
+#pragma once
+
+/* Host stand-in for the part of ESPHome's helpers.h the host-checked component files use */
+
+#include <cstdint>
+
+namespace esphome {
+
+/* Same algorithm and defaults as ESPHome's crc16() */
+inline uint16_t crc16(const uint8_t *data, uint16_t len, uint16_t crc = 0xffff, uint16_t reverse_poly = 0xa001)
+{
+    while (len--)
+    {
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++)
+            crc = crc & 1 ? (crc >> 1) ^ reverse_poly : crc >> 1;
+    }
+    return crc;
+}
+
+}  // namespace esphome
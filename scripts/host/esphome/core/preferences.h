@@ -0,0 +1,4 @@
+#pragma once
+
+/* Host stand-in for ESPHome's preferences.h. Only the ESP8266 backends use preferences, a
+   host build includes the header and nothing else. */
@@ -0,0 +1,277 @@
+/*
+ * Heap allocation check of the frame parse/encode path.
+ *
+ * Replaces operator new with a counting one and runs the part of the component loop that
+ * builds without ESPHome: a byte stream of unit reports, telemetry frames and line noise is
+ * framed, checked the way verify_packet() does, dispatched on the FRAME_KINDS table
+ * handle_packet() uses and decoded with the codec processUnitReport() uses, fan and swing
+ * names included, and every report is answered with a SET frame encoded like
+ * build_set_payload_() does. After a warm-up pass nothing of this may allocate; the on-device
+ * counterpart is SINCLAIR_PROFILE_STEADY_STATE() in a -DSINCLAIR_AC_PROFILE build.
+ *
+ * Build: g++ -std=c++17 -O2 -Wall -o sinclair_alloc_check scripts/sinclair_alloc_check.cpp \
+ *            components/sinclair_ac/esppac_codec.cpp
+ * Run:   ./sinclair_alloc_check [--cycles N]
+ * Exits 1 when anything allocated after the warm-up.
+ */
+#include "../components/sinclair_ac/esppac_codec.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace sinclair_ac = esphome::sinclair_ac;
+namespace CNT = esphome::sinclair_ac::CNT;
+namespace protocol = esphome::sinclair_ac::CNT::protocol;
+namespace codec = esphome::sinclair_ac::CNT::codec;
+
+static std::atomic<uint32_t> allocation_count{0};
+
+/* Counting allocator, the same one esppac_profile.cpp installs on the device */
+void *operator new(size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = std::malloc(size ? size : 1);
+    if (ptr == nullptr)
+        std::abort();
+    return ptr;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+
+static const uint32_t WARMUP_CYCLES = 1000;
+static const uint32_t DEFAULT_CYCLES = 100000;
+
+/* What processUnitReport() keeps of a report, by name like the component's fields */
+struct State {
+    bool power;
+    uint8_t mode;
+    float target;
+    float room;
+    const char *fan;
+    const char *vswing;
+    const char *hswing;
+    const char *display;
+    bool fahrenheit;
+    bool plasma;
+    bool beeper;
+    bool sleep;
+    bool xfan;
+    bool save;
+};
+
+struct Counts {
+    uint32_t frames = 0;
+    uint32_t reports = 0;
+    uint32_t telemetry = 0;
+    uint32_t dropped = 0;
+    uint32_t bad = 0;
+    uint32_t sets = 0;
+};
+
+/* Fixed buffer framer, skips to a SYNC pair and collects LEN bytes after it like read_data() */
+class Framer {
+    public:
+        /* true when buf() holds a whole frame */
+        bool feed(uint8_t byte)
+        {
+            if (this->len_ < 2 && byte != protocol::SYNC)
+            {
+                this->len_ = 0;
+                return false;
+            }
+            this->buf_[this->len_++] = byte;
+            if (this->len_ == 3 && (byte < 2 || byte + 3u > protocol::FRAME_MAX_LEN))
+            {
+                this->len_ = byte == protocol::SYNC ? 2 : 0;
+                return false;
+            }
+            if (this->len_ < 3 || this->len_ < this->buf_[2] + 3u)
+                return false;
+            this->frame_len_ = this->len_;
+            this->len_ = 0;
+            return true;
+        }
+
+        const uint8_t *buf() const { return this->buf_; }
+        size_t len() const { return this->frame_len_; }
+
+    protected:
+        uint8_t buf_[protocol::FRAME_MAX_LEN];
+        size_t len_ = 0;
+        size_t frame_len_ = 0;
+};
+
+static size_t make_frame(uint8_t command, const uint8_t *payload, uint8_t payload_len, uint8_t *frame)
+{
+    size_t len = payload_len + protocol::FRAME_OVERHEAD;
+    frame[0] = protocol::SYNC;
+    frame[1] = protocol::SYNC;
+    frame[2] = len - 3;
+    frame[3] = command;
+    std::memcpy(frame + protocol::FRAME_HEADER_LEN, payload, payload_len);
+    frame[len - 1] = protocol::frame_checksum(frame, len);
+    return len;
+}
+
+static void decode_report(const uint8_t *payload, State *state)
+{
+    state->power = codec::decode_power(payload);
+    state->mode = codec::decode_mode(payload);
+    state->target = codec::decode_target_temperature(payload);
+    state->room = codec::decode_room_temperature(payload);
+    uint8_t fan = codec::decode_fan_mode(payload);
+    state->fan = sinclair_ac::FAN_MODE_OPTIONS[fan < sinclair_ac::FAN_MODE_OPTIONS_COUNT ? fan : 0];
+    uint8_t vswing = codec::decode_vertical_swing(payload);
+    state->vswing = sinclair_ac::VERTICAL_SWING_OPTIONS[vswing < sinclair_ac::VERTICAL_SWING_OPTIONS_COUNT ? vswing : 0];
+    uint8_t hswing = codec::decode_horizontal_swing(payload);
+    state->hswing = sinclair_ac::HORIZONTAL_SWING_OPTIONS[hswing < sinclair_ac::HORIZONTAL_SWING_OPTIONS_COUNT ? hswing : 0];
+    uint8_t display = codec::decode_display_on(payload) ? codec::decode_display_mode(payload) : 0;
+    state->display = sinclair_ac::DISPLAY_OPTIONS[display < sinclair_ac::DISPLAY_OPTIONS_COUNT ? display : 0];
+    state->fahrenheit = codec::decode_display_fahrenheit(payload);
+    state->plasma = codec::decode_plasma(payload);
+    state->beeper = codec::decode_beeper(payload);
+    state->sleep = codec::decode_sleep(payload);
+    state->xfan = codec::decode_xfan(payload);
+    state->save = codec::decode_save(payload);
+}
+
+/* Same field order as build_set_payload_(), names looked up the same way */
+static void encode_set(const State &state, uint8_t *packet)
+{
+    std::memset(packet, 0, protocol::SET_PACKET_LEN);
+    packet[protocol::SET_CONST_02_BYTE] = protocol::SET_CONST_02_VAL;
+    packet[protocol::SET_CONST_BIT_BYTE] |= protocol::SET_CONST_BIT_MASK;
+    packet[protocol::SET_AF_BYTE] = protocol::SET_AF_VAL;
+
+    codec::encode_power_mode(packet, state.power, state.mode);
+    codec::encode_target_temperature(packet, state.target);
+    codec::encode_fan_mode(packet, codec::fan_mode_index(state.fan));
+    codec::encode_vertical_swing(packet, codec::option_index(sinclair_ac::VERTICAL_SWING_OPTIONS,
+                                                             sinclair_ac::VERTICAL_SWING_OPTIONS_COUNT, state.vswing, 0));
+    codec::encode_horizontal_swing(packet, codec::option_index(sinclair_ac::HORIZONTAL_SWING_OPTIONS,
+                                                               sinclair_ac::HORIZONTAL_SWING_OPTIONS_COUNT, state.hswing, 0));
+    uint8_t display = codec::option_index(sinclair_ac::DISPLAY_OPTIONS, sinclair_ac::DISPLAY_OPTIONS_COUNT, state.display, 0);
+    codec::encode_display(packet, display != 0, display);
+    codec::encode_display_fahrenheit(packet, state.fahrenheit);
+    codec::encode_plasma(packet, state.plasma);
+    codec::encode_beeper(packet, state.beeper);
+    codec::encode_sleep(packet, state.sleep);
+    codec::encode_xfan(packet, state.xfan);
+    codec::encode_save(packet, state.save);
+}
+
+/* One loop pass: frames what the unit sent in this cycle and answers each report */
+static void run_cycle(uint32_t cycle, Framer &framer, State &state, Counts &counts)
+{
+    uint8_t payload[protocol::SET_PACKET_LEN];
+    uint8_t stream[3 * protocol::FRAME_MAX_LEN + 8];
+    size_t len = 0;
+
+    /* a report that walks through the fields, a telemetry frame, noise and a frame with a bad checksum */
+    State report = {cycle % 2 == 0, (uint8_t) (cycle % 5), 16.0f + cycle % 15, 0, sinclair_ac::FAN_MODE_OPTIONS[cycle % 8],
+                    sinclair_ac::VERTICAL_SWING_OPTIONS[cycle % sinclair_ac::VERTICAL_SWING_OPTIONS_COUNT],
+                    sinclair_ac::HORIZONTAL_SWING_OPTIONS[cycle % sinclair_ac::HORIZONTAL_SWING_OPTIONS_COUNT],
+                    sinclair_ac::DISPLAY_OPTIONS[cycle % sinclair_ac::DISPLAY_OPTIONS_COUNT], (cycle & 2) != 0,
+                    (cycle & 4) != 0, (cycle & 8) != 0, (cycle & 16) != 0, (cycle & 32) != 0, (cycle & 64) != 0};
+    encode_set(report, payload);
+    payload[protocol::SET_AF_BYTE] = 0;
+    len += make_frame(protocol::CMD_IN_UNIT_REPORT, payload, protocol::SET_PACKET_LEN, stream + len);
+    std::memset(payload, cycle & 0xFF, 24);
+    len += make_frame(cycle % 3 ? protocol::CMD_IN_UNKNOWN_1 : 0x55, payload, 24, stream + len);
+    stream[len++] = 0x00;
+    stream[len++] = protocol::SYNC;
+    len += make_frame(protocol::CMD_IN_UNIT_REPORT, payload, 8, stream + len);
+    stream[len - 1] ^= 0xFF;
+
+    uint8_t out[protocol::FRAME_MAX_LEN];
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!framer.feed(stream[i]))
+            continue;
+        counts.frames++;
+        const uint8_t *frame = framer.buf();
+        size_t frame_len = framer.len();
+        if (frame_len < protocol::FRAME_OVERHEAD || protocol::frame_checksum(frame, frame_len) != frame[frame_len - 1])
+        {
+            counts.bad++;
+            continue;
+        }
+        size_t payload_len = frame_len - protocol::FRAME_OVERHEAD;
+        switch (CNT::FRAME_KINDS.kind[frame[3]])
+        {
+            case CNT::FRAME_UNIT_REPORT:
+                if (payload_len < protocol::SET_PACKET_LEN)
+                {
+                    counts.bad++;
+                    break;
+                }
+                counts.reports++;
+                decode_report(frame + protocol::FRAME_HEADER_LEN, &state);
+                encode_set(state, payload);
+                make_frame(protocol::CMD_OUT_PARAMS_SET, payload, protocol::SET_PACKET_LEN, out);
+                counts.sets++;
+                break;
+            case CNT::FRAME_TELEMETRY:
+                counts.telemetry++;
+                break;
+            default:
+                counts.dropped++;
+                break;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t cycles = DEFAULT_CYCLES;
+    if (argc == 3 && std::strcmp(argv[1], "--cycles") == 0)
+        cycles = std::strtoul(argv[2], nullptr, 10);
+    else if (argc != 1)
+    {
+        std::fprintf(stderr, "usage: %s [--cycles N]\n", argv[0]);
+        return 2;
+    }
+
+    Framer framer;
+    State state = {};
+    Counts counts;
+    for (uint32_t cycle = 0; cycle < WARMUP_CYCLES; cycle++)
+        run_cycle(cycle, framer, state, counts);
+
+    uint32_t start = allocation_count.load(std::memory_order_relaxed);
+    uint32_t first_cycle = 0;
+    for (uint32_t cycle = 0; cycle < cycles; cycle++)
+    {
+        run_cycle(WARMUP_CYCLES + cycle, framer, state, counts);
+        if (first_cycle == 0 && allocation_count.load(std::memory_order_relaxed) != start)
+            first_cycle = cycle + 1;
+    }
+    uint32_t allocs = allocation_count.load(std::memory_order_relaxed) - start;
+
+    std::printf("%u cycles after %u warm-up: frames=%u reports=%u sets=%u telemetry=%u dropped=%u bad=%u\n",
+                (unsigned) cycles, (unsigned) WARMUP_CYCLES, (unsigned) counts.frames, (unsigned) counts.reports,
+                (unsigned) counts.sets, (unsigned) counts.telemetry, (unsigned) counts.dropped, (unsigned) counts.bad);
+    if (allocs != 0)
+    {
+        std::printf("%u heap allocations after warm-up, first in cycle %u\n", (unsigned) allocs, (unsigned) first_cycle);
+        return 1;
+    }
+    std::printf("no heap allocations after warm-up\n");
+    return 0;
+}
@@ -0,0 +1,236 @@
+/*
+ * Golden-corpus regression runner for captured frame streams.
+ *
+ * A capture is a log with the TX:/RX: lines log_packet() writes (RX needs the VERBOSE log
+ * level), anything else on a line is ignored. The replay in sinclair_timeline.h turns it into a
+ * timeline: a line whenever the decoded report changes, every SET frame that carries an update,
+ * every telemetry payload change, every frame the component would drop, and totals at the end.
+ * Each <name>.log in the corpus is compared with its <name>.golden, files are spread across all
+ * cores.
+ *
+ * Build: g++ -std=c++17 -O2 -Wall -pthread -o sinclair_corpus scripts/sinclair_corpus.cpp \
+ *            components/sinclair_ac/esppac_codec.cpp
+ * Run:   ./sinclair_corpus [--update] [--threads N] [-v] [corpus dir or .log files]
+ * Exits 1 when a timeline differs from its golden file or a golden file is missing.
+ */
+#include "sinclair_timeline.h"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Options {
+    unsigned threads = 0;     /* 0 uses every core */
+    bool update = false;      /* write the golden files instead of comparing */
+    bool verbose = false;     /* print every differing line, not just the first few */
+    std::vector<std::string> paths;
+};
+
+struct Result {
+    std::string name;
+    std::string timeline;
+    bool golden_found = false;
+    std::vector<std::string> diffs;
+    double ms = 0;
+};
+
+static std::string replay(std::istream &in)
+{
+    sinclair_timeline::Timeline timeline;
+    std::string out;
+    std::string line;
+    while (std::getline(in, line))
+        timeline.line(line, out);
+    timeline.totals(out);
+    return out;
+}
+
+static std::vector<std::string> split_lines(const std::string &text)
+{
+    std::vector<std::string> lines;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line))
+        lines.push_back(line);
+    return lines;
+}
+
+static void run_file(const std::string &log, const Options &opt, Result *result)
+{
+    auto started = std::chrono::steady_clock::now();
+    std::string base = log.substr(0, log.size() - 4);
+    result->name = log;
+
+    std::ifstream in(log);
+    result->timeline = replay(in);
+
+    std::string golden_path = base + ".golden";
+    if (opt.update)
+    {
+        std::ofstream(golden_path) << result->timeline;
+        result->golden_found = true;
+    }
+    else
+    {
+        std::ifstream golden_in(golden_path);
+        result->golden_found = golden_in.good();
+        if (result->golden_found)
+        {
+            std::stringstream golden;
+            golden << golden_in.rdbuf();
+            std::vector<std::string> want = split_lines(golden.str());
+            std::vector<std::string> got = split_lines(result->timeline);
+            /* the totals line changes with nearly any edit, keep it out of the tail match */
+            if (!want.empty() && !got.empty() && want.back() != got.back())
+            {
+                result->diffs.push_back("  -totals: " + want.back());
+                result->diffs.push_back("  +totals: " + got.back());
+                want.pop_back();
+                got.pop_back();
+            }
+            /* the block between the common head and tail is what changed */
+            size_t head = 0;
+            while (head < want.size() && head < got.size() && want[head] == got[head])
+                head++;
+            size_t tail = 0;
+            while (tail < want.size() - head && tail < got.size() - head &&
+                   want[want.size() - 1 - tail] == got[got.size() - 1 - tail])
+                tail++;
+            for (size_t i = head; i < want.size() - tail; i++)
+                result->diffs.push_back("  -" + std::to_string(i + 1) + ": " + want[i]);
+            for (size_t i = head; i < got.size() - tail; i++)
+                result->diffs.push_back("  +" + std::to_string(i + 1) + ": " + got[i]);
+        }
+    }
+    result->ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+}
+
+static bool ends_with(const std::string &s, const char *suffix)
+{
+    size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+static void collect(const std::string &path, std::vector<std::string> *logs)
+{
+    if (ends_with(path, ".log"))
+    {
+        logs->push_back(path);
+        return;
+    }
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr)
+    {
+        std::perror(path.c_str());
+        return;
+    }
+    while (struct dirent *entry = readdir(dir))
+        if (ends_with(entry->d_name, ".log"))
+            logs->push_back(path + "/" + entry->d_name);
+    closedir(dir);
+}
+
+static void usage(const char *name)
+{
+    std::fprintf(stderr,
+                 "usage: %s [options] [corpus dir or .log files (scripts/corpus)]\n"
+                 "  --update            write the golden files from this replay\n"
+                 "  --threads N         worker threads, 0 for every core (0)\n"
+                 "  -v, --verbose       print every differing line\n",
+                 name);
+}
+
+static bool parse_options(int argc, char **argv, Options *opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--update")
+            opt->update = true;
+        else if (arg == "--threads" && has_value)
+            opt->threads = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-v" || arg == "--verbose")
+            opt->verbose = true;
+        else if (!arg.empty() && arg[0] == '-')
+            return false;
+        else
+            opt->paths.push_back(arg);
+    }
+    if (opt->paths.empty())
+        opt->paths.push_back("scripts/corpus");
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parse_options(argc, argv, &opt))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opt.threads == 0)
+        opt.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::string> logs;
+    for (const std::string &path : opt.paths)
+        collect(path, &logs);
+    std::sort(logs.begin(), logs.end());
+    if (logs.empty())
+    {
+        std::fprintf(stderr, "no .log captures found\n");
+        return 2;
+    }
+
+    std::vector<Result> results(logs.size());
+    std::atomic<size_t> next{0};
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < std::min<size_t>(opt.threads, logs.size()); t++)
+        workers.emplace_back([&] {
+            for (size_t i = next++; i < logs.size(); i = next++)
+                run_file(logs[i], opt, &results[i]);
+        });
+    for (std::thread &worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    unsigned failed = 0;
+    for (const Result &result : results)
+    {
+        if (opt.update)
+        {
+            std::printf("updated  %s (%.1f ms)\n", result.name.c_str(), result.ms);
+            continue;
+        }
+        if (!result.golden_found)
+        {
+            failed++;
+            std::printf("MISSING  %s: no golden file, run with --update after checking the replay\n", result.name.c_str());
+            continue;
+        }
+        if (result.diffs.empty())
+        {
+            std::printf("ok       %s (%.1f ms)\n", result.name.c_str(), result.ms);
+            continue;
+        }
+        failed++;
+        std::printf("DIFFERS  %s: %zu lines golden (-) vs replay (+)\n", result.name.c_str(), result.diffs.size());
+        size_t shown = opt.verbose ? result.diffs.size() : std::min<size_t>(result.diffs.size(), 6);
+        for (size_t i = 0; i < shown; i++)
+            std::printf("%s\n", result.diffs[i].c_str());
+    }
+    std::printf("%zu captures, %u failed, %u threads, %.2f s\n", results.size(), failed, opt.threads, seconds);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Builds scripts/sinclair_decoder.wasm, the engine of sinclair_decoder.html, from the component's
+# codec and checks the same source built natively against the golden corpus first, so the page
+# never runs a decoder that reads frames differently from the firmware. Needs g++ and emscripten.
+#
+# Run from anywhere: scripts/sinclair_decoder_build.sh
+set -e
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+cd "$root"
+
+if ! command -v emcc >/dev/null 2>&1; then
+    echo "emcc not found, install emscripten (https://emscripten.org) to build sinclair_decoder.wasm" >&2
+    exit 1
+fi
+
+native=$(mktemp)
+trap 'rm -f "$native"' EXIT
+g++ -std=c++17 -O2 -Wall -o "$native" scripts/sinclair_decoder_wasm.cpp components/sinclair_ac/esppac_codec.cpp
+for log in scripts/corpus/*.log; do
+    "$native" < "$log" | diff -u "${log%.log}.golden" - >&2 || { echo "$log: decoder output differs from golden" >&2; exit 1; }
+done
+
+emcc -std=c++17 -O2 -fno-exceptions --no-entry -sSTANDALONE_WASM -sALLOW_MEMORY_GROWTH \
+     -sEXPORTED_FUNCTIONS=_sd_reset,_sd_input,_sd_feed,_sd_finish,_sd_output \
+     -o scripts/sinclair_decoder.wasm scripts/sinclair_decoder_wasm.cpp components/sinclair_ac/esppac_codec.cpp
+
+echo "built scripts/sinclair_decoder.wasm, serve it with: cd scripts && python3 -m http.server"
@@ -0,0 +1,239 @@
+/*
+ * Log decoder behind scripts/sinclair_decoder.html, built to WebAssembly from the component's
+ * own codec. Text is fed in chunks of any size, lines split across chunks are carried over, and
+ * every line goes through the timeline in sinclair_timeline.h, the one the golden corpus is
+ * checked with. Lines that hold nothing but hex bytes (a pasted hexdump) are framed on the SYNC
+ * bytes, a frame may be split over several such lines but not past a line of anything else.
+ *
+ * Build: emcc -std=c++17 -O2 -fno-exceptions --no-entry -sSTANDALONE_WASM -sALLOW_MEMORY_GROWTH \
+ *            -sEXPORTED_FUNCTIONS=_sd_reset,_sd_input,_sd_feed,_sd_finish,_sd_output \
+ *            -o scripts/sinclair_decoder.wasm scripts/sinclair_decoder_wasm.cpp \
+ *            components/sinclair_ac/esppac_codec.cpp
+ * Host:  g++ -std=c++17 -O2 -Wall -o sinclair_decoder_wasm scripts/sinclair_decoder_wasm.cpp \
+ *            components/sinclair_ac/esppac_codec.cpp
+ *        ./sinclair_decoder_wasm [--every-frame] < capture.log
+ * The host build feeds stdin through the same entry points in 64 KB chunks, its output is what
+ * the page shows.
+ */
+#include "sinclair_timeline.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h>
+#define SD_EXPORT extern "C" EMSCRIPTEN_KEEPALIVE
+#else
+#define SD_EXPORT extern "C"
+#endif
+
+namespace {
+
+namespace protocol = esphome::sinclair_ac::CNT::protocol;
+
+/* Hexdumps shorter than this are more likely words than frames */
+const size_t RAW_MIN_BYTES = 4;
+
+class LogDecoder {
+    public:
+        explicit LogDecoder(bool every_frame) : timeline_(every_frame) {}
+
+        void feed(const char *text, size_t len)
+        {
+            const char *end = text + len;
+            while (text < end)
+            {
+                const char *newline = static_cast<const char *>(std::memchr(text, '\n', end - text));
+                if (newline == nullptr)
+                {
+                    this->partial_.append(text, end);
+                    return;
+                }
+                this->partial_.append(text, newline);
+                line_(this->partial_);
+                this->partial_.clear();
+                text = newline + 1;
+            }
+        }
+
+        void finish()
+        {
+            if (!this->partial_.empty())
+            {
+                line_(this->partial_);
+                this->partial_.clear();
+            }
+            flush_raw_();
+            this->timeline_.totals(this->out);
+        }
+
+        std::string out;
+
+    protected:
+        void line_(std::string &line)
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (!raw_bytes_(line))
+            {
+                /* a hexdump frame does not go on past a line of something else */
+                flush_raw_();
+                this->timeline_.line(line, this->out);
+                return;
+            }
+            this->timeline_.next_line();
+            this->raw_.insert(this->raw_.end(), this->bytes_.begin(), this->bytes_.end());
+            frame_raw_();
+        }
+
+        /* Hex byte pairs and separators only, into bytes_ */
+        bool raw_bytes_(const std::string &line)
+        {
+            this->bytes_.clear();
+            int high = -1;
+            for (char c : line)
+            {
+                if (c == ' ' || c == '\t' || c == '.' || c == ',' || c == ':' || c == '-')
+                {
+                    if (high >= 0)
+                        return false;
+                    continue;
+                }
+                int digit = nibble_(c);
+                if (digit < 0)
+                    return false;
+                if (high < 0)
+                {
+                    high = digit;
+                    continue;
+                }
+                this->bytes_.push_back(static_cast<uint8_t>(high << 4 | digit));
+                high = -1;
+            }
+            return high < 0 && this->bytes_.size() >= RAW_MIN_BYTES;
+        }
+
+        static int nibble_(char c)
+        {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+
+        /* Whole frames off the front of raw_, bytes before a SYNC pair are skipped. Without a pair
+           the last byte stays, it may be the first SYNC. */
+        void frame_raw_()
+        {
+            for (;;)
+            {
+                size_t sync = 0;
+                while (sync + 1 < this->raw_.size() &&
+                       !(this->raw_[sync] == protocol::SYNC && this->raw_[sync + 1] == protocol::SYNC))
+                    sync++;
+                this->raw_.erase(this->raw_.begin(), this->raw_.begin() + sync);
+                if (this->raw_.size() < 3)
+                    return;
+                size_t len = this->raw_[2] + 3u;
+                if (this->raw_.size() < len)
+                    return;
+                this->timeline_.frame(raw_outgoing_(), this->raw_.data(), len, std::string(), this->out);
+                this->raw_.erase(this->raw_.begin(), this->raw_.begin() + len);
+            }
+        }
+
+        /* What is left never became a whole frame */
+        void flush_raw_()
+        {
+            if (this->raw_.empty())
+                return;
+            this->timeline_.frame(raw_outgoing_(), this->raw_.data(), this->raw_.size(), std::string(), this->out);
+            this->raw_.clear();
+        }
+
+        /* A hexdump has no TX:/RX:, the command byte tells who sent it */
+        bool raw_outgoing_() const
+        {
+            if (this->raw_.size() < protocol::FRAME_HEADER_LEN)
+                return false;
+            uint8_t command = this->raw_[3];
+            return command == protocol::CMD_OUT_PARAMS_SET || command == protocol::CMD_OUT_UNKNOWN_1 ||
+                   command == protocol::CMD_OUT_SYNC_TIME || command == protocol::CMD_OUT_MAC_REPORT;
+        }
+
+        sinclair_timeline::Timeline timeline_;
+        std::string partial_;          /* start of a line the next chunk finishes */
+        std::vector<uint8_t> raw_;     /* hexdump bytes not framed yet */
+        std::vector<uint8_t> bytes_;
+};
+
+LogDecoder *decoder = nullptr;
+std::vector<char> input;
+
+}  // namespace
+
+/* Starts a new log, every_frame also lists repeated reports and SETs without an update */
+SD_EXPORT void sd_reset(int every_frame)
+{
+    delete decoder;
+    decoder = new LogDecoder(every_frame != 0);
+}
+
+/* Room for the next chunk of len bytes, valid until the next call */
+SD_EXPORT char *sd_input(uint32_t len)
+{
+    if (input.size() < len)
+        input.resize(len);
+    return input.data();
+}
+
+/* Decodes len bytes written to sd_input(), returns the length of the output at sd_output() */
+SD_EXPORT uint32_t sd_feed(uint32_t len)
+{
+    if (decoder == nullptr)
+        sd_reset(0);
+    decoder->out.clear();
+    decoder->feed(input.data(), len);
+    return decoder->out.size();
+}
+
+/* Ends the log: the last line, a hexdump frame cut short and the totals */
+SD_EXPORT uint32_t sd_finish()
+{
+    if (decoder == nullptr)
+        sd_reset(0);
+    decoder->out.clear();
+    decoder->finish();
+    return decoder->out.size();
+}
+
+SD_EXPORT const char *sd_output() { return decoder != nullptr ? decoder->out.data() : ""; }
+
+#ifndef __EMSCRIPTEN__
+int main(int argc, char **argv)
+{
+    bool every_frame = argc > 1 && std::strcmp(argv[1], "--every-frame") == 0;
+    if (argc > 2 || (argc == 2 && !every_frame))
+    {
+        std::fprintf(stderr, "usage: %s [--every-frame] < capture.log\n", argv[0]);
+        return 2;
+    }
+    sd_reset(every_frame);
+    const uint32_t CHUNK = 64 * 1024;
+    for (;;)
+    {
+        size_t got = std::fread(sd_input(CHUNK), 1, CHUNK, stdin);
+        if (got == 0)
+            break;
+        std::fwrite(sd_output(), 1, sd_feed(got), stdout);
+    }
+    std::fwrite(sd_output(), 1, sd_finish(), stdout);
+    return 0;
+}
+#endif
@@ -0,0 +1,91 @@
+// Log decoder for sinclair_decoder.html. Runs as a Web Worker, or in the page itself when the
+// browser will not start a worker from file://. Decoding is done by sinclair_decoder.wasm, the
+// component's codec and the corpus timeline built with scripts/sinclair_decoder_wasm.cpp, there
+// is no second copy of the decoder. Without the .wasm nothing is decoded, the page says how to
+// build and serve it.
+
+const SinclairDecoder = (() => {
+  const CHUNK = 64 * 1024;  // characters handed to the engine at once
+
+  // --- WebAssembly engine -------------------------------------------------------------------
+
+  async function loadWasm(url) {
+    const response = await fetch(url);
+    if (!response.ok) throw new Error(`${url}: ${response.status}`);
+    const module = await WebAssembly.compile(await response.arrayBuffer());
+    // A standalone build may import a few WASI calls it never makes while decoding
+    const imports = {};
+    for (const imp of WebAssembly.Module.imports(module)) {
+      if (imp.kind !== 'function') continue;
+      (imports[imp.module] = imports[imp.module] || {})[imp.name] = () => 0;
+    }
+    const ex = (await WebAssembly.instantiate(module, imports)).exports;
+    if (ex._initialize) ex._initialize();
+
+    const encoder = new TextEncoder();
+    const decoder = new TextDecoder();
+    // memory.buffer changes when the module grows its memory, so views are made per call
+    const output = (len) => decoder.decode(new Uint8Array(ex.memory.buffer, ex.sd_output(), len));
+    return {
+      name: 'WebAssembly',
+      reset(everyFrame) { ex.sd_reset(everyFrame ? 1 : 0); },
+      feed(text) {
+        const bytes = encoder.encode(text);
+        const at = ex.sd_input(bytes.length);
+        new Uint8Array(ex.memory.buffer, at, bytes.length).set(bytes);
+        return output(ex.sd_feed(bytes.length));
+      },
+      finish() { return output(ex.sd_finish()); },
+    };
+  }
+
+  // --- Driver -------------------------------------------------------------------------------
+
+  async function engine(wasmUrl) {
+    try {
+      return await loadWasm(wasmUrl);
+    } catch (e) {
+      throw new Error(`sinclair_decoder.wasm could not be loaded (${e.message || e}). Build it with ` +
+        'scripts/sinclair_decoder_build.sh and open the page over http, e.g. python3 -m http.server in scripts/');
+    }
+  }
+
+  // source is a string or a File. onOutput(text, done, total) gets every piece of output,
+  // returning false from it stops the run.
+  async function decode(eng, source, everyFrame, onOutput) {
+    eng.reset(everyFrame);
+    const isText = typeof source === 'string';
+    const total = isText ? source.length : source.size;
+    const utf8 = new TextDecoder();
+    for (let at = 0; at < total; at += CHUNK) {
+      const end = Math.min(at + CHUNK, total);
+      const text = isText ? source.slice(at, end) : utf8.decode(await source.slice(at, end).arrayBuffer(), { stream: true });
+      if (onOutput(eng.feed(text), end, total) === false) return false;
+      // lets the page breathe when there is no worker
+      await new Promise((resolve) => setTimeout(resolve, 0));
+    }
+    const tail = isText ? '' : utf8.decode();
+    return onOutput(eng.feed(tail) + eng.finish(), total, total) !== false;
+  }
+
+  return { engine, decode };
+})();
+
+// As a worker: {source, everyFrame} in, {type: 'output' | 'done' | 'error'} out
+if (typeof WorkerGlobalScope !== 'undefined' && self instanceof WorkerGlobalScope) {
+  const ready = SinclairDecoder.engine(new URL('sinclair_decoder.wasm', self.location.href).href);
+  self.onmessage = async (ev) => {
+    try {
+      const eng = await ready;
+      const started = performance.now();
+      await SinclairDecoder.decode(eng, ev.data.source, ev.data.everyFrame, (text, done, total) => {
+        self.postMessage({ type: 'output', text, done, total, engine: eng.name });
+      });
+      self.postMessage({ type: 'done', ms: performance.now() - started, engine: eng.name });
+    } catch (e) {
+      self.postMessage({ type: 'error', message: e.message || String(e) });
+    }
+  };
+}
+
+if (typeof module !== 'undefined') module.exports = SinclairDecoder;
@@ -0,0 +1,658 @@
+/*
+ * Sinclair/Gree indoor unit emulator on a Linux pseudo-terminal.
+ *
+ * Answers SET frames with unit reports that carry the applied state in the CNT::protocol
+ * layout, interleaves the 0x33/0x44 frames the real unit sends and lets the room temperature
+ * drift towards the setpoint while the unit runs. Point a host build of the component, or a
+ * serial bridge to a real module, at the printed pty to measure latency, throughput and
+ * recovery without an AC. The --flip/--drop/--dup/--stray/--truncate/--delay options damage
+ * what the unit sends, like a long or noisy cable would. --tap-unit/--tap-module mirror the two
+ * directions to extra ptys, the way two RX-only taps on a real line see them, for the
+ * component's sniffer mode.
+ *
+ * Build: g++ -std=c++17 -O2 -Wall -o sinclair_emulator scripts/sinclair_emulator.cpp
+ * Run:   ./sinclair_emulator --link /tmp/ttyAC
+ *        ./sinclair_emulator --link /tmp/ttyAC --tap-unit /tmp/ttyTapUnit --tap-module /tmp/ttyTapModule
+ */
+#include "../components/sinclair_ac/esppac_protocol.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace protocol = esphome::sinclair_ac::CNT::protocol;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int) { stop_requested = 1; }
+
+static uint64_t now_ms()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct Options {
+    const char *link = nullptr;     /* symlink to the pty slave, removed on exit */
+    const char *tap_unit = nullptr;    /* symlink to a pty that gets a copy of what the unit sends */
+    const char *tap_module = nullptr;  /* symlink to a pty that gets a copy of what the module sends */
+    double ambient = 28.0;          /* temperature the room drifts to while the unit is idle */
+    double room = NAN;              /* start temperature, ambient when unset */
+    double rate = 1.0;              /* degrees per minute the unit moves the room while running */
+    double leak = 60.0;             /* minutes for the room to close 63% of the gap to ambient */
+    uint32_t reply_delay_ms = 30;   /* SET received to report start */
+    uint32_t telemetry_ms = 2000;   /* one 0x33 or 0x44 frame per period, 0 disables them */
+    uint32_t stats_ms = 10000;      /* statistics period, 0 only prints them on exit */
+    bool pace = true;               /* hold the line for the 4800 baud wire time of every frame */
+    bool verbose = false;           /* dump every frame */
+
+    /* Faults on the bytes sent to the component, probabilities from 0 to 1 */
+    double flip = 0;                /* per byte: one random bit inverted */
+    double drop = 0;                /* per byte: byte lost */
+    double dup = 0;                 /* per byte: byte sent twice */
+    double stray = 0;               /* per frame: a run of 1-4 stray 0x7E bytes ahead of it */
+    double truncate = 0;            /* per frame: cut at a random point, the rest never sent */
+    double delay = 0;               /* per report: held back delay_ms longer */
+    uint32_t delay_ms = 600;
+    uint32_t seed = 1;
+};
+
+struct FaultStats {
+    uint32_t flipped = 0;
+    uint32_t dropped = 0;
+    uint32_t duplicated = 0;
+    uint32_t stray_runs = 0;
+    uint32_t truncated = 0;
+    uint32_t delayed = 0;
+    uint32_t damaged_frames = 0;    /* frames that left with at least one fault */
+};
+
+/* Damages frames on their way out, every decision is drawn from one seeded generator so a run can be repeated */
+class FaultInjector {
+    public:
+        FaultInjector(const Options &opt) : opt_(opt), rng_(opt.seed) {}
+
+        bool enabled() const
+        {
+            return opt_.flip > 0 || opt_.drop > 0 || opt_.dup > 0 || opt_.stray > 0 || opt_.truncate > 0;
+        }
+
+        /* Copies frame into out with the configured faults applied */
+        void apply(const uint8_t *frame, size_t len, std::vector<uint8_t> *out)
+        {
+            out->clear();
+            bool damaged = false;
+
+            if (chance_(opt_.stray))
+            {
+                out->insert(out->end(), 1 + rng_() % 4, protocol::SYNC);
+                stats_.stray_runs++;
+                damaged = true;
+            }
+            if (chance_(opt_.truncate))
+            {
+                len = rng_() % len;
+                stats_.truncated++;
+                damaged = true;
+            }
+
+            for (size_t i = 0; i < len; i++)
+            {
+                uint8_t b = frame[i];
+                if (chance_(opt_.drop))
+                {
+                    stats_.dropped++;
+                    damaged = true;
+                    continue;
+                }
+                if (chance_(opt_.flip))
+                {
+                    b ^= 1 << (rng_() % 8);
+                    stats_.flipped++;
+                    damaged = true;
+                }
+                out->push_back(b);
+                if (chance_(opt_.dup))
+                {
+                    out->push_back(b);
+                    stats_.duplicated++;
+                    damaged = true;
+                }
+            }
+            if (damaged)
+                stats_.damaged_frames++;
+        }
+
+        /* Extra delay for the next report, 0 most of the time */
+        uint32_t report_delay()
+        {
+            if (!chance_(opt_.delay))
+                return 0;
+            stats_.delayed++;
+            return opt_.delay_ms;
+        }
+
+        const FaultStats &stats() const { return stats_; }
+        void reset_stats() { stats_ = FaultStats(); }
+
+    private:
+        bool chance_(double p) { return p > 0 && std::uniform_real_distribution<double>(0, 1)(rng_) < p; }
+
+        const Options &opt_;
+        std::mt19937 rng_;
+        FaultStats stats_;
+};
+
+/* Captured from a real unit, the meaning of the fields is unknown (see esppac_protocol.h) */
+static const uint8_t UNKNOWN_2_PAYLOAD[] = {
+    0x00, 0x00, 0x40, 0x00, 0x09, 0x20, 0x19, 0x0A, 0x00, 0x10, 0x00, 0x14, 0x17, 0x5B, 0x08,
+    0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x0D, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+static const uint8_t UNKNOWN_1_PAYLOAD[] = {
+    0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+};
+
+/* The unit itself: the last applied SET payload is what the next report carries */
+class IndoorUnit {
+    public:
+        IndoorUnit(double room) : room_(room)
+        {
+            state_[protocol::REPORT_MODE_BYTE] = protocol::REPORT_MODE_COOL << protocol::REPORT_MODE_POS;
+            state_[protocol::REPORT_TEMP_SET_BYTE] = (24 - protocol::REPORT_TEMP_SET_OFF) << protocol::REPORT_TEMP_SET_POS;
+            state_[protocol::REPORT_DISP_ON_BYTE] = protocol::REPORT_DISP_ON_MASK;
+            state_[protocol::SET_CONST_02_BYTE] = protocol::SET_CONST_02_VAL;
+        }
+
+        /* The unit takes the payload when the no-change bit is clear or the 0xAF marker is set */
+        bool apply(const uint8_t *payload)
+        {
+            bool nochange = payload[protocol::SET_NOCHANGE_BYTE] & protocol::SET_NOCHANGE_MASK;
+            if (nochange && payload[protocol::SET_AF_BYTE] != protocol::SET_AF_VAL)
+                return false;
+
+            std::memcpy(state_, payload, protocol::SET_PACKET_LEN);
+            state_[protocol::SET_AF_BYTE] = 0;
+            state_[protocol::SET_NOCHANGE_BYTE] &= ~protocol::SET_NOCHANGE_MASK;
+            return true;
+        }
+
+        void report(uint8_t *payload) const
+        {
+            std::memcpy(payload, state_, protocol::SET_PACKET_LEN);
+            long raw = std::lround(room_) + 40;  /* decoded as raw - 40 */
+            payload[protocol::REPORT_TEMP_ACT_BYTE] = (uint8_t) std::min(255L, std::max(0L, raw));
+        }
+
+        bool power() const { return state_[protocol::REPORT_PWR_BYTE] & protocol::REPORT_PWR_MASK; }
+        uint8_t mode() const
+        {
+            return (state_[protocol::REPORT_MODE_BYTE] & protocol::REPORT_MODE_MASK) >> protocol::REPORT_MODE_POS;
+        }
+        int target() const
+        {
+            return ((state_[protocol::REPORT_TEMP_SET_BYTE] & protocol::REPORT_TEMP_SET_MASK) >> protocol::REPORT_TEMP_SET_POS) +
+                   protocol::REPORT_TEMP_SET_OFF;
+        }
+        double room() const { return room_; }
+
+        /* Moves the room towards the setpoint while running and towards ambient always */
+        void step(double seconds, const Options &opt)
+        {
+            room_ += (opt.ambient - room_) * (1.0 - std::exp(-seconds / (opt.leak * 60.0)));
+            if (!power())
+                return;
+
+            double gap = target() - room_;
+            bool cools = mode() == protocol::REPORT_MODE_COOL || mode() == protocol::REPORT_MODE_DRY ||
+                         (mode() == protocol::REPORT_MODE_AUTO && gap < 0);
+            bool heats = mode() == protocol::REPORT_MODE_HEAT || (mode() == protocol::REPORT_MODE_AUTO && gap > 0);
+            double move = opt.rate * seconds / 60.0;
+            if (cools && gap < 0)
+                room_ -= std::min(move, -gap);
+            else if (heats && gap > 0)
+                room_ += std::min(move, gap);
+        }
+
+    private:
+        uint8_t state_[protocol::SET_PACKET_LEN] = {0};
+        double room_;
+};
+
+struct Stats {
+    uint32_t rx_frames = 0;
+    uint32_t rx_bad_checksum = 0;
+    uint32_t rx_unknown = 0;
+    uint32_t sets = 0;
+    uint32_t sets_applied = 0;
+    uint32_t handshakes = 0;       /* MAC report and 0x02 frames */
+    uint32_t reports = 0;
+    uint32_t telemetry = 0;
+    uint64_t tx_bytes = 0;
+    uint64_t set_gap_total_ms = 0; /* between consecutive SET frames, the poll period the component runs */
+    uint32_t set_gap_max_ms = 0;
+    uint64_t last_set_ms = 0;
+    uint64_t tap_overruns = 0;     /* bytes a tap pty had no room for, nobody reads it */
+};
+
+class Emulator {
+    public:
+        Emulator(const Options &opt, int fd, int tap_unit, int tap_module) : opt_(opt), fd_(fd),
+            tap_unit_(tap_unit), tap_module_(tap_module), unit_(std::isnan(opt.room) ? opt.ambient : opt.room),
+            faults_(opt) {}
+
+        void run()
+        {
+            uint64_t last_step = now_ms();
+            uint64_t last_stats = last_step;
+            uint64_t next_telemetry = last_step + opt_.telemetry_ms;
+
+            while (!stop_requested)
+            {
+                uint64_t now = now_ms();
+                int timeout = 10;
+                if (report_due_ != 0)
+                    timeout = (int) std::min<uint64_t>(timeout, report_due_ > now ? report_due_ - now : 0);
+
+                struct pollfd pfd = {fd_, POLLIN, 0};
+                if (poll(&pfd, 1, timeout) < 0 && errno != EINTR)
+                {
+                    std::perror("poll");
+                    return;
+                }
+                if (pfd.revents & POLLIN)
+                    read_input_();
+
+                now = now_ms();
+                if (now - last_step >= 1000)
+                {
+                    unit_.step((now - last_step) / 1000.0, opt_);
+                    last_step = now;
+                }
+
+                /* Reports first, telemetry only on an idle line */
+                if (report_due_ != 0 && now >= report_due_ && now >= line_free_at_)
+                {
+                    uint8_t payload[protocol::SET_PACKET_LEN];
+                    unit_.report(payload);
+                    send_(protocol::CMD_IN_UNIT_REPORT, payload, sizeof(payload));
+                    stats_.reports++;
+                    report_due_ = 0;
+                }
+                else if (opt_.telemetry_ms != 0 && report_due_ == 0 && now >= next_telemetry && now >= line_free_at_)
+                {
+                    if (telemetry_toggle_)
+                        send_(protocol::CMD_IN_UNKNOWN_1, UNKNOWN_1_PAYLOAD, sizeof(UNKNOWN_1_PAYLOAD));
+                    else
+                        send_(protocol::CMD_IN_UNKNOWN_2, UNKNOWN_2_PAYLOAD, sizeof(UNKNOWN_2_PAYLOAD));
+                    telemetry_toggle_ = !telemetry_toggle_;
+                    stats_.telemetry++;
+                    next_telemetry = now + opt_.telemetry_ms;
+                }
+
+                if (opt_.stats_ms != 0 && now - last_stats >= opt_.stats_ms)
+                {
+                    print_stats_((now - last_stats) / 1000.0);
+                    uint64_t last_set = stats_.last_set_ms;
+                    stats_ = Stats();
+                    stats_.last_set_ms = last_set;
+                    faults_.reset_stats();
+                    last_stats = now;
+                }
+            }
+            print_stats_((now_ms() - last_stats) / 1000.0);
+        }
+
+    private:
+        /* Same framing as SinclairAC::read_data(): SYNC SYNC LEN, then LEN more bytes */
+        void read_input_()
+        {
+            uint8_t buf[256];
+            ssize_t n = read(fd_, buf, sizeof(buf));
+            if (n > 0)
+                tap_(tap_module_, buf, n);
+            for (ssize_t i = 0; i < n; i++)
+            {
+                uint8_t c = buf[i];
+                rx_.push_back(c);
+                if (rx_.size() > protocol::FRAME_MAX_LEN * 2)
+                    rx_.clear();
+
+                if (remaining_ == 0)
+                {
+                    size_t size = rx_.size();
+                    if (c != protocol::SYNC && size >= 3 && rx_[size - 2] == protocol::SYNC && rx_[size - 3] == protocol::SYNC)
+                    {
+                        rx_.assign({protocol::SYNC, protocol::SYNC, c});
+                        remaining_ = c;
+                    }
+                    continue;
+                }
+
+                if (--remaining_ == 0)
+                {
+                    handle_frame_(rx_.data(), rx_.size());
+                    rx_.clear();
+                }
+            }
+        }
+
+        void handle_frame_(const uint8_t *frame, size_t len)
+        {
+            dump_("RX", frame, len);
+            stats_.rx_frames++;
+            if (len < protocol::FRAME_OVERHEAD || protocol::frame_checksum(frame, len) != frame[len - 1])
+            {
+                stats_.rx_bad_checksum++;
+                return;
+            }
+
+            const uint8_t *payload = frame + protocol::FRAME_HEADER_LEN;
+            size_t payload_len = len - protocol::FRAME_OVERHEAD;
+            switch (frame[3])
+            {
+                case protocol::CMD_OUT_PARAMS_SET:
+                {
+                    if (payload_len != protocol::SET_PACKET_LEN)
+                    {
+                        stats_.rx_unknown++;
+                        return;
+                    }
+                    uint64_t now = now_ms();
+                    if (stats_.last_set_ms != 0)
+                    {
+                        uint32_t gap = (uint32_t) (now - stats_.last_set_ms);
+                        stats_.set_gap_total_ms += gap;
+                        stats_.set_gap_max_ms = std::max(stats_.set_gap_max_ms, gap);
+                    }
+                    stats_.last_set_ms = now;
+                    stats_.sets++;
+                    if (unit_.apply(payload))
+                    {
+                        stats_.sets_applied++;
+                        if (opt_.verbose)
+                            std::printf("applied: power=%d mode=%u target=%d\n", unit_.power(), unit_.mode(), unit_.target());
+                    }
+                    report_due_ = now + opt_.reply_delay_ms + faults_.report_delay();
+                    break;
+                }
+                case protocol::CMD_OUT_MAC_REPORT:
+                case protocol::CMD_OUT_UNKNOWN_1:
+                    stats_.handshakes++;
+                    break;
+                default:
+                    stats_.rx_unknown++;
+                    break;
+            }
+        }
+
+        void send_(uint8_t cmd, const uint8_t *payload, size_t payload_len)
+        {
+            uint8_t frame[protocol::FRAME_MAX_LEN];
+            size_t len = payload_len + protocol::FRAME_OVERHEAD;
+            frame[0] = protocol::SYNC;
+            frame[1] = protocol::SYNC;
+            frame[2] = (uint8_t) (payload_len + 2);
+            frame[3] = cmd;
+            std::memcpy(frame + protocol::FRAME_HEADER_LEN, payload, payload_len);
+            frame[len - 1] = protocol::frame_checksum(frame, len);
+
+            const uint8_t *wire = frame;
+            if (faults_.enabled())
+            {
+                faults_.apply(frame, len, &damaged_);
+                wire = damaged_.data();
+                len = damaged_.size();
+            }
+
+            if (len > 0 && write(fd_, wire, len) != (ssize_t) len)
+                std::perror("write");
+            tap_(tap_unit_, wire, len);
+            dump_("TX", wire, len);
+            stats_.tx_bytes += len;
+            line_free_at_ = now_ms() + (opt_.pace ? protocol::wire_time_ms(len) : 0);
+        }
+
+        /* The taps are non-blocking, a tap nobody reads must not stall the link */
+        void tap_(int fd, const uint8_t *data, size_t len)
+        {
+            if (fd < 0 || len == 0)
+                return;
+            ssize_t n = write(fd, data, len);
+            if (n < (ssize_t) len)
+                stats_.tap_overruns += len - std::max<ssize_t>(n, 0);
+        }
+
+        void dump_(const char *dir, const uint8_t *frame, size_t len) const
+        {
+            if (!opt_.verbose)
+                return;
+            std::printf("%s", dir);
+            for (size_t i = 0; i < len; i++)
+                std::printf(" %02X", frame[i]);
+            std::printf("\n");
+        }
+
+        void print_stats_(double seconds) const
+        {
+            if (seconds <= 0)
+                return;
+            uint32_t gaps = stats_.sets > 1 ? stats_.sets - 1 : 0;
+            std::printf("%.1fs: rx %u frames (%u bad, %u unknown, %u handshake), SET %u (%u applied) "
+                        "gap avg %.0f max %u ms, tx %u reports %u telemetry %.0f B/s, "
+                        "room %.1f power %d mode %u target %d\n",
+                        seconds, stats_.rx_frames, stats_.rx_bad_checksum, stats_.rx_unknown, stats_.handshakes,
+                        stats_.sets, stats_.sets_applied, gaps ? (double) stats_.set_gap_total_ms / gaps : 0.0,
+                        stats_.set_gap_max_ms, stats_.reports, stats_.telemetry, stats_.tx_bytes / seconds,
+                        unit_.room(), unit_.power(), unit_.mode(), unit_.target());
+            if (faults_.enabled() || opt_.delay > 0)
+            {
+                const FaultStats &f = faults_.stats();
+                std::printf("  faults: %u frames damaged, %u flipped %u dropped %u duplicated bytes, "
+                            "%u stray runs, %u truncated, %u reports delayed\n",
+                            f.damaged_frames, f.flipped, f.dropped, f.duplicated, f.stray_runs, f.truncated, f.delayed);
+            }
+            if (stats_.tap_overruns > 0)
+                std::printf("  taps: %llu bytes overrun\n", (unsigned long long) stats_.tap_overruns);
+            std::fflush(stdout);
+        }
+
+        const Options &opt_;
+        int fd_;
+        int tap_unit_;                /* -1 without --tap-unit */
+        int tap_module_;
+        IndoorUnit unit_;
+        FaultInjector faults_;
+        std::vector<uint8_t> damaged_;  /* frame as it goes on the wire when faults are enabled */
+        Stats stats_;
+        std::vector<uint8_t> rx_;
+        size_t remaining_ = 0;        /* bytes of the current frame still to come, 0 while hunting SYNC */
+        uint64_t report_due_ = 0;     /* 0 when no report is owed */
+        uint64_t line_free_at_ = 0;
+        bool telemetry_toggle_ = false;
+};
+
+static void usage(const char *name)
+{
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  --link PATH         symlink PATH to the pty slave\n"
+                 "  --tap-unit PATH     mirror what the unit sends to a second pty, symlinked to PATH\n"
+                 "  --tap-module PATH   mirror what the module sends to a third pty, symlinked to PATH\n"
+                 "  --ambient C         temperature the idle room drifts to (28)\n"
+                 "  --room C            start temperature (ambient)\n"
+                 "  --rate C            degrees per minute while running (1.0)\n"
+                 "  --leak MIN          room time constant towards ambient in minutes (60)\n"
+                 "  --reply-delay MS    SET to report delay (30)\n"
+                 "  --telemetry MS      0x33/0x44 frame period, 0 disables them (2000)\n"
+                 "  --stats MS          statistics period, 0 only on exit (10000)\n"
+                 "  --no-pace           do not hold the line for the 4800 baud wire time\n"
+                 "  --flip P            per byte probability of one inverted bit (0)\n"
+                 "  --drop P            per byte probability of a lost byte (0)\n"
+                 "  --dup P             per byte probability of a duplicated byte (0)\n"
+                 "  --stray P           per frame probability of stray 0x7E bytes ahead of it (0)\n"
+                 "  --truncate P        per frame probability of cutting it short (0)\n"
+                 "  --delay P[:MS]      per report probability of holding it back MS longer (0:600)\n"
+                 "  --seed N            fault generator seed (1)\n"
+                 "  -v, --verbose       dump every frame\n",
+                 name);
+}
+
+static bool parse_options(int argc, char **argv, Options *opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--link" && has_value)
+            opt->link = argv[++i];
+        else if (arg == "--tap-unit" && has_value)
+            opt->tap_unit = argv[++i];
+        else if (arg == "--tap-module" && has_value)
+            opt->tap_module = argv[++i];
+        else if (arg == "--ambient" && has_value)
+            opt->ambient = std::atof(argv[++i]);
+        else if (arg == "--room" && has_value)
+            opt->room = std::atof(argv[++i]);
+        else if (arg == "--rate" && has_value)
+            opt->rate = std::atof(argv[++i]);
+        else if (arg == "--leak" && has_value)
+            opt->leak = std::max(0.1, std::atof(argv[++i]));
+        else if (arg == "--reply-delay" && has_value)
+            opt->reply_delay_ms = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--telemetry" && has_value)
+            opt->telemetry_ms = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--stats" && has_value)
+            opt->stats_ms = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--no-pace")
+            opt->pace = false;
+        else if (arg == "--flip" && has_value)
+            opt->flip = std::atof(argv[++i]);
+        else if (arg == "--drop" && has_value)
+            opt->drop = std::atof(argv[++i]);
+        else if (arg == "--dup" && has_value)
+            opt->dup = std::atof(argv[++i]);
+        else if (arg == "--stray" && has_value)
+            opt->stray = std::atof(argv[++i]);
+        else if (arg == "--truncate" && has_value)
+            opt->truncate = std::atof(argv[++i]);
+        else if (arg == "--delay" && has_value)
+        {
+            char *end = nullptr;
+            opt->delay = std::strtod(argv[++i], &end);
+            if (end != nullptr && *end == ':')
+                opt->delay_ms = std::strtoul(end + 1, nullptr, 10);
+        }
+        else if (arg == "--seed" && has_value)
+            opt->seed = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-v" || arg == "--verbose")
+            opt->verbose = true;
+        else
+            return false;
+    }
+    return true;
+}
+
+/* Raw pty master, its slave held open and symlinked to link when one is given. Returns false
+   with the error printed. */
+struct Pty {
+    int master = -1;
+    int slave = -1;
+    std::string name;  /* ptsname() reuses its buffer */
+    const char *link = nullptr;
+};
+
+static bool open_pty(const char *link, Pty *pty)
+{
+    pty->master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty->master < 0 || grantpt(pty->master) != 0 || unlockpt(pty->master) != 0)
+    {
+        std::perror("pty");
+        return false;
+    }
+    pty->name = ptsname(pty->master);
+
+    /* Raw bytes both ways, no echo or line editing */
+    struct termios tio;
+    tcgetattr(pty->master, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(pty->master, TCSANOW, &tio);
+
+    /* Keep a slave handle open so reads do not fail with EIO while no client is attached */
+    pty->slave = open(pty->name.c_str(), O_RDWR | O_NOCTTY);
+
+    pty->link = link;
+    if (link != nullptr)
+    {
+        unlink(link);
+        if (symlink(pty->name.c_str(), link) != 0)
+        {
+            std::perror("symlink");
+            return false;
+        }
+    }
+    return true;
+}
+
+static void close_pty(const Pty &pty)
+{
+    if (pty.master < 0)
+        return;
+    if (pty.link != nullptr)
+        unlink(pty.link);
+    close(pty.slave);
+    close(pty.master);
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parse_options(argc, argv, &opt))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    Pty line, tap_unit, tap_module;
+    if (!open_pty(opt.link, &line))
+        return 1;
+    if (opt.tap_unit != nullptr && !open_pty(opt.tap_unit, &tap_unit))
+        return 1;
+    if (opt.tap_module != nullptr && !open_pty(opt.tap_module, &tap_module))
+        return 1;
+    for (const Pty *tap : {&tap_unit, &tap_module})
+        if (tap->master >= 0)
+            fcntl(tap->master, F_SETFL, fcntl(tap->master, F_GETFL) | O_NONBLOCK);
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    std::printf("indoor unit on %s%s%s\n", line.name.c_str(), opt.link ? " -> " : "", opt.link ? opt.link : "");
+    if (tap_unit.master >= 0)
+        std::printf("unit tap on %s -> %s\n", tap_unit.name.c_str(), opt.tap_unit);
+    if (tap_module.master >= 0)
+        std::printf("module tap on %s -> %s\n", tap_module.name.c_str(), opt.tap_module);
+    std::fflush(stdout);
+
+    Emulator emulator(opt, line.master, tap_unit.master, tap_module.master);
+    emulator.run();
+
+    close_pty(line);
+    close_pty(tap_unit);
+    close_pty(tap_module);
+    return 0;
+}
@@ -0,0 +1,442 @@
+/*
+ * Exhaustive encode/decode round trip of the SET payload.
+ *
+ * Walks every combination of power, mode, fan, vertical and horizontal swing, display state
+ * and mode, display unit, the five extras and a set of setpoints, encodes it with the codec
+ * send_packet() uses, decodes it with the one the determine_*() functions use and reports
+ * every field that did not survive, grouped per field with a count and the first example.
+ * Each combination is also written over the previous one in the same buffer, which must give
+ * the same bytes as a fresh encode. The space is split across all cores.
+ *
+ * Setpoints are the values the decode tables hold, which must come back exactly, and 16..30
+ * in 0.5 steps, which must come back rounding to the same whole degree.
+ *
+ * A SET frame only carries the fan speed2 field and the quiet/turbo bits, so by default only
+ * those are compared and Medium-Low/Medium and Medium-High/High coming back as each other is
+ * expected. --unit-echo fills in speed1 like the unit's reports and then every fan mode must
+ * decode to itself.
+ *
+ * Before that every fan mode name that reaches control() is checked: the CUSTOM_FAN_MODES name
+ * Home Assistant sends and the one a schedule entry stores must both encode like their
+ * FAN_MODE_OPTIONS entry.
+ *
+ * Build: g++ -std=c++17 -O2 -Wall -pthread -o sinclair_roundtrip scripts/sinclair_roundtrip.cpp \
+ *            components/sinclair_ac/esppac_codec.cpp components/sinclair_ac/esppac_schedule.cpp
+ * Run:   ./sinclair_roundtrip [--unit-echo] [--offsets N] [--threads N]
+ * Exits 1 when anything did not round trip.
+ */
+#include "../components/sinclair_ac/esppac_codec.h"
+#include "../components/sinclair_ac/esppac_schedule.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sinclair_ac = esphome::sinclair_ac;
+namespace protocol = esphome::sinclair_ac::CNT::protocol;
+namespace codec = esphome::sinclair_ac::CNT::codec;
+
+static const char *const MODE_NAMES[] = {"auto", "cool", "dry", "fan", "heat"};
+static const uint8_t MODE_COUNT = sizeof(MODE_NAMES) / sizeof(MODE_NAMES[0]);
+
+struct Options {
+    unsigned threads = 0;     /* 0 uses every core */
+    int offsets = 0;          /* also check setpoint offsets -N..N */
+    bool unit_echo = false;   /* fill in the fan speed1 field like the unit does in its reports */
+};
+
+struct Setpoint {
+    float value;
+    bool exact;               /* a decode table value, must come back bit for bit */
+};
+
+struct Settings {
+    bool power;
+    uint8_t mode;
+    uint8_t fan;
+    uint8_t vswing;
+    uint8_t hswing;
+    bool display_on;
+    uint8_t display_mode;     /* DISPLAY_OPTIONS index, 1..4 */
+    bool fahrenheit;
+    bool plasma;
+    bool beeper;
+    bool sleep;
+    bool xfan;
+    bool save;
+    Setpoint setpoint;
+    int8_t offset;
+};
+
+enum Field {
+    FIELD_POWER,
+    FIELD_MODE,
+    FIELD_SETPOINT,
+    FIELD_FAN,
+    FIELD_VSWING,
+    FIELD_HSWING,
+    FIELD_DISPLAY_ON,
+    FIELD_DISPLAY_MODE,
+    FIELD_UNIT,
+    FIELD_PLASMA,
+    FIELD_BEEPER,
+    FIELD_SLEEP,
+    FIELD_XFAN,
+    FIELD_SAVE,
+    FIELD_REWRITE,            /* rewriting the buffer in place did not match a fresh encode */
+    FIELD_COUNT
+};
+
+static const char *const FIELD_NAMES[FIELD_COUNT] = {
+    "power", "mode", "setpoint", "fan", "vertical swing", "horizontal swing", "display on",
+    "display mode", "display unit", "plasma", "beeper", "sleep", "xfan", "save", "rewrite",
+};
+
+struct Mismatch {
+    uint64_t count = 0;
+    std::string example;      /* first one seen by this thread */
+};
+
+struct Tally {
+    uint64_t checked = 0;
+    uint64_t skipped = 0;     /* setpoint plus offset outside what the 4-bit field can carry */
+    Mismatch fields[FIELD_COUNT];
+};
+
+static const char *name_or(const char *const *table, uint8_t count, uint8_t index)
+{
+    return index < count ? table[index] : "(unknown)";
+}
+
+static std::string describe(const Settings &s)
+{
+    char text[256];
+    std::snprintf(text, sizeof(text),
+                  "%s %s %.4f%+d fan=%s v=%s h=%s display=%s/%s %s plasma=%d beeper=%d sleep=%d xfan=%d save=%d",
+                  s.power ? "on" : "off", MODE_NAMES[s.mode], s.setpoint.value, s.offset,
+                  sinclair_ac::FAN_MODE_OPTIONS[s.fan], sinclair_ac::VERTICAL_SWING_OPTIONS[s.vswing],
+                  sinclair_ac::HORIZONTAL_SWING_OPTIONS[s.hswing], s.display_on ? "on" : "off",
+                  sinclair_ac::DISPLAY_OPTIONS[s.display_mode], s.fahrenheit ? "F" : "C", s.plasma, s.beeper,
+                  s.sleep, s.xfan, s.save);
+    return text;
+}
+
+static std::string hex(const uint8_t *payload)
+{
+    std::string out;
+    char byte[4];
+    for (uint8_t i = 0; i < protocol::SET_PACKET_LEN; i++)
+    {
+        std::snprintf(byte, sizeof(byte), "%02X", payload[i]);
+        out += byte;
+    }
+    return out;
+}
+
+/* Same field order as send_packet(), the offset goes on after the plain setpoint like there */
+static void encode(const Settings &s, uint8_t *packet)
+{
+    packet[protocol::SET_CONST_02_BYTE] = protocol::SET_CONST_02_VAL;
+    packet[protocol::SET_CONST_BIT_BYTE] |= protocol::SET_CONST_BIT_MASK;
+
+    codec::encode_power_mode(packet, s.power, s.mode);
+    codec::encode_target_temperature(packet, s.setpoint.value);
+    codec::encode_fan_mode(packet, s.fan);
+    codec::encode_vertical_swing(packet, s.vswing);
+    codec::encode_horizontal_swing(packet, s.hswing);
+    codec::encode_display(packet, s.display_on, s.display_mode);
+    codec::encode_display_fahrenheit(packet, s.fahrenheit);
+    codec::encode_plasma(packet, s.plasma);
+    codec::encode_beeper(packet, s.beeper);
+    codec::encode_sleep(packet, s.sleep);
+    codec::encode_xfan(packet, s.xfan);
+    codec::encode_save(packet, s.save);
+    if (s.offset != 0)
+        codec::encode_target_temperature(packet, s.setpoint.value, s.offset);
+}
+
+/* First FAN_MODE_OPTIONS entry with the same fields a SET carries, FAN_MODE_OPTIONS_COUNT when none has them */
+static uint8_t set_fan_mode(const uint8_t *payload)
+{
+    uint8_t speed2 = (payload[protocol::REPORT_FAN_SPD2_BYTE] & protocol::REPORT_FAN_SPD2_MASK) >> protocol::REPORT_FAN_SPD2_POS;
+    bool quiet = payload[protocol::REPORT_FAN_QUIET_BYTE] & protocol::REPORT_FAN_QUIET_MASK;
+    bool turbo = payload[protocol::REPORT_FAN_TURBO_BYTE] & protocol::REPORT_FAN_TURBO_MASK;
+    for (uint8_t i = 0; i < sinclair_ac::FAN_MODE_OPTIONS_COUNT; i++)
+    {
+        const codec::FanEncoding &known = codec::FAN_ENCODINGS[i];
+        if (known.speed2 == speed2 && known.quiet == quiet && known.turbo == turbo)
+            return i;
+    }
+    return sinclair_ac::FAN_MODE_OPTIONS_COUNT;
+}
+
+/* What set_fan_mode() gives for a correctly encoded fan: Medium reads back as Medium-Low, High as Medium-High */
+static uint8_t set_fan_alias(uint8_t fan)
+{
+    const codec::FanEncoding &enc = codec::FAN_ENCODINGS[fan];
+    for (uint8_t i = 0; i < fan; i++)
+    {
+        const codec::FanEncoding &known = codec::FAN_ENCODINGS[i];
+        if (known.speed2 == enc.speed2 && known.quiet == enc.quiet && known.turbo == enc.turbo)
+            return i;
+    }
+    return fan;
+}
+
+static void record(Tally &tally, Field field, const Settings &s, const uint8_t *payload, const char *got)
+{
+    Mismatch &m = tally.fields[field];
+    if (m.count++ == 0)
+        m.example = describe(s) + "\n      decoded " + got + "\n      payload " + hex(payload);
+}
+
+static void check(const Settings &s, uint8_t *previous, const Options &opt, Tally &tally)
+{
+    uint8_t payload[protocol::SET_PACKET_LEN] = {0};
+    encode(s, payload);
+
+    /* the rewrite starts from whatever the last combination left behind */
+    encode(s, previous);
+    if (std::memcmp(previous, payload, protocol::SET_PACKET_LEN) != 0)
+        record(tally, FIELD_REWRITE, s, previous, hex(payload).insert(0, "fresh ").c_str());
+
+    if (opt.unit_echo)
+    {
+        uint8_t speed1 = codec::FAN_ENCODINGS[s.fan].speed1;
+        payload[protocol::REPORT_FAN_SPD1_BYTE] &= ~protocol::REPORT_FAN_SPD1_MASK;
+        payload[protocol::REPORT_FAN_SPD1_BYTE] |= (speed1 << protocol::REPORT_FAN_SPD1_POS) & protocol::REPORT_FAN_SPD1_MASK;
+    }
+
+    char got[64];
+    tally.checked++;
+
+    if (codec::decode_power(payload) != s.power)
+        record(tally, FIELD_POWER, s, payload, s.power ? "off" : "on");
+    uint8_t mode = codec::decode_mode(payload);
+    if (mode != s.mode)
+        record(tally, FIELD_MODE, s, payload, name_or(MODE_NAMES, MODE_COUNT, mode));
+
+    float setpoint = codec::decode_target_temperature(payload, s.offset);
+    bool setpoint_ok = s.setpoint.exact ? setpoint == s.setpoint.value
+                                        : setpoint != 0 && lroundf(setpoint) == lroundf(s.setpoint.value);
+    if (!setpoint_ok)
+    {
+        std::snprintf(got, sizeof(got), "%.4f", setpoint);
+        record(tally, FIELD_SETPOINT, s, payload, got);
+    }
+
+    uint8_t fan = opt.unit_echo ? codec::decode_fan_mode(payload) : set_fan_mode(payload);
+    if (fan != (opt.unit_echo ? s.fan : set_fan_alias(s.fan)))
+        record(tally, FIELD_FAN, s, payload,
+               name_or(sinclair_ac::FAN_MODE_OPTIONS, sinclair_ac::FAN_MODE_OPTIONS_COUNT, fan));
+    uint8_t vswing = codec::decode_vertical_swing(payload);
+    if (vswing != s.vswing)
+        record(tally, FIELD_VSWING, s, payload,
+               name_or(sinclair_ac::VERTICAL_SWING_OPTIONS, sinclair_ac::VERTICAL_SWING_OPTIONS_COUNT, vswing));
+    uint8_t hswing = codec::decode_horizontal_swing(payload);
+    if (hswing != s.hswing)
+        record(tally, FIELD_HSWING, s, payload,
+               name_or(sinclair_ac::HORIZONTAL_SWING_OPTIONS, sinclair_ac::HORIZONTAL_SWING_OPTIONS_COUNT, hswing));
+
+    if (codec::decode_display_on(payload) != s.display_on)
+        record(tally, FIELD_DISPLAY_ON, s, payload, s.display_on ? "off" : "on");
+    uint8_t display_mode = codec::decode_display_mode(payload);
+    if (display_mode != s.display_mode)
+        record(tally, FIELD_DISPLAY_MODE, s, payload,
+               name_or(sinclair_ac::DISPLAY_OPTIONS, sinclair_ac::DISPLAY_OPTIONS_COUNT, display_mode));
+    if (codec::decode_display_fahrenheit(payload) != s.fahrenheit)
+        record(tally, FIELD_UNIT, s, payload, s.fahrenheit ? "C" : "F");
+
+    if (codec::decode_plasma(payload) != s.plasma)
+        record(tally, FIELD_PLASMA, s, payload, s.plasma ? "0" : "1");
+    if (codec::decode_beeper(payload) != s.beeper)
+        record(tally, FIELD_BEEPER, s, payload, s.beeper ? "0" : "1");
+    if (codec::decode_sleep(payload) != s.sleep)
+        record(tally, FIELD_SLEEP, s, payload, s.sleep ? "0" : "1");
+    if (codec::decode_xfan(payload) != s.xfan)
+        record(tally, FIELD_XFAN, s, payload, s.xfan ? "0" : "1");
+    if (codec::decode_save(payload) != s.save)
+        record(tally, FIELD_SAVE, s, payload, s.save ? "0" : "1");
+}
+
+/* The name goes through fan_mode_index() like in control() and is encoded like in
+   build_set_payload_(), the bytes must match a plain encode of the index */
+static bool check_fan_name(uint8_t fan, const char *source, const char *name)
+{
+    uint8_t expected[protocol::SET_PACKET_LEN] = {0};
+    uint8_t payload[protocol::SET_PACKET_LEN] = {0};
+    codec::encode_fan_mode(expected, fan);
+    uint8_t index = codec::fan_mode_index(name);
+    if (index < sinclair_ac::FAN_MODE_OPTIONS_COUNT)
+        codec::encode_fan_mode(payload, codec::fan_mode_index(sinclair_ac::FAN_MODE_OPTIONS[index]));
+    if (index == fan && std::memcmp(payload, expected, protocol::SET_PACKET_LEN) == 0)
+        return true;
+    std::printf("fan name          %s \"%s\" resolves to %s, expected %s\n      payload %s\n", source,
+                name ? name : "(null)", name_or(sinclair_ac::FAN_MODE_OPTIONS, sinclair_ac::FAN_MODE_OPTIONS_COUNT, index),
+                sinclair_ac::FAN_MODE_OPTIONS[fan], hex(payload).c_str());
+    return false;
+}
+
+static bool check_fan_names()
+{
+    bool clean = true;
+    for (uint8_t fan = 0; fan < sinclair_ac::FAN_MODE_OPTIONS_COUNT; fan++)
+    {
+        clean &= check_fan_name(fan, "option", sinclair_ac::FAN_MODE_OPTIONS[fan]);
+        clean &= check_fan_name(fan, "custom", sinclair_ac::CUSTOM_FAN_MODES[fan]);
+        /* apply_schedule_entry_() hands the stored index on as a CUSTOM_FAN_MODES name */
+        uint8_t scheduled = sinclair_ac::schedule_fan_from_string(sinclair_ac::CUSTOM_FAN_MODES[fan]);
+        clean &= check_fan_name(fan, "schedule",
+                                scheduled < sinclair_ac::FAN_MODE_OPTIONS_COUNT ? sinclair_ac::CUSTOM_FAN_MODES[scheduled] : nullptr);
+    }
+    return clean;
+}
+
+static std::vector<Setpoint> setpoints()
+{
+    std::vector<Setpoint> list;
+    for (const float *table : {codec::TEMREC0, codec::TEMREC1})
+        for (uint8_t i = 0; i < 16; i++)
+            if (table[i] != 0)
+                list.push_back({table[i], true});
+    for (float t = 16.0f; t <= 30.0f; t += 0.5f)
+        list.push_back({t, false});
+    return list;
+}
+
+/* One task is everything below a power/mode/fan/vertical swing prefix */
+static const uint32_t TASK_COUNT = 2 * MODE_COUNT * sinclair_ac::FAN_MODE_OPTIONS_COUNT *
+                                   sinclair_ac::VERTICAL_SWING_OPTIONS_COUNT;
+
+static void run_task(uint32_t task, const std::vector<Setpoint> &list, const Options &opt, Tally &tally)
+{
+    Settings s{};
+    s.vswing = task % sinclair_ac::VERTICAL_SWING_OPTIONS_COUNT;
+    task /= sinclair_ac::VERTICAL_SWING_OPTIONS_COUNT;
+    s.fan = task % sinclair_ac::FAN_MODE_OPTIONS_COUNT;
+    task /= sinclair_ac::FAN_MODE_OPTIONS_COUNT;
+    s.mode = task % MODE_COUNT;
+    s.power = task / MODE_COUNT;
+
+    uint8_t previous[protocol::SET_PACKET_LEN] = {0};
+    for (s.hswing = 0; s.hswing < sinclair_ac::HORIZONTAL_SWING_OPTIONS_COUNT; s.hswing++)
+        for (uint8_t display = 0; display < 2 * (sinclair_ac::DISPLAY_OPTIONS_COUNT - 1); display++)
+            for (uint8_t extras = 0; extras < 64; extras++)
+                for (const Setpoint &setpoint : list)
+                    for (int offset = -opt.offsets; offset <= opt.offsets; offset++)
+                    {
+                        s.display_on = display & 1;
+                        s.display_mode = 1 + display / 2;
+                        s.fahrenheit = extras & 1;
+                        s.plasma = extras & 2;
+                        s.beeper = extras & 4;
+                        s.sleep = extras & 8;
+                        s.xfan = extras & 16;
+                        s.save = extras & 32;
+                        s.setpoint = setpoint;
+                        s.offset = offset;
+
+                        long field = lroundf(setpoint.value) + offset - protocol::REPORT_TEMP_SET_OFF;
+                        if (field < 0 || field > 15)
+                        {
+                            tally.skipped++;
+                            continue;
+                        }
+                        check(s, previous, opt, tally);
+                    }
+}
+
+static void usage(const char *name)
+{
+    std::fprintf(stderr,
+                 "usage: %s [options]\n"
+                 "  --unit-echo         fill in fan speed1 like the unit's reports before decoding\n"
+                 "  --offsets N         also check setpoint offsets -N..N (0)\n"
+                 "  --threads N         worker threads, 0 for every core (0)\n",
+                 name);
+}
+
+static bool parse_options(int argc, char **argv, Options *opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--unit-echo")
+            opt->unit_echo = true;
+        else if (arg == "--offsets" && has_value)
+            opt->offsets = std::abs(std::atoi(argv[++i]));
+        else if (arg == "--threads" && has_value)
+            opt->threads = std::strtoul(argv[++i], nullptr, 10);
+        else
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parse_options(argc, argv, &opt))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    if (opt.threads == 0)
+        opt.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    bool clean = check_fan_names();
+
+    const std::vector<Setpoint> list = setpoints();
+    std::vector<Tally> tallies(opt.threads);
+    std::atomic<uint32_t> next_task{0};
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < opt.threads; t++)
+        workers.emplace_back([&, t] {
+            for (uint32_t task = next_task++; task < TASK_COUNT; task = next_task++)
+                run_task(task, list, opt, tallies[t]);
+        });
+    for (std::thread &worker : workers)
+        worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    /* first example from the lowest numbered thread that saw one */
+    Tally total;
+    for (const Tally &tally : tallies)
+    {
+        total.checked += tally.checked;
+        total.skipped += tally.skipped;
+        for (uint8_t f = 0; f < FIELD_COUNT; f++)
+        {
+            if (total.fields[f].count == 0)
+                total.fields[f].example = tally.fields[f].example;
+            total.fields[f].count += tally.fields[f].count;
+        }
+    }
+
+    std::printf("checked %llu combinations (%llu skipped) on %u threads in %.2f s, %.1f M/s\n",
+                (unsigned long long) total.checked, (unsigned long long) total.skipped, opt.threads, seconds,
+                total.checked / seconds / 1e6);
+
+    for (uint8_t f = 0; f < FIELD_COUNT; f++)
+    {
+        const Mismatch &m = total.fields[f];
+        if (m.count == 0)
+            continue;
+        clean = false;
+        std::printf("%-17s %llu mismatches (%.1f%%), first:\n      %s\n", FIELD_NAMES[f],
+                    (unsigned long long) m.count, 100.0 * m.count / total.checked, m.example.c_str());
+    }
+    if (clean)
+        std::printf("all fields round trip\n");
+    return clean ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+/*
+ * Replay of captured frames into a timeline, shared by scripts/sinclair_corpus.cpp and the
+ * WebAssembly build behind scripts/sinclair_decoder.html, so the golden files and the browser
+ * tool read a capture the same way. Every frame is checked the way verify_packet() does,
+ * classified with the FRAME_KINDS table handle_packet() dispatches on and decoded with the
+ * codec processUnitReport() uses. Lines are fed one at a time, nothing is kept but the last
+ * report and telemetry payloads.
+ */
+#include "../components/sinclair_ac/esppac_codec.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sinclair_timeline {
+
+namespace sinclair_ac = esphome::sinclair_ac;
+namespace CNT = esphome::sinclair_ac::CNT;
+namespace protocol = esphome::sinclair_ac::CNT::protocol;
+namespace codec = esphome::sinclair_ac::CNT::codec;
+
+static const char *const MODE_NAMES[] = {"auto", "cool", "dry", "fan", "heat"};
+static const uint8_t MODE_COUNT = sizeof(MODE_NAMES) / sizeof(MODE_NAMES[0]);
+
+static inline const char *name_or(const char *const *table, uint8_t count, uint8_t index)
+{
+    return index < count ? table[index] : "(unknown)";
+}
+
+static inline std::string hex(const uint8_t *data, size_t len)
+{
+    static const char DIGITS[] = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(len * 2);
+    for (size_t i = 0; i < len; i++)
+    {
+        out += DIGITS[data[i] >> 4];
+        out += DIGITS[data[i] & 0x0F];
+    }
+    return out;
+}
+
+/* The fields processUnitReport() publishes. A SET frame has no fan speed1, so it shows the
+   fields it does carry instead of a fan mode. */
+static inline std::string describe(const uint8_t *payload, bool set)
+{
+    char fan[48];
+    if (set)
+        std::snprintf(fan, sizeof(fan), "speed2=%u%s%s", payload[protocol::REPORT_FAN_SPD2_BYTE] & protocol::REPORT_FAN_SPD2_MASK,
+                      payload[protocol::REPORT_FAN_QUIET_BYTE] & protocol::REPORT_FAN_QUIET_MASK ? " quiet" : "",
+                      payload[protocol::REPORT_FAN_TURBO_BYTE] & protocol::REPORT_FAN_TURBO_MASK ? " turbo" : "");
+    else
+        std::snprintf(fan, sizeof(fan), "%s",
+                      name_or(sinclair_ac::FAN_MODE_OPTIONS, sinclair_ac::FAN_MODE_OPTIONS_COUNT, codec::decode_fan_mode(payload)));
+
+    char room[16] = "";
+    if (!set)
+        std::snprintf(room, sizeof(room), " room=%.0f", codec::decode_room_temperature(payload));
+
+    char text[320];
+    std::snprintf(text, sizeof(text),
+                  "%s %s target=%.1f%s fan=%s v=%s h=%s display=%s/%s %s plasma=%d beeper=%d sleep=%d xfan=%d save=%d",
+                  codec::decode_power(payload) ? "on" : "off", name_or(MODE_NAMES, MODE_COUNT, codec::decode_mode(payload)),
+                  codec::decode_target_temperature(payload), room, fan,
+                  name_or(sinclair_ac::VERTICAL_SWING_OPTIONS, sinclair_ac::VERTICAL_SWING_OPTIONS_COUNT,
+                          codec::decode_vertical_swing(payload)),
+                  name_or(sinclair_ac::HORIZONTAL_SWING_OPTIONS, sinclair_ac::HORIZONTAL_SWING_OPTIONS_COUNT,
+                          codec::decode_horizontal_swing(payload)),
+                  codec::decode_display_on(payload) ? "on" : "off",
+                  name_or(sinclair_ac::DISPLAY_OPTIONS, sinclair_ac::DISPLAY_OPTIONS_COUNT, codec::decode_display_mode(payload)),
+                  codec::decode_display_fahrenheit(payload) ? "F" : "C", codec::decode_plasma(payload),
+                  codec::decode_beeper(payload), codec::decode_sleep(payload), codec::decode_xfan(payload),
+                  codec::decode_save(payload));
+    return text;
+}
+
+/* "[12:34:56.789][I][sinclair_ac:1281]: TX: 7E.7E.2F..." -> direction, bytes and the timestamp */
+static inline bool parse_line(const std::string &line, bool *outgoing, std::vector<uint8_t> *bytes, std::string *stamp)
+{
+    size_t tx = line.find("TX: ");
+    size_t rx = line.find("RX: ");
+    size_t at = std::min(tx, rx);
+    if (at == std::string::npos)
+        return false;
+    *outgoing = at == tx;
+
+    bytes->clear();
+    for (size_t i = at + 4; i + 1 < line.size(); )
+    {
+        if (!std::isxdigit((unsigned char) line[i]) || !std::isxdigit((unsigned char) line[i + 1]))
+            break;
+        bytes->push_back(std::strtoul(line.substr(i, 2).c_str(), nullptr, 16));
+        i += 2;
+        if (i < line.size() && (line[i] == '.' || line[i] == ' '))
+            i++;
+    }
+
+    /* a leading [time] block if there is one */
+    stamp->clear();
+    if (!line.empty() && line[0] == '[')
+    {
+        size_t close = line.find(']');
+        std::string inner = line.substr(1, close - 1);
+        if (close != std::string::npos && !inner.empty() &&
+            inner.find_first_not_of("0123456789:.") == std::string::npos)
+            *stamp = inner;
+    }
+    return !bytes->empty();
+}
+
+/*
+ * A line whenever the decoded report changes, every SET frame that carries an update, every
+ * telemetry payload change, every frame the component would drop, and totals at the end. With
+ * every_frame set, repeated reports and telemetry and SETs without an update are listed too.
+ * Lines carry the log timestamp, or the line number when there is none.
+ */
+class Timeline {
+    public:
+        explicit Timeline(bool every_frame = false) : every_frame_(every_frame) {}
+
+        /* One log line, anything but a TX:/RX: line is skipped. Output is appended to out. */
+        void line(const std::string &text, std::string &out)
+        {
+            next_line();
+            if (parse_line(text, &this->outgoing_, &this->bytes_, &this->stamp_))
+                frame(this->outgoing_, this->bytes_.data(), this->bytes_.size(), this->stamp_, out);
+        }
+
+        /* A frame found some other way, stamp may be empty */
+        void frame(bool outgoing, const uint8_t *frame, size_t len, const std::string &stamp, std::string &out)
+        {
+            this->frames_++;
+            const std::string when = stamp.empty() ? "line " + std::to_string(this->line_number_) : stamp;
+            const char *dir = outgoing ? "TX" : "RX";
+
+            /* same checks as read_data() and verify_packet() */
+            if (len < protocol::FRAME_OVERHEAD || frame[0] != protocol::SYNC || frame[1] != protocol::SYNC ||
+                frame[2] + 3u != len)
+            {
+                this->bad_++;
+                out += when + ' ' + dir + " bad length " + hex(frame, len) + '\n';
+                return;
+            }
+            if (protocol::frame_checksum(frame, len) != frame[len - 1])
+            {
+                this->bad_++;
+                out += when + ' ' + dir + " bad checksum " + hex(frame, len) + '\n';
+                return;
+            }
+
+            uint8_t command = frame[3];
+            const uint8_t *payload = frame + protocol::FRAME_HEADER_LEN;
+            size_t payload_len = len - protocol::FRAME_OVERHEAD;
+
+            if (outgoing)
+            {
+                if (command != protocol::CMD_OUT_PARAMS_SET || payload_len != protocol::SET_PACKET_LEN)
+                {
+                    out += when + " TX " + hex(&command, 1) + ' ' + hex(payload, payload_len) + '\n';
+                    return;
+                }
+                this->sets_++;
+                bool af = payload[protocol::SET_AF_BYTE] == protocol::SET_AF_VAL;
+                bool update = af || !(payload[protocol::SET_NOCHANGE_BYTE] & protocol::SET_NOCHANGE_MASK);
+                if (!update)
+                {
+                    if (this->every_frame_)
+                        out += when + " TX poll " + describe(payload, true) + '\n';
+                    return;
+                }
+                this->updates_++;
+                out += when + " TX set" + (af ? " AF " : " ") + describe(payload, true) + '\n';
+                return;
+            }
+
+            switch (CNT::FRAME_KINDS.kind[command])
+            {
+                case CNT::FRAME_UNIT_REPORT:
+                {
+                    if (payload_len < protocol::SET_PACKET_LEN)
+                    {
+                        this->bad_++;
+                        out += when + " RX short report " + hex(payload, payload_len) + '\n';
+                        break;
+                    }
+                    this->reports_++;
+                    std::string state = describe(payload, false);
+                    if (this->every_frame_ || state != this->last_report_)
+                        out += when + " RX report " + state + '\n';
+                    this->last_report_ = std::move(state);
+                    break;
+                }
+                case CNT::FRAME_TELEMETRY:
+                {
+                    this->telemetry_++;
+                    std::string data = hex(payload, payload_len);
+                    std::string &last = this->last_telemetry_[command];
+                    if (this->every_frame_ || data != last)
+                        out += when + " RX telemetry " + hex(&command, 1) + ' ' + data + '\n';
+                    last = std::move(data);
+                    break;
+                }
+                default:
+                    this->dropped_++;
+                    out += when + " RX dropped " + hex(&command, 1) + ' ' + hex(payload, payload_len) + '\n';
+                    break;
+            }
+        }
+
+        void totals(std::string &out) const
+        {
+            out += "frames=" + std::to_string(this->frames_) + " reports=" + std::to_string(this->reports_) +
+                   " sets=" + std::to_string(this->sets_) + " updates=" + std::to_string(this->updates_) +
+                   " telemetry=" + std::to_string(this->telemetry_) + " dropped=" + std::to_string(this->dropped_) +
+                   " bad=" + std::to_string(this->bad_) + '\n';
+        }
+
+        /* A line handled elsewhere, for the "line N" stamps */
+        void next_line() { this->line_number_++; }
+
+    protected:
+        bool every_frame_;
+        uint32_t line_number_ = 0;
+        uint32_t frames_ = 0, reports_ = 0, sets_ = 0, updates_ = 0, telemetry_ = 0, dropped_ = 0, bad_ = 0;
+        std::string last_report_;
+        std::map<uint8_t, std::string> last_telemetry_;
+
+        /* scratch for line(), kept to not allocate per line */
+        bool outgoing_ = false;
+        std::vector<uint8_t> bytes_;
+        std::string stamp_;
+};
+
+}  // namespace sinclair_timeline